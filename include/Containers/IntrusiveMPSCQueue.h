@@ -0,0 +1,80 @@
+/*******************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+--------------------------------------------------------------------
+@file  IntrusiveMPSCQueue.h
+@brief Lock-free queue of items linked by their own pointer
+@author minseob (https://github.com/rasidin)
+********************************************************************/
+#ifndef _LE_INTRUSIVEMPSCQUEUE_H_
+#define _LE_INTRUSIVEMPSCQUEUE_H_
+
+#include <atomic>
+
+#include "Core/Common.h"
+
+namespace LimitEngine
+{
+// Multi-producer / single-consumer queue without locks or allocation.
+// Items are linked through NextMember, so an item can be in one queue at a time.
+// Producers push with one CAS on the head; the consumer takes every item at once (PopAll)
+// and gets them in order of Push. Taking the whole list at once leaves no ABA problem.
+template <typename T, T* T::*NextMember>
+class IntrusiveMPSCQueue
+{
+public:
+    IntrusiveMPSCQueue() : mHead(nullptr) {}
+    IntrusiveMPSCQueue(const IntrusiveMPSCQueue&) = delete;
+    IntrusiveMPSCQueue& operator=(const IntrusiveMPSCQueue&) = delete;
+
+    // Any thread. Returns true if the queue was empty.
+    bool Push(T *Item)
+    {
+        T *head = mHead.load(std::memory_order_relaxed);
+        do {
+            Item->*NextMember = head;
+        } while (!mHead.compare_exchange_weak(head, Item, std::memory_order_release, std::memory_order_relaxed));
+        return head == nullptr;
+    }
+
+    // Consumer thread. Takes all items pushed until now, first pushed item first (linked by NextMember, last is null).
+    T* PopAll()
+    {
+        T *item = mHead.exchange(nullptr, std::memory_order_acquire);
+        T *first = nullptr;
+        while (item) {
+            T *next = item->*NextMember;
+            item->*NextMember = first;
+            first = item;
+            item = next;
+        }
+        return first;
+    }
+
+    bool IsEmpty() const { return mHead.load(std::memory_order_relaxed) == nullptr; }
+
+private:
+    std::atomic<T*> mHead;      // Last pushed item
+};
+}
+
+#endif // _LE_INTRUSIVEMPSCQUEUE_H_
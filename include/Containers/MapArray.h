@@ -28,6 +28,11 @@ OTHER DEALINGS IN THE SOFTWARE.
 #ifndef _LE_MAPARRAY_H_
 #define _LE_MAPARRAY_H_
 
+#include <new>
+
+#include "Core/Common.h"
+#include "Core/Hash.h"
+#include "Core/Object.h"
 #include "Containers/Pair.h"
 #include "Containers/VectorArray.h"
 
@@ -75,20 +80,31 @@ private:
     MapT&  mOwnerMapArray;
     uint32 mCurrentIndex;
 };
-template<typename T1, typename T2> class MapArray : public Object<LimitEngineMemoryCategory::Common>
+// Items are stored inline in insertion order (GetAt / iteration), and looked up through
+// an open addressing index table (linear probing, power of two capacity).
+// Adding an existing key overwrites its value.
+template<typename T1, typename T2, typename HashT = HashTraits<T1>> class MapArray : public Object<LimitEngineMemoryCategory::Common>
 {
+    static constexpr uint32 MinItemReserved = 4u;
+    static constexpr uint32 MinIndexCapacity = 8u;
+
+    struct INDEXSLOT
+    {
+        uint32 hash;            // Folded hash of key
+        uint32 itemIndex;       // Index of item + 1 (0 : empty)
+    };
+
 public:
     typedef Pair<T1, T2> MapArrayItem;
 
 public:
-    MapArray()              {}
+    MapArray()
+        : mItems(nullptr), mSize(0u), mReserved(0u), mIndexSlots(nullptr), mIndexCapacity(0u)
+    {}
     MapArray(const MapArray &map)
+        : mItems(nullptr), mSize(0u), mReserved(0u), mIndexSlots(nullptr), mIndexCapacity(0u)
     {
-        mData.Resize(map.mData.count());
-        for(uint32 dtidx=0;dtidx<mData.count();dtidx++) {
-            mData[dtidx] = new Pair<T1, T2>();
-            *mData[dtidx] = *map.mData[dtidx];
-        }
+        copyFrom(map);
     }
     virtual ~MapArray()
     {
@@ -96,87 +112,144 @@ public:
     }
     void Clear()
     {
-        for(uint32 i=0;i<mData.GetSize();i++)
-        {
-            delete mData[i];
+        for (uint32 i = 0; i < mSize; i++) {
+            mItems[i].~MapArrayItem();
         }
-        mData.Clear();
+        if (mItems) free(mItems);
+        if (mIndexSlots) free(mIndexSlots);
+        mItems = nullptr;
+        mSize = 0u;
+        mReserved = 0u;
+        mIndexSlots = nullptr;
+        mIndexCapacity = 0u;
     }
     void Add(const T1 &key, const T2 &value)
     {
-        mData.Add(new MapArrayItem(key, value));
+        const uint32 hash = getHash(key);
+        if (const INDEXSLOT *slot = findSlot(key, hash)) {
+            mItems[slot->itemIndex - 1u].value = value;
+            return;
+        }
+        insertItem(key, value, hash);
     }
-    size_t GetSize() const      { return mData.GetSize(); }
-    size_t size() const         { return mData.size(); }
+    size_t GetSize() const      { return mSize; }
+    size_t size() const         { return mSize; }
     int FindIndex(const T1 &key) const
     {
-        for(uint32 i=0;i<mData.GetSize();i++)
-        {
-            MapArrayItem *d = mData[i];
-            if (key == d->key) return static_cast<int>(i);
-        }
-        return -1;
+        const INDEXSLOT *slot = findSlot(key, getHash(key));
+        return slot ? static_cast<int>(slot->itemIndex - 1u) : -1;
     }
     T2* Find(const T1& key)
     {
-        for (uint32 i = 0; i < mData.GetSize(); i++)
-        {
-            MapArrayItem* d = mData[i];
-            if (d->key == key) return &d->value;
-        }
-        return nullptr;
+        const INDEXSLOT *slot = findSlot(key, getHash(key));
+        return slot ? &mItems[slot->itemIndex - 1u].value : nullptr;
     }
     T2& FindOrCreate(const T1 &key, T2 defValue)
     {
-        for (uint32 i = 0; i<mData.GetSize(); i++)
-        {
-            MapArrayItem *d = mData[i];
-            if (d->key == key) return d->value;
-        }
-        MapArrayItem *newPair = new Pair<T1, T2>();
-        newPair->key = key;
-        newPair->value = defValue;
-        mData.Add(newPair);
-        return newPair->value;
+        const uint32 hash = getHash(key);
+        if (const INDEXSLOT *slot = findSlot(key, hash))
+            return mItems[slot->itemIndex - 1u].value;
+        return insertItem(key, defValue, hash).value;
     }
-    Pair<T1, T2>& GetAt(uint32 index) const { return *mData[index]; }
+    Pair<T1, T2>& GetAt(uint32 index) const { return mItems[index]; }
     T2& operator [] (const T1 &key)
     {
-        for (uint32 i=0;i<mData.GetSize();i++)
-        {
-            MapArrayItem *d = mData[i];
-            if (d->key == key) return d->value;
-        }
-        MapArrayItem *newPair = new Pair<T1, T2>();
-        newPair->key = key;
-        mData.Add(newPair);
-        return newPair->value;
+        const uint32 hash = getHash(key);
+        if (const INDEXSLOT *slot = findSlot(key, hash))
+            return mItems[slot->itemIndex - 1u].value;
+        return insertItem(key, T2(), hash).value;
     }
     const T2& operator [] (const T1 &key) const
     {
-        for (uint32 i=0;i<mData.GetSize();i++)
-        {
-            MapArrayItem *d = mData[i];
-            if (d->key == key) return d->value;
-        }
+        if (const INDEXSLOT *slot = findSlot(key, getHash(key)))
+            return mItems[slot->itemIndex - 1u].value;
         LEASSERT(false);
-        return mData[0]->value;
+        return mItems[0].value;
     }
-    void operator=(const MapArray<T1, T2> &map)
+    void operator=(const MapArray &map)
     {
-        mData.Resize(map.mData.count());
-        for(uint32 dtidx=0;dtidx<mData.count();dtidx++) {
-            mData[dtidx] = new MapArrayItem();
-            *mData[dtidx] = *map.mData[dtidx];
-        }
+        if (this == &map) return;
+        Clear();
+        copyFrom(map);
     }
 
-    typedef MapArrayIterator<MapArray<T1, T2>, T1, T2> Iterator;
+    typedef MapArrayIterator<MapArray<T1, T2, HashT>, T1, T2> Iterator;
     Iterator begin() { return Iterator(*this); }
-    Iterator end() { return Iterator(*this, mData.size()); }
+    Iterator end() { return Iterator(*this, mSize); }
+
+private:
+    static uint32 getHash(const T1 &key)
+    {
+        const uint64 hash = HashT::GetHash(key);
+        return static_cast<uint32>(hash ^ (hash >> 32));
+    }
+    const INDEXSLOT* findSlot(const T1 &key, uint32 hash) const
+    {
+        if (mSize == 0u)
+            return nullptr;
+        const uint32 mask = mIndexCapacity - 1u;
+        for (uint32 slotIndex = hash & mask; ; slotIndex = (slotIndex + 1u) & mask) {
+            const INDEXSLOT &slot = mIndexSlots[slotIndex];
+            if (slot.itemIndex == 0u)
+                return nullptr;
+            if (slot.hash == hash && mItems[slot.itemIndex - 1u].key == key)
+                return &slot;
+        }
+    }
+    void placeSlot(uint32 hash, uint32 itemIndex)
+    {
+        const uint32 mask = mIndexCapacity - 1u;
+        uint32 slotIndex = hash & mask;
+        while (mIndexSlots[slotIndex].itemIndex)
+            slotIndex = (slotIndex + 1u) & mask;
+        mIndexSlots[slotIndex].hash = hash;
+        mIndexSlots[slotIndex].itemIndex = itemIndex + 1u;
+    }
+    MapArrayItem& insertItem(const T1 &key, const T2 &value, uint32 hash)
+    {
+        // Keep load factor of index table under 3/4
+        if ((mSize + 1u) * 4u > mIndexCapacity * 3u)
+            growIndexSlots(mIndexCapacity ? mIndexCapacity * 2u : MinIndexCapacity);
+        if (mSize == mReserved)
+            growItems(mReserved ? mReserved * 2u : MinItemReserved);
+        new (&mItems[mSize]) MapArrayItem(key, value);
+        placeSlot(hash, mSize);
+        return mItems[mSize++];
+    }
+    void growItems(uint32 reserved)
+    {
+        MapArrayItem *newItems = static_cast<MapArrayItem*>(malloc(sizeof(MapArrayItem) * reserved));
+        for (uint32 i = 0; i < mSize; i++) {
+            new (&newItems[i]) MapArrayItem(mItems[i]);
+            mItems[i].~MapArrayItem();
+        }
+        if (mItems) free(mItems);
+        mItems = newItems;
+        mReserved = reserved;
+    }
+    void growIndexSlots(uint32 capacity)
+    {
+        if (mIndexSlots) free(mIndexSlots);
+        mIndexSlots = static_cast<INDEXSLOT*>(malloc(sizeof(INDEXSLOT) * capacity));
+        ::memset(mIndexSlots, 0, sizeof(INDEXSLOT) * capacity);
+        mIndexCapacity = capacity;
+        for (uint32 i = 0; i < mSize; i++) {
+            placeSlot(getHash(mItems[i].key), i);
+        }
+    }
+    void copyFrom(const MapArray &map)
+    {
+        for (uint32 i = 0; i < map.mSize; i++) {
+            Add(map.mItems[i].key, map.mItems[i].value);
+        }
+    }
 
 protected:
-    VectorArray<Pair<T1, T2>*>   mData;
+    MapArrayItem   *mItems;             // Items (insertion order)
+    uint32          mSize;              // Count of items
+    uint32          mReserved;          // Reserved count of items
+    INDEXSLOT      *mIndexSlots;        // Index table
+    uint32          mIndexCapacity;     // Size of index table (power of two)
 };
 }
 
@@ -43,11 +43,6 @@ namespace LimitEngine {
             key = v.key;
             value = v.value;
         }
-		~Pair()
-		{
-			key.~K();
-			value.~V();
-		}
         K key;
         V value;
     };
@@ -0,0 +1,86 @@
+/*******************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+--------------------------------------------------------------------
+@file  SmallVectorArray.h
+@brief Vector array with inline storage
+@author minseob (https://github.com/rasidin)
+********************************************************************/
+#ifndef _LE_SMALLVECTORARRAY_H_
+#define _LE_SMALLVECTORARRAY_H_
+
+#include "Containers/VectorArray.h"
+
+namespace LimitEngine
+{
+// VectorArray keeping up to N elements inside of itself (no heap allocation).
+// Spills to AllocatorT when it grows beyond N, and returns to inline storage on Clear().
+template <typename T, uint32 N, typename AllocatorT = ContainerAllocator<LimitEngineMemoryCategory::Common>>
+class SmallVectorArray : public VectorArray<T, AllocatorT>
+{
+    typedef VectorArray<T, AllocatorT> BaseType;
+    static_assert(N > 0, "SmallVectorArray needs inline storage");
+public:
+    SmallVectorArray() : BaseType(reinterpret_cast<T*>(mInlineData), N)   {}
+    SmallVectorArray(const SmallVectorArray &v) : BaseType(reinterpret_cast<T*>(mInlineData), N)
+    {   // Copy
+        BaseType::Append(v.GetData(), v.size());
+    }
+    SmallVectorArray(SmallVectorArray &&v) : BaseType(reinterpret_cast<T*>(mInlineData), N)
+    {   // Move
+        BaseType::operator=(Move(v));
+    }
+    ~SmallVectorArray()
+    {
+        // Elements in inline storage are destroyed before it goes away
+        BaseType::Clear();
+    }
+
+    void Clear(bool FreeReservedData = true)
+    {
+        BaseType::Clear(FreeReservedData);
+        if (BaseType::GetData() == nullptr)
+            BaseType::useInlineStorage(getInlineData(), N);
+    }
+
+    SmallVectorArray& operator=(const SmallVectorArray &t)
+    {
+        BaseType::operator=(t);
+        return *this;
+    }
+    SmallVectorArray& operator=(SmallVectorArray &&t)
+    {
+        if (this != &t) {
+            Clear();
+            BaseType::operator=(Move(t));
+        }
+        return *this;
+    }
+
+private:
+    T* getInlineData() { return reinterpret_cast<T*>(mInlineData); }
+
+    alignas(T) uint8 mInlineData[sizeof(T) * N];    // Storage for first N elements
+};
+}
+
+#endif
@@ -0,0 +1,261 @@
+/*******************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+--------------------------------------------------------------------
+@file  Sort.h
+@brief Sort algorithms over ranges of elements
+@author minseob (https://github.com/rasidin)
+********************************************************************/
+#ifndef _LE_SORT_H_
+#define _LE_SORT_H_
+
+#include <new>
+#include <string.h>
+#include <type_traits>
+
+#include "Core/Common.h"
+#include "Core/Util.h"
+
+namespace LimitEngine {
+// Algorithms work on [first, last) with comparator Comp(a, b) returning true if a goes before b.
+// Comp must be a strict weak ordering (use '<', not '<=').
+class SortAlgorithm
+{
+public:
+    static constexpr ptrdiff_t InsertionSortThreshold = 16;     // Ranges this small are finished by insertion sort
+    static constexpr uint32 RadixDigitBits = 8u;                  // RadixSort sorts by 8bit digits of 64bit key
+    static constexpr uint32 RadixDigitCount = 64u / RadixDigitBits;
+    static constexpr uint32 RadixBucketCount = 1u << RadixDigitBits;
+
+    // Introsort (quicksort with median of three, heapsort when recursion gets too deep). Not stable.
+    template<typename T, typename Compare>
+    static void Sort(T *first, T *last, Compare &Comp)
+    {
+        if (last - first < 2)
+            return;
+        uint32 depthLimit = 0u;
+        for (ptrdiff_t n = last - first; n > 1; n >>= 1)
+            depthLimit += 2u;
+        introSort(first, last, Comp, depthLimit);
+        InsertionSort(first, last, Comp);
+    }
+
+    // Bottom-up merge sort. Buffer is uninitialized memory for (last - first) elements.
+    template<typename T, typename Compare>
+    static void StableSort(T *first, T *last, T *buffer, Compare &Comp)
+    {
+        const ptrdiff_t count = last - first;
+        for (ptrdiff_t runBegin = 0; runBegin < count; runBegin += InsertionSortThreshold) {
+            const ptrdiff_t runEnd = runBegin + InsertionSortThreshold;
+            InsertionSort(first + runBegin, first + (runEnd < count ? runEnd : count), Comp);
+        }
+        for (ptrdiff_t width = InsertionSortThreshold; width < count; width *= 2) {
+            for (ptrdiff_t runBegin = 0; runBegin + width < count; runBegin += width * 2) {
+                const ptrdiff_t runEnd = runBegin + width * 2;
+                MergeSortedRuns(first + runBegin, first + runBegin + width, first + (runEnd < count ? runEnd : count), buffer, Comp);
+            }
+        }
+    }
+
+    // Merge sorted [first, mid) and [mid, last) in place (stable).
+    // Buffer is uninitialized memory for (mid - first) elements.
+    template<typename T, typename Compare>
+    static void MergeSortedRuns(T *first, T *mid, T *last, T *buffer, Compare &Comp)
+    {
+        if (first == mid || mid == last || !Comp(*mid, *(mid - 1)))
+            return;     // Already in order
+        const ptrdiff_t leftCount = mid - first;
+        for (ptrdiff_t i = 0; i < leftCount; i++)
+            ::new (&buffer[i]) T(Move(first[i]));
+        T *left = buffer;
+        T *leftEnd = buffer + leftCount;
+        T *right = mid;
+        T *out = first;
+        // Output never overtakes right because left elements are kept in buffer
+        while (left < leftEnd && right < last) {
+            if (Comp(*right, *left))
+                *out++ = Move(*right++);
+            else
+                *out++ = Move(*left++);
+        }
+        while (left < leftEnd)
+            *out++ = Move(*left++);
+        for (ptrdiff_t i = 0; i < leftCount; i++)
+            buffer[i].~T();
+    }
+
+    template<typename T, typename Compare>
+    static void InsertionSort(T *first, T *last, Compare &Comp)
+    {
+        if (last - first < 2)
+            return;
+        for (T *current = first + 1; current < last; current++) {
+            if (!Comp(*current, *(current - 1)))
+                continue;
+            T value(Move(*current));
+            T *hole = current;
+            do {
+                *hole = Move(*(hole - 1));
+                --hole;
+            } while (hole > first && Comp(value, *(hole - 1)));
+            *hole = Move(value);
+        }
+    }
+
+    template<typename T, typename Compare>
+    static void HeapSort(T *first, T *last, Compare &Comp)
+    {
+        const ptrdiff_t count = last - first;
+        for (ptrdiff_t parent = count / 2 - 1; parent >= 0; parent--)
+            siftDown(first, parent, count, Comp);
+        for (ptrdiff_t heapCount = count - 1; heapCount > 0; heapCount--) {
+            swapElements(first[0], first[heapCount]);
+            siftDown(first, 0, heapCount, Comp);
+        }
+    }
+
+    // LSD radix sort by 64bit key, GetKey(const T&) returns uint64. Stable.
+    // Buffer is memory for (last - first) elements. Digits same for all elements are skipped.
+    template<typename T, typename KeyFunc>
+    static void RadixSort(T *first, T *last, T *buffer, KeyFunc &GetKey)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "RadixSort copies elements by memcpy");
+        const ptrdiff_t count = last - first;
+        if (count < 2)
+            return;
+        uint32 histograms[RadixDigitCount][RadixBucketCount];
+        ::memset(histograms, 0, sizeof(histograms));
+        for (const T *element = first; element < last; element++) {
+            const uint64 key = GetKey(*element);
+            for (uint32 digit = 0u; digit < RadixDigitCount; digit++)
+                histograms[digit][GetRadixBucket(key, digit)]++;
+        }
+        T *source = first;
+        T *destination = buffer;
+        for (uint32 digit = 0u; digit < RadixDigitCount; digit++) {
+            uint32 *offsets = histograms[digit];
+            if (offsets[GetRadixBucket(GetKey(*source), digit)] == static_cast<uint32>(count))
+                continue;
+            uint32 offset = 0u;
+            for (uint32 bucket = 0u; bucket < RadixBucketCount; bucket++) {
+                const uint32 bucketCount = offsets[bucket];
+                offsets[bucket] = offset;
+                offset += bucketCount;
+            }
+            for (ptrdiff_t index = 0; index < count; index++)
+                destination[offsets[GetRadixBucket(GetKey(source[index]), digit)]++] = source[index];
+            T *swapped = source;
+            source = destination;
+            destination = swapped;
+        }
+        if (source != first)
+            ::memcpy(first, source, sizeof(T) * count);
+    }
+
+    static inline uint32 GetRadixBucket(uint64 Key, uint32 Digit)
+    {
+        return static_cast<uint32>(Key >> (Digit * RadixDigitBits)) & (RadixBucketCount - 1u);
+    }
+
+private:
+    template<typename T>
+    static void swapElements(T &a, T &b)
+    {
+        T temp(Move(a));
+        a = Move(b);
+        b = Move(temp);
+    }
+
+    // Leaves ranges under InsertionSortThreshold unsorted for final insertion sort pass
+    template<typename T, typename Compare>
+    static void introSort(T *first, T *last, Compare &Comp, uint32 depthLimit)
+    {
+        while (last - first > InsertionSortThreshold) {
+            if (depthLimit == 0u) {
+                HeapSort(first, last, Comp);
+                return;
+            }
+            depthLimit--;
+
+            // Median of three becomes pivot at first, and guards both scans of partition
+            moveMedianToFirst(first, first + 1, first + (last - first) / 2, last - 1, Comp);
+            T *cut = partition(first + 1, last, *first, Comp);
+
+            // Recurse into smaller side, loop on larger one
+            if (cut - first < last - cut) {
+                introSort(first, cut, Comp, depthLimit);
+                first = cut;
+            }
+            else {
+                introSort(cut, last, Comp, depthLimit);
+                last = cut;
+            }
+        }
+    }
+
+    template<typename T, typename Compare>
+    static void moveMedianToFirst(T *result, T *a, T *b, T *c, Compare &Comp)
+    {
+        if (Comp(*a, *b)) {
+            if (Comp(*b, *c))       swapElements(*result, *b);
+            else if (Comp(*a, *c))  swapElements(*result, *c);
+            else                    swapElements(*result, *a);
+        }
+        else if (Comp(*a, *c))      swapElements(*result, *a);
+        else if (Comp(*b, *c))      swapElements(*result, *c);
+        else                        swapElements(*result, *b);
+    }
+
+    template<typename T, typename Compare>
+    static T* partition(T *first, T *last, const T &pivot, Compare &Comp)
+    {
+        for (;;) {
+            while (Comp(*first, pivot))
+                ++first;
+            --last;
+            while (Comp(pivot, *last))
+                --last;
+            if (!(first < last))
+                return first;
+            swapElements(*first, *last);
+            ++first;
+        }
+    }
+
+    template<typename T, typename Compare>
+    static void siftDown(T *heap, ptrdiff_t index, ptrdiff_t count, Compare &Comp)
+    {
+        T value(Move(heap[index]));
+        for (ptrdiff_t child = index * 2 + 1; child < count; child = index * 2 + 1) {
+            if (child + 1 < count && Comp(heap[child], heap[child + 1]))
+                child++;
+            if (!Comp(value, heap[child]))
+                break;
+            heap[index] = Move(heap[child]);
+            index = child;
+        }
+        heap[index] = Move(value);
+    }
+};
+}
+
+#endif
@@ -28,11 +28,14 @@ OTHER DEALINGS IN THE SOFTWARE.
 #ifndef _LE_VECTORARRAY_H_
 #define _LE_VECTORARRAY_H_
 
-#include <functional>
 #include <memory.h>
+#include <new>
+#include <type_traits>
 #include "Core/Object.h"
 #include "Core/Common.h"
+#include "Core/Util.h"
 #include "Core/SerializableResource.h"
+#include "Containers/Sort.h"
 
 namespace LimitEngine
 {
@@ -51,7 +54,7 @@ public:
 	}
 	VectorArrayIterator operator++(int)
 	{
-        VectorArrayInterator result(*this);
+        VectorArrayIterator result(*this);
 		++mCurrentIndex;
 		return result;
 	}
@@ -79,110 +82,168 @@ private:
     ArrayT& mOwnerArray;            // Onwer VectorArray
 	uint32  mCurrentIndex;		    // Index of VectorArray
 };
-template <typename T> class VectorArray : public Object<LimitEngineMemoryCategory::Common>, public SerializableResource
+// Elements are constructed in place and relocated by move (memcpy for IsTriviallyRelocatable types).
+// Storage grows geometrically and comes from AllocatorT (static Alloc / Free).
+template <typename T, typename AllocatorT = ContainerAllocator<LimitEngineMemoryCategory::Common>>
+class VectorArray : public Object<LimitEngineMemoryCategory::Common>, public SerializableResource
 {
 #define VECTORARRAY_INIT          mSize(0)\
-                                , mData(0)\
-                                , mReserved(0)
+                                , mReserved(0)\
+                                , mInlineStorage(0)\
+                                , mData(0)
+    static constexpr uint32 MinReserved = 4u;
 public:
     VectorArray() : VECTORARRAY_INIT                {}
-    VectorArray(uint32 s) : VECTORARRAY_INIT        {}
+    VectorArray(uint32 s) : VECTORARRAY_INIT        { Reserve(s); }
     VectorArray(const VectorArray &v) : VECTORARRAY_INIT
     {   // Copy
-        Resize(v.size());
-        for(uint32 dtidx=0;dtidx<v.size();dtidx++)
-            mData[dtidx] = v[dtidx];
+        Append(v.GetData(), v.size());
+    }
+    VectorArray(VectorArray &&v) : VECTORARRAY_INIT
+    {   // Move
+        moveFrom(v);
     }
     ~VectorArray()
     {
-        if (mData) 
-        {
-            for (uint32 i=0;i< mSize;i++) mData[i].~T();
-            free(mData);
-        }
-        mSize = 0;
-        mData = NULL;
+        Clear();
     }
 
     inline uint32 GetSize()    const                { return mSize; }
+    inline uint32 GetReserved() const               { return mReserved; }
     inline T& GetStart()                            { return *(mData); }
     inline T& GetLast()                             { return *(mData + mSize - 1); }
     
     inline void Reserve(uint32 n)
     {
-        if (mSize >= n)
-        {
-            mReserved = n;
-        }
-        else
-        {
-            T *newData = (T*)malloc(sizeof(T) * n);
-            memset(newData, 0, sizeof(T) * n);
-            if (mSize > 0)
-                memcpy(newData, mData, sizeof(T) * mSize);
-            free(mData);
-            mData = newData;
-            mReserved = n;
-        }
+        if (n > mReserved)
+            reallocate(n);
     }
 
     inline void Resize(uint32 n)
     {
-        if (n <= mReserved)
-        {
-            mSize = n;
-            return;
-        }
-
-        mReserved = n * 2;
-        T *newData = (T*)malloc(sizeof(T) * mReserved);
-        memset(newData, 0, sizeof(T) * mReserved);
-        if (mReserved <= mSize)
-            memcpy(newData, mData, sizeof(T) * mReserved);
-        else
-            memcpy(newData, mData, sizeof(T) * mSize);
+        if (n > mReserved)
+            reallocate(getGrownReserved(n));
+        for (uint32 i = mSize; i < n; i++)
+            ::new (&mData[i]) T();
+        for (uint32 i = n; i < mSize; i++)
+            mData[i].~T();
         mSize = n;
-        if (mData) free(mData);
-        mData = newData;
     }
 
-    inline T& Add() {
-        Resize(GetSize()+1);
-        return mData[GetSize()-1];
+    template<typename... Args>
+    inline T& EmplaceBack(Args&&... args)
+    {
+        if (mSize == mReserved) {
+            // Construct new element before old storage is released (args can refer to elements)
+            const uint32 newReserved = getGrownReserved(mSize + 1);
+            T *newData = allocate(newReserved);
+            ::new (&newData[mSize]) T(Forward<Args>(args)...);
+            relocate(newData, mData, mSize);
+            freeStorage();
+            mData = newData;
+            mReserved = newReserved;
+        }
+        else {
+            ::new (&mData[mSize]) T(Forward<Args>(args)...);
+        }
+        return mData[mSize++];
+    }
+
+    template<typename... Args>
+    inline T& Emplace(uint32 n, Args&&... args)
+    {
+        LEASSERT(n <= mSize);
+        if (n == mSize)
+            return EmplaceBack(Forward<Args>(args)...);
+        T value(Forward<Args>(args)...);
+        if (mSize == mReserved)
+            reallocate(getGrownReserved(mSize + 1));
+        if (IsTriviallyRelocatable<T>::Value) {
+            ::memmove(static_cast<void*>(&mData[n + 1]), &mData[n], sizeof(T) * (mSize - n));
+            ::new (&mData[n]) T(Move(value));
+        }
+        else {
+            ::new (&mData[mSize]) T(Move(mData[mSize - 1]));
+            for (uint32 i = mSize - 1; i > n; i--)
+                mData[i] = Move(mData[i - 1]);
+            mData[n] = Move(value);
+        }
+        mSize++;
+        return mData[n];
     }
 
-    inline void Add(const T& d)
+    inline T& Add()                                 { return EmplaceBack(); }
+    inline void Add(const T& d)                     { EmplaceBack(d); }
+    inline void Add(T&& d)                          { EmplaceBack(Move(d)); }
+
+    // Copy count elements from data to the end
+    inline void Append(const T *data, uint32 count)
     {
-        Resize(GetSize()+1);
-        LEASSERT(mData);
-        mData[GetSize()-1] = d;
+        if (count == 0)
+            return;
+        if (mSize + count > mReserved) {
+            const bool isOwnData = data >= mData && data < mData + mSize;
+            const T *oldData = mData;
+            reallocate(getGrownReserved(mSize + count));
+            if (isOwnData)
+                data = mData + (data - oldData);
+        }
+        if (std::is_trivially_copyable<T>::value) {
+            ::memcpy(static_cast<void*>(&mData[mSize]), data, sizeof(T) * count);
+        }
+        else {
+            for (uint32 i = 0; i < count; i++)
+                ::new (&mData[mSize + i]) T(data[i]);
+        }
+        mSize += count;
     }
 
+    // Keep order of remaining elements
     inline void Delete(uint32 n)
     {
-        LEASSERT(mSize);
-        if (!mSize) return;
-        mData[n].~T();
-        --mSize;
-        if (mReserved < mSize)
-        {
-            mReserved = mSize;
+        LEASSERT(n < mSize);
+        if (n >= mSize) return;
+        if (IsTriviallyRelocatable<T>::Value) {
+            mData[n].~T();
+            ::memmove(static_cast<void*>(&mData[n]), &mData[n + 1], sizeof(T) * (mSize - n - 1));
         }
-        for(uint32 i=n;i<mSize;i++)
-        {
-            memcpy(&mData[i], &mData[i+1], sizeof(T));
+        else {
+            for (uint32 i = n; i + 1 < mSize; i++)
+                mData[i] = Move(mData[i + 1]);
+            mData[mSize - 1].~T();
         }
+        --mSize;
+    }
+
+    // Move last element into deleted place (order is not kept)
+    inline void RemoveSwap(uint32 n)
+    {
+        LEASSERT(n < mSize);
+        if (n >= mSize) return;
+        if (n + 1 < mSize)
+            mData[n] = Move(mData[mSize - 1]);
+        mData[mSize - 1].~T();
+        --mSize;
     }
 
     T PopFront()
     {
         if (mSize == 0)
             return T();
-        T output = mData[0];
+        T output(Move(mData[0]));
         Delete(0);
         return output;
     }
 
+    T PopBack()
+    {
+        if (mSize == 0)
+            return T();
+        T output(Move(mData[mSize - 1]));
+        mData[--mSize].~T();
+        return output;
+    }
+
     int32 IndexOf(const T &t)
     {
         for (int32 i = 0; i < static_cast<int32>(mSize); i++) {
@@ -194,30 +255,22 @@ public:
 
     inline T* GetData() const { return mData; }
 
-    inline void Sort(std::function<bool(const T &t1, const T &t2)> func)
+    // Comp(t1, t2) returns true if t1 goes before t2 (strict weak ordering, e.g. '<')
+    // Introsort, order of equal elements is not kept
+    template<typename Compare>
+    inline void Sort(Compare Comp)
     {
-        if(mData == NULL || mSize == 0) return;
-
-        T *newData = (T*)malloc(sizeof(T) * mSize);
-        ::memset(newData, 0, sizeof(T) * mSize);
-        newData[0] = mData[0];
-        uint32 newDataSize = 1;
-        T *prevData = &newData[0];
-        for(uint32 idx=1;idx< mSize;idx++, newDataSize++) {
-            uint32 nidx=0;
-            for(;nidx<newDataSize;nidx++) {
-                if(func(newData[nidx], mData[idx]) == false) {
-                    for(uint32 nnidx=newDataSize;nnidx>nidx;nnidx--) {
-                        newData[nnidx] = newData[nnidx-1];
-                    }
-                    break;
-                }
-            }
-            newData[nidx] = mData[idx];
-        }
-        for (uint32 i=0;i< mSize;i++) mData[i].~T();
-        free(mData);
-        mData = newData;
+        if(mData == NULL || mSize < 2) return;
+        SortAlgorithm::Sort(mData, mData + mSize, Comp);
+    }
+    // Merge sort, order of equal elements is kept
+    template<typename Compare>
+    inline void StableSort(Compare Comp)
+    {
+        if(mData == NULL || mSize < 2) return;
+        T *buffer = (T*)malloc(sizeof(T) * mSize);
+        SortAlgorithm::StableSort(mData, mData + mSize, buffer, Comp);
+        free(buffer);
     }
 
     virtual bool Serialize(Archive &OutArchive) override
@@ -245,17 +298,11 @@ public:
     
     void Clear(bool FreeReservedData = true)
     {
-        if (mData)
-        {
-            for(uint32 i=0;i<mSize;i++) mData[i].T::~T();
-            memset(mData, 0, sizeof(T) * mReserved);
-        }
+        for(uint32 i=0;i<mSize;i++) mData[i].~T();
         mSize = 0;
-        if (FreeReservedData) {
-            if (mData) {
-                free(mData);
-                mData = nullptr;
-            }
+        if (FreeReservedData && !mInlineStorage) {
+            freeStorage();
+            mData = nullptr;
             mReserved = 0;
         }
     }
@@ -266,23 +313,105 @@ public:
 
     T& operator [] (uint32 n)               { LEASSERT(n < mSize); return *(mData + n); }
     const T& operator [] (uint32 n) const   { LEASSERT(n < mSize); return *(mData + n); }
-    void operator=(const VectorArray<T> &t)
+    VectorArray& operator=(const VectorArray &t)
+    {
+        if (this != &t) {
+            Clear(false);
+            Append(t.GetData(), t.size());
+        }
+        return *this;
+    }
+    VectorArray& operator=(VectorArray &&t)
     {
-        Resize(t.size());
-        for(uint32 i=0;i< mSize;i++)
-        {
-            mData[i] = t[i];
+        if (this != &t) {
+            Clear();
+            moveFrom(t);
         }
+        return *this;
     }
 
-	typedef VectorArrayIterator<VectorArray<T>, T> Iterator;
+	typedef VectorArrayIterator<VectorArray, T> Iterator;
 	Iterator begin() { return Iterator(*this); }
 	Iterator end() { return Iterator(*this, mSize); }
+protected:
+    // For SmallVectorArray : storage owned by derived class, used until it is outgrown
+    VectorArray(T *inlineData, uint32 inlineReserved) : VECTORARRAY_INIT
+    {
+        useInlineStorage(inlineData, inlineReserved);
+    }
+    void useInlineStorage(T *inlineData, uint32 inlineReserved)
+    {
+        LEASSERT(mSize == 0 && mData == nullptr);
+        mData = inlineData;
+        mReserved = inlineReserved;
+        mInlineStorage = 1;
+    }
+
 private:
+    uint32 getGrownReserved(uint32 n) const
+    {
+        uint32 reserved = mReserved ? mReserved + mReserved / 2 : MinReserved;
+        return (reserved < n) ? n : reserved;
+    }
+    static T* allocate(uint32 n)
+    {
+        T *data = static_cast<T*>(AllocatorT::Alloc(sizeof(T) * n));
+        LEASSERT(data);
+        return data;
+    }
+    static void relocate(T *dst, T *src, uint32 count)
+    {
+        if (count == 0)
+            return;
+        if (IsTriviallyRelocatable<T>::Value) {
+            ::memcpy(static_cast<void*>(dst), src, sizeof(T) * count);
+        }
+        else {
+            for (uint32 i = 0; i < count; i++) {
+                ::new (&dst[i]) T(Move(src[i]));
+                src[i].~T();
+            }
+        }
+    }
+    void reallocate(uint32 n)
+    {
+        LEASSERT(n >= mSize);
+        T *newData = allocate(n);
+        relocate(newData, mData, mSize);
+        freeStorage();
+        mData = newData;
+        mReserved = n;
+    }
+    void freeStorage()
+    {
+        if (mData && !mInlineStorage)
+            AllocatorT::Free(mData);
+        mInlineStorage = 0;
+    }
+    // Takes heap storage of v, or moves elements when v uses its inline storage. This array must be empty.
+    void moveFrom(VectorArray &v)
+    {
+        if (v.mInlineStorage) {
+            Reserve(v.mSize);
+            relocate(mData, v.mData, v.mSize);
+            mSize = v.mSize;
+            v.mSize = 0;
+            return;
+        }
+        freeStorage();
+        mSize = v.mSize;
+        mReserved = v.mReserved;
+        mData = v.mData;
+        v.mSize = 0;
+        v.mReserved = 0;
+        v.mData = nullptr;
+    }
+
     uint32  mSize;
-    uint32  mReserved;
+    uint32  mReserved : 31;
+    uint32  mInlineStorage : 1;         // mData is inline storage of SmallVectorArray (not freed)
     T*      mData;
 };
 }
 
-#endif
\ No newline at end of file
+#endif
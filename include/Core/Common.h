@@ -13,7 +13,7 @@
 #if defined(WINDOWS)
 #include <cassert>
 #include <Windows.h>
-#elif defined(IOS)
+#elif defined(IOS) || defined(LINUX)
 #include <assert.h>
 #endif
 #include <stdio.h>
@@ -0,0 +1,124 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file FrameAllocator.h
+@brief Linear allocator for data living for one frame
+@author minseob
+**********************************************************************/
+#ifndef LIMITENGINEV2_CORE_FRAMEALLOCATOR_H_
+#define LIMITENGINEV2_CORE_FRAMEALLOCATOR_H_
+
+#include <LEPlatform>
+
+#include <atomic>
+
+#include "Core/Common.h"
+#include "Core/Object.h"
+
+namespace LimitEngine {
+// Bump allocator with one area per frame in flight.
+// An area is reset wholesale when DrawManager begins the frame that reuses it,
+// so memory from here must not be kept longer than FrameCount - 1 frames.
+// Alloc returns nullptr when the area is full (or not initialized); callers fall back to the heap.
+class FrameAllocator
+{
+public:
+    static constexpr uint32 FrameCount = 4u;                    // Frame being recorded + frames in flight (DrawManager::MaxFrameLatency)
+    static constexpr size_t DefaultFrameMemorySize = 1u << 20;  // 1 MiB per frame
+    static constexpr size_t AllocationAlign = 16u;
+
+    static void Init(size_t frameMemorySize = DefaultFrameMemorySize);
+    static void Term();
+
+    // Called by DrawManager once per frame, after everything allocated FrameCount-1 frames ago has retired
+    static void BeginFrame(uint32 frameCounter);
+
+    static void* Alloc(size_t size);
+    template<typename T>
+    static T* AllocArray(size_t count) { return reinterpret_cast<T*>(Alloc(sizeof(T) * count)); }
+
+    static bool Contains(const void *ptr)
+    {
+        return mPool && mPool <= ptr && ptr < mPool + mFrameMemorySize * FrameCount;
+    }
+
+    // For operator new/delete of frame lifetime objects
+    static void* AllocObject(size_t size, LimitEngineMemoryCategory category)
+    {
+        if (void *ptr = Alloc(size))
+            return ptr;
+        return MemoryAllocator::Alloc(size, category);
+    }
+    static void FreeObject(void *ptr)
+    {
+        if (!Contains(ptr))
+            MemoryAllocator::Free(ptr);
+    }
+
+    // Allocations served from the frame area (heap allocations avoided) in the last finished frame
+    static uint32 GetStatLastFrameAllocationCount() { return mStats.LastFrameAllocationCount; }
+    // Allocations that did not fit in the last finished frame and went to the heap
+    static uint32 GetStatLastFrameFallbackCount()   { return mStats.LastFrameFallbackCount; }
+    static size_t GetStatLastFrameUsedMemory()      { return mStats.LastFrameUsedMemory; }
+
+private:
+    static struct STATS
+    {
+        std::atomic<uint32> AllocationCount = { 0u };
+        std::atomic<uint32> FallbackCount = { 0u };
+        uint32 LastFrameAllocationCount = 0u;
+        uint32 LastFrameFallbackCount = 0u;
+        size_t LastFrameUsedMemory = 0u;
+    } mStats;
+
+    static uint8                   *mPool;                          // Areas for all frames
+    static size_t                   mFrameMemorySize;               // Size of area for one frame
+    static uint32                   mFrameCounter;                  // Frame counter given to last BeginFrame
+    static std::atomic<uint32>      mCurrentFrameIndex;             // Area used for new allocations
+    static std::atomic<size_t>      mFrameOffsets[FrameCount];      // Used size of each area
+};
+
+// Object allocated from FrameAllocator when possible (falls back to MemoryAllocator).
+// Instances must be deleted within FrameCount - 1 frames.
+template<LimitEngineMemoryCategory category = LimitEngineMemoryCategory::Unknown>
+class FrameObject : public Object<category>
+{public:
+    void* operator new (size_t size)
+    {
+        return FrameAllocator::AllocObject(size, category);
+    }
+    void operator delete (void *data)
+    {
+        FrameAllocator::FreeObject(data);
+    }
+};
+
+// Storage allocator for containers living within a frame (e.g. VectorArray<T, FrameContainerAllocator>).
+// Storage left behind by growth is not reused until the frame area is reset, so reserve up front when possible.
+struct FrameContainerAllocator
+{
+    static void* Alloc(size_t size) { return FrameAllocator::AllocObject(size, LimitEngineMemoryCategory::Common); }
+    static void Free(void *ptr)     { FrameAllocator::FreeObject(ptr); }
+};
+}
+#endif // LIMITENGINEV2_CORE_FRAMEALLOCATOR_H_
@@ -0,0 +1,101 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file FramePacer.h
+@brief Pacing of frames (uncapped, fixed rate, adaptive)
+@author minseob
+**********************************************************************/
+#ifndef LIMITENGINEV2_CORE_FRAMEPACER_H_
+#define LIMITENGINEV2_CORE_FRAMEPACER_H_
+
+#include <LEPlatform>
+
+#include "Core/Common.h"
+#include "Core/Mutex.h"
+
+namespace LimitEngine {
+// Holds frames to the time of their interval.
+// Waiting sleeps while the deadline is further than sleep can overshoot (measured while running),
+// and spins (yielding to other threads) the rest, so frames start within microseconds of their time instead of a timer tick.
+class FramePacer
+{
+public:
+    enum class Mode : uint32
+    {
+        Uncapped = 0,       // Never wait (offline rendering, benchmarks)
+        FixedRate,          // Frames start at 1 / Rate
+        Adaptive,           // Like FixedRate, but falls to Rate / 2, Rate / 3... while frames take longer than interval (and comes back)
+    };
+    static constexpr uint32 MaxAdaptiveDivisor = 4u;
+
+    // Since ResetStatistics (error : time frame started after its time, interval error : |interval between frames - target|)
+    struct Statistics
+    {
+        uint64 Frames = 0u;
+        uint64 LateFrames = 0u;                 // Frame came after its time (nothing to wait)
+        uint64 LastErrorUSec = 0u;
+        uint64 TotalErrorUSec = 0u;
+        uint64 MaxErrorUSec = 0u;
+        uint64 LastIntervalUSec = 0u;
+        uint64 LastIntervalErrorUSec = 0u;
+        uint64 TotalIntervalErrorUSec = 0u;
+        uint64 MaxIntervalErrorUSec = 0u;
+        uint64 TotalSleepUSec = 0u;
+        uint64 TotalSpinUSec = 0u;
+        uint64 TargetIntervalUSec = 0u;         // Current target (adaptive mode changes it)
+    };
+
+    FramePacer(Mode InMode = Mode::FixedRate, double InRate = 60.0);
+
+    void SetMode(Mode InMode, double InRate = 60.0);
+    Mode GetMode();
+    double GetRate();
+
+    // Wait for time of next frame (called once for each frame, by one thread)
+    void WaitForNextFrame();
+
+    Statistics GetStatistics();
+    void ResetStatistics();
+
+private:
+    // Returns time sleep ended (spin started)
+    uint64 waitUntil(uint64 Time);
+    void updateAdaptiveDivisor(uint64 WorkTime, uint64 BaseInterval);
+
+private:
+    Mode            mMode;
+    double          mRate;
+    uint64          mBaseIntervalUSec;          // 1 / Rate
+    uint32          mAdaptiveDivisor;           // Interval = BaseInterval * Divisor
+    uint64          mAverageWorkUSec;           // Time frames take without waiting (adaptive)
+
+    uint64          mFrameTime;                 // Time current frame was scheduled to (0 : not scheduled yet)
+    uint64          mFrameStartTime;            // Time current frame started
+    uint64          mSleepOvershootUSec;        // Average oversleep of Thread::Sleep
+    uint64          mSleepDeviationUSec;        // Average deviation of oversleep
+
+    Statistics      mStatistics;
+    Mutex           mMutex;
+};
+}
+#endif // LIMITENGINEV2_CORE_FRAMEPACER_H_
@@ -28,38 +28,251 @@ OTHER DEALINGS IN THE SOFTWARE.
 #ifndef LIMITENGINEV2_CORE_HASH_H_
 #define LIMITENGINEV2_CORE_HASH_H_
 
-#ifndef USE_SSE_CRC32
-#define USE_SSE_CRC32 0
-#endif // USE_SSE_CRC32
-
-#if USE_SSE_CRC32
-#include <nmmintrin.h>
-#pragma intrinsic(_mm_crc32_u64)
-#else // Use FNV-1
-static constexpr uint64 FNV_OFFSET_BASIS_64 = 14695981039346656037U;
-static constexpr uint64 FNV_PRIME_64 = 1099511628211LLU;
+#include <string.h>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#pragma intrinsic(_umul128)
 #endif
 
 namespace LimitEngine {
+// 64bit non-cryptographic hash (wyhash final version 4)
+// Reads 8 bytes per multiply, 3 independent lanes for inputs over 48 bytes (exactly 48 goes to the tail as in reference).
+// No alignment requirement. GenerateConstexpr returns same value at compile time.
 class Hash { public:
-    static uint64 GenerateHash(const uint64* Data, size_t Size)
-    {
-        uint64 output = 0u;
-#if USE_SSE_CRC32
-        // Alignment check
-        LEASSERT(reinterpret_cast<uint64>(Data) % 8ull == 0ull && Size % 8ull == 0ull);
-        for (uint64 idx = 0; idx < Size / 8ull; idx++) {
-            output = _mm_crc32_u64(output, Data[idx]);
-        }
+    static constexpr uint64 Secret0 = 0x2d358dccaa6c78a5ull;
+    static constexpr uint64 Secret1 = 0x8bb84b93962eacc9ull;
+    static constexpr uint64 Secret2 = 0x4b33a62ed433d4a3ull;
+    static constexpr uint64 Secret3 = 0x4d5a2da51de1aa47ull;
+    static constexpr size_t BlockSize = 48u;
+
+    static uint64 Generate(const void* Data, size_t Size, uint64 Seed = 0u)
+    {
+        return generate<MemoryAccess>(static_cast<const uint8*>(Data), Size, Seed);
+    }
+    static constexpr uint64 GenerateConstexpr(const char* Data, size_t Size, uint64 Seed = 0u)
+    {
+        return generate<ConstexprAccess>(Data, Size, Seed);
+    }
+    // Finalizer of splitmix64, spreads all input bits over the output
+    static constexpr uint64 MixHash(uint64 Value)
+    {
+        Value = (Value ^ (Value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        Value = (Value ^ (Value >> 27)) * 0x94d049bb133111ebull;
+        return Value ^ (Value >> 31);
+    }
+
+private:
+    friend class HashBuilder;
+
+    // Little endian reads and 64x64->128 multiply for runtime data
+    struct MemoryAccess
+    {
+        static uint64 Read1(const uint8 *Data) { return *Data; }
+        static uint64 Read4(const uint8 *Data) { uint32 v; ::memcpy(&v, Data, sizeof(v)); return v; }
+        static uint64 Read8(const uint8 *Data) { uint64 v; ::memcpy(&v, Data, sizeof(v)); return v; }
+        static void Multiply(uint64 &A, uint64 &B)
+        {
+#if defined(_MSC_VER) && defined(_M_X64)
+            A = _umul128(A, B, &B);
+#elif defined(__SIZEOF_INT128__)
+            const unsigned __int128 r = static_cast<unsigned __int128>(A) * B;
+            A = static_cast<uint64>(r);
+            B = static_cast<uint64>(r >> 64);
 #else
-        output = FNV_OFFSET_BASIS_64;
-        const uint8* data8 = reinterpret_cast<const uint8*>(Data);
-        for (size_t dtidx = 0; dtidx < Size; dtidx++, data8++) {
-            output = (FNV_PRIME_64 * output) ^ (*data8);
-        }
+            ConstexprAccess::Multiply(A, B);
 #endif
-        return output;
+        }
+    };
+    // Same operations usable in constant expressions
+    struct ConstexprAccess
+    {
+        static constexpr uint64 Read1(const char *Data) { return static_cast<uint8>(*Data); }
+        static constexpr uint64 Read4(const char *Data)
+        {
+            return Read1(Data) | (Read1(Data + 1) << 8) | (Read1(Data + 2) << 16) | (Read1(Data + 3) << 24);
+        }
+        static constexpr uint64 Read8(const char *Data) { return Read4(Data) | (Read4(Data + 4) << 32); }
+        static constexpr void Multiply(uint64 &A, uint64 &B)
+        {
+            const uint64 ha = A >> 32, hb = B >> 32, la = static_cast<uint32>(A), lb = static_cast<uint32>(B);
+            const uint64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+            const uint64 t = rl + (rm0 << 32);
+            uint64 carry = t < rl;
+            const uint64 lo = t + (rm1 << 32);
+            carry += lo < t;
+            A = lo;
+            B = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+        }
+    };
+
+    template<typename Access>
+    static constexpr uint64 mix(uint64 A, uint64 B)
+    {
+        Access::Multiply(A, B);
+        return A ^ B;
+    }
+    template<typename Access>
+    static constexpr uint64 initSeed(uint64 Seed)
+    {
+        return Seed ^ mix<Access>(Seed ^ Secret0, Secret1);
+    }
+    template<typename Access, typename T>
+    static constexpr void processBlock(const T *Data, uint64 &Seed, uint64 &See1, uint64 &See2)
+    {
+        Seed = mix<Access>(Access::Read8(Data     ) ^ Secret1, Access::Read8(Data +  8) ^ Seed);
+        See1 = mix<Access>(Access::Read8(Data + 16) ^ Secret2, Access::Read8(Data + 24) ^ See1);
+        See2 = mix<Access>(Access::Read8(Data + 32) ^ Secret3, Access::Read8(Data + 40) ^ See2);
+    }
+    // Input of 16 bytes or less
+    template<typename Access, typename T>
+    static constexpr uint64 generateShort(const T *Data, size_t Size, uint64 Seed)
+    {
+        uint64 a = 0u, b = 0u;
+        if (Size >= 4u) {
+            const size_t offset = (Size >> 3) << 2;
+            a = (Access::Read4(Data) << 32) | Access::Read4(Data + offset);
+            b = (Access::Read4(Data + Size - 4) << 32) | Access::Read4(Data + Size - 4 - offset);
+        }
+        else if (Size > 0u) {
+            a = (Access::Read1(Data) << 16) | (Access::Read1(Data + (Size >> 1)) << 8) | Access::Read1(Data + Size - 1);
+        }
+        return finalize<Access>(a, b, Seed, Size);
+    }
+    // Remaining input after blocks (Data - 16 has to be readable if Remain < 16)
+    template<typename Access, typename T>
+    static constexpr uint64 generateTail(const T *Data, size_t Remain, uint64 Seed, uint64 Size)
+    {
+        while (Remain > 16u) {
+            Seed = mix<Access>(Access::Read8(Data) ^ Secret1, Access::Read8(Data + 8) ^ Seed);
+            Data += 16;
+            Remain -= 16u;
+        }
+        return finalize<Access>(Access::Read8(Data + Remain - 16), Access::Read8(Data + Remain - 8), Seed, Size);
     }
+    template<typename Access>
+    static constexpr uint64 finalize(uint64 A, uint64 B, uint64 Seed, uint64 Size)
+    {
+        A ^= Secret1;
+        B ^= Seed;
+        Access::Multiply(A, B);
+        return mix<Access>(A ^ Secret0 ^ Size, B ^ Secret1);
+    }
+    template<typename Access, typename T>
+    static constexpr uint64 generate(const T *Data, size_t Size, uint64 Seed)
+    {
+        Seed = initSeed<Access>(Seed);
+        if (Size <= 16u)
+            return generateShort<Access>(Data, Size, Seed);
+        const T *current = Data;
+        size_t remain = Size;
+        if (remain > BlockSize) {
+            uint64 see1 = Seed, see2 = Seed;
+            do {
+                processBlock<Access>(current, Seed, see1, see2);
+                current += BlockSize;
+                remain -= BlockSize;
+            } while (remain > BlockSize);
+            Seed ^= see1 ^ see2;
+        }
+        return generateTail<Access>(current, remain, Seed, Size);
+    }
+};
+
+// Known answers of reference wyhash final version 4 (default secret, seed 0) around block size
+static_assert(Hash::GenerateConstexpr("0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKL", 48) == 0x29b3b1a2cd889e34ull, "wyhash 48 bytes");
+static_assert(Hash::GenerateConstexpr("0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLM", 49) == 0xf254bb65043d4692ull, "wyhash 49 bytes");
+static_assert(Hash::GenerateConstexpr("0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789abcdefghijklmnopqrstuvwx", 96) == 0x9ea1eb239723f122ull, "wyhash 96 bytes");
+
+// Hash of data fed in pieces (fields of struct without copying whole struct)
+// Finalize() equals Hash::Generate() of all added bytes in order.
+class HashBuilder
+{
+public:
+    explicit HashBuilder(uint64 Seed = 0u)
+        : mSeed(Hash::initSeed<Hash::MemoryAccess>(Seed)), mSee1(mSeed), mSee2(mSeed), mSize(0u), mBuffered(0u)
+    {}
+
+    void Add(const void *Data, size_t Size)
+    {
+        const uint8 *data = static_cast<const uint8*>(Data);
+        mSize += Size;
+        if (mBuffered) {
+            const size_t fill = MIN(Hash::BlockSize - mBuffered, Size);
+            ::memcpy(mBuffer + TailSize + mBuffered, data, fill);
+            mBuffered += static_cast<uint32>(fill);
+            data += fill;
+            Size -= fill;
+            if (Size == 0u)     // Last block is left to the tail until more data follows
+                return;
+            consumeBlocks(mBuffer + TailSize, 1u);
+            mBuffered = 0u;
+        }
+        if (Size > Hash::BlockSize) {   // Bulk data is hashed in place
+            const size_t blockCount = (Size - 1u) / Hash::BlockSize;
+            consumeBlocks(data, blockCount);
+            data += blockCount * Hash::BlockSize;
+            Size -= blockCount * Hash::BlockSize;
+        }
+        ::memcpy(mBuffer + TailSize, data, Size);
+        mBuffered = static_cast<uint32>(Size);
+    }
+    template<typename T>
+    HashBuilder& operator << (const T &Value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Add fields of types with padding or pointers one by one");
+        if (mBuffered + sizeof(T) <= Hash::BlockSize) {  // Fits in current block (fixed size copy)
+            ::memcpy(mBuffer + TailSize + mBuffered, &Value, sizeof(T));
+            mBuffered += static_cast<uint32>(sizeof(T));
+            mSize += sizeof(T);
+        }
+        else {
+            Add(&Value, sizeof(T));
+        }
+        return *this;
+    }
+
+    uint64 Finalize() const
+    {
+        if (mSize <= 16u)
+            return Hash::generateShort<Hash::MemoryAccess>(mBuffer + TailSize, static_cast<size_t>(mSize), mSeed);
+        const uint64 seed = (mSize > Hash::BlockSize) ? (mSeed ^ mSee1 ^ mSee2) : mSeed;
+        return Hash::generateTail<Hash::MemoryAccess>(mBuffer + TailSize, mBuffered, seed, mSize);
+    }
+
+private:
+    static constexpr uint32 TailSize = 16u;     // Last bytes of consumed blocks, read by finalization
+
+    void consumeBlocks(const uint8 *Data, size_t BlockCount)
+    {
+        for (size_t blockIndex = 0; blockIndex < BlockCount; blockIndex++, Data += Hash::BlockSize)
+            Hash::processBlock<Hash::MemoryAccess>(Data, mSeed, mSee1, mSee2);
+        ::memcpy(mBuffer, Data - TailSize, TailSize);
+    }
+
+private:
+    uint64  mSeed;
+    uint64  mSee1;
+    uint64  mSee2;
+    uint64  mSize;                                  // Count of all added bytes
+    uint32  mBuffered;                              // Count of bytes in mBuffer after tail (1 ~ BlockSize once blocks are consumed)
+    uint8   mBuffer[TailSize + Hash::BlockSize];
+};
+
+// Hash of keys for hashed containers (MapArray)
+// Default : bytes of the object (plain data types). Specialize for types owning pointers.
+template<typename T, typename Enable = void> struct HashTraits
+{
+    static uint64 GetHash(const T &Value) { return Hash::Generate(&Value, sizeof(T)); }
+};
+template<typename T> struct HashTraits<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+{
+    static uint64 GetHash(const T &Value) { return Hash::MixHash(static_cast<uint64>(Value)); }
+};
+template<typename T> struct HashTraits<T*>
+{
+    static uint64 GetHash(const T *Value) { return Hash::MixHash(static_cast<uint64>(reinterpret_cast<uintptr_t>(Value))); }
 };
 }
 
@@ -28,6 +28,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 #ifndef LIMITENGINEV2_CORE_MEMORY_H_
 #define LIMITENGINEV2_CORE_MEMORY_H_
 
+#include <stddef.h>
+
 namespace LimitEngine
 {
 enum class LimitEngineMemoryCategory : int {
@@ -40,9 +40,26 @@ class MemoryAllocator : public Memory
 {
     static constexpr size_t MemoryBlockSize = 16u;
 
+    // Two-level segregated fit (TLSF) free lists
+    static constexpr uint32 SecondLevelIndexBits = 4u;
+    static constexpr uint32 SecondLevelCount = 1u << SecondLevelIndexBits;
+    static constexpr uint32 FirstLevelCount = 32u - SecondLevelIndexBits + 1u;
+    static constexpr uint32 InvalidBlockIndex = 0xffffffffu;
+
+    // Per-thread caches of small areas (size classes up to 256 bytes)
+    static constexpr uint32 SizeClassCount = 8u;
+    static constexpr uint64 ThreadCacheMaxMemBlocks = 16u;
+    static constexpr uint32 ThreadCacheRefillCount = 16u;     // Areas taken from the pool per lock
+    static constexpr uint32 ThreadCacheMaxCount = 64u;        // Areas kept per size class before releasing
+    static constexpr uint32 ThreadCacheReleaseCount = 32u;    // Areas returned to the pool per lock
+
     static struct STATS
     {
-        size_t AllocatedMemory = 0u;
+        size_t AllocatedMemory = 0u;        // Taken from the pool (includes areas held by thread caches)
+        uint64 LockCount = 0u;              // Acquisitions of the pool lock
+        uint64 LockContentionCount = 0u;    // Acquisitions that had to wait for another thread
+        uint64 ThreadCacheHitCount = 0u;    // Small allocations served without the pool lock
+        uint64 ThreadCacheMissCount = 0u;   // Small allocations that refilled the thread cache
     } mStats;
 
 public:
@@ -52,7 +69,11 @@ public:
         uint32 category;            // [4]
         uint8  allocated : 1;       // [1]
         uint8  padding_flags : 7;
-        uint8  _[3];                // [3]
+        // Separate bytes so that thread caches (without the pool lock) and neighbouring
+        // areas (under the pool lock) never write the same byte
+        uint8  prevAreaFree;        // [1] Previous area in memory is free (its footer is valid)
+        uint8  sizeClass;           // [1] Size class + 1 for areas owned by thread caches (0 : none)
+        uint8  inThreadCache;       // [1] Area is currently in a thread cache
 
         MEMBLOCKHEADER()
         {
@@ -74,6 +95,22 @@ public:
             return (this + 1) + memBlocks;
         }
 
+        // Free areas keep their free list links at the head of the payload
+        // and the index of their own header at the tail (footer).
+        struct FREELINK
+        {
+            uint32 nextFreeIndex;
+            uint32 prevFreeIndex;
+        };
+        FREELINK* getFreeLink()
+        {
+            return reinterpret_cast<FREELINK*>(this + 1);
+        }
+        uint64* getFooter()
+        {
+            return reinterpret_cast<uint64*>(getNextMemoryArea()) - 1;
+        }
+
         MEMBLOCKHEADER* splitMemoryArea(uint64 splitBlocks);
 
         bool canMergeNextMemoryArea();
@@ -89,12 +126,41 @@ public:
     static void Free(void* ptr);
 
     static size_t GetStatAllocatedMemory() { return mStats.AllocatedMemory; }
+    static uint64 GetStatLockCount() { return mStats.LockCount; }
+    static uint64 GetStatLockContentionCount() { return mStats.LockContentionCount; }
+    static uint64 GetStatThreadCacheHitCount() { return mStats.ThreadCacheHitCount; }
+    static uint64 GetStatThreadCacheMissCount() { return mStats.ThreadCacheMissCount; }
 
 private:
+    struct THREADCACHE
+    {
+        MEMBLOCKHEADER *freeAreas[SizeClassCount] = { nullptr, };
+        uint32          freeAreaCounts[SizeClassCount] = { 0u, };
+        uint64          hitCount = 0u;      // Flushed into mStats when the pool lock is taken
+
+        ~THREADCACHE();
+    };
+    class ScopedAllocatorLock;
+
+    static MEMBLOCKHEADER* allocMemoryArea(uint64 newMemBlocks);
+    static void freeMemoryArea(MEMBLOCKHEADER *memArea);
     static MEMBLOCKHEADER* findUnusedMemoryArea(size_t requiredMemBlocks);
 
+    static void refillThreadCache(THREADCACHE &cache, uint32 sizeClass);
+    static void releaseThreadCache(THREADCACHE &cache, uint32 sizeClass, uint32 releaseCount);
+    static void flushThreadCache(THREADCACHE &cache);
+
+    static void mappingInsert(uint64 memBlocks, uint32 &firstLevel, uint32 &secondLevel);
+    static void mappingSearch(uint64 memBlocks, uint32 &firstLevel, uint32 &secondLevel);
+    static void insertFreeMemoryArea(MEMBLOCKHEADER *memArea);
+    static void removeFreeMemoryArea(MEMBLOCKHEADER *memArea);
+
     static uint64 getMemoryAreasCount();
-    static void mergeUnusedMemoryAreaAll();
+
+    static uint32 getMemoryAreaIndex(const MEMBLOCKHEADER *memArea)
+    {
+        return static_cast<uint32>(memArea - mMemBlocks);
+    }
 
     static const MEMBLOCKHEADER* getMemoryEndAddr()
     {
@@ -105,6 +171,20 @@ private:
     static size_t               mPoolSize;                  // Size of memory pool
     static MEMBLOCKHEADER      *mMemBlocks;                 // Memory blocks
     static uint64               mWholeMemBlocksCount;       // Count of memory blocks
+
+    static uint32               mFirstLevelBitmap;                                      // Non-empty first level lists
+    static uint32               mSecondLevelBitmaps[FirstLevelCount];                   // Non-empty second level lists
+    static MEMBLOCKHEADER      *mFreeMemoryAreas[FirstLevelCount][SecondLevelCount];    // Heads of free lists
+
+    static thread_local THREADCACHE sThreadCache;                                      // Small area cache of this thread
+};
+
+// Storage allocator for containers (VectorArray, ...) drawing from MemoryAllocator with category
+template<LimitEngineMemoryCategory category = LimitEngineMemoryCategory::Common>
+struct ContainerAllocator
+{
+    static void* Alloc(size_t size) { return MemoryAllocator::Alloc(size, category); }
+    static void Free(void *ptr)     { MemoryAllocator::Free(ptr); }
 };
 }
 #endif // LIMITENGINEV2_CORE_MEMORYALLOCATOR_H_
\ No newline at end of file
@@ -15,9 +15,10 @@
 #include <LEFloatVector4.h>
 
 #include "Core/String.h"
+#include "Core/StringID.h"
 #include "Containers/VectorArray.h"
 
-#define METADATA_POINTER(ParamName) GetPointerOffset(this, &this->##ParamName)
+#define METADATA_POINTER(ParamName) GetPointerOffset(this, &this->ParamName)
 
 namespace LimitEngine {
     class MetaData {
@@ -49,23 +50,13 @@ namespace LimitEngine {
             void SetVarType(const String &tn) 
             {
                 varTypeName = tn;
-                if(tn == "float") {
-                    varType = MetaDataVarType_Float;
-                }
-                else if(tn == "LEMath::FloatVector2") {
-                    varType = MetaDataVarType_FVector2;
-                }
-                else if(tn == "LEMath::FloatVector3") {
-                    varType = MetaDataVarType_FVector3;
-                }
-                else if(tn == "LEMath::FloatVector4") {
-                    varType = MetaDataVarType_FVector4;
-                }
-                else if(tn == "String") {
-                    varType = MetaDataVarType_String;
-                }
-                else {
-                    varType = MetaDataVarType_Unknown;
+                switch (StringID(tn).GetHash()) {
+                case StringID("float").GetHash():                   varType = MetaDataVarType_Float;    break;
+                case StringID("LEMath::FloatVector2").GetHash():    varType = MetaDataVarType_FVector2; break;
+                case StringID("LEMath::FloatVector3").GetHash():    varType = MetaDataVarType_FVector3; break;
+                case StringID("LEMath::FloatVector4").GetHash():    varType = MetaDataVarType_FVector4; break;
+                case StringID("String").GetHash():                  varType = MetaDataVarType_String;   break;
+                default:                                            varType = MetaDataVarType_Unknown;  break;
                 }
             }
         };
@@ -27,6 +27,7 @@ namespace LimitEngine
 			Mutex& mMutex;
 		};
     public:
+#if defined(WINDOWS)
 		Mutex()
 		{
 			InitializeCriticalSection(&mCriticalSection);
@@ -54,5 +55,39 @@ namespace LimitEngine
         
 	private:
 		CRITICAL_SECTION mCriticalSection;
+#else
+		Mutex()
+		{
+			// Recursive like critical section
+			pthread_mutexattr_t attribute;
+			pthread_mutexattr_init(&attribute);
+			pthread_mutexattr_settype(&attribute, PTHREAD_MUTEX_RECURSIVE);
+			pthread_mutex_init(&mMutex, &attribute);
+			pthread_mutexattr_destroy(&attribute);
+		}
+        
+		~Mutex()
+		{
+			pthread_mutex_destroy(&mMutex);
+		}
+		
+		void Lock()
+		{
+			pthread_mutex_lock(&mMutex);
+		}
+		
+		bool TryLock()
+		{
+			return pthread_mutex_trylock(&mMutex) == 0;
+		}
+		
+		void Unlock()
+		{
+			pthread_mutex_unlock(&mMutex);
+		}
+        
+	private:
+		pthread_mutex_t mMutex;
+#endif
     };
 }
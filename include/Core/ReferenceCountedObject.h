@@ -8,8 +8,9 @@
  ***********************************************************/
 #pragma once
 
+#include <atomic>
+
 #include "Object.h"
-#include "Mutex.h"
 
 namespace LimitEngine {
     class IReferenceCountedObject
@@ -24,15 +25,21 @@ namespace LimitEngine {
     class ReferenceCountedObject : public IReferenceCountedObject, public Object<category>
     {
     public:
-        uint32 GetReferenceCounter() const override { return mReferenceCounter; }
+        uint32 GetReferenceCounter() const override { return mReferenceCounter.load(std::memory_order_acquire); }
 
-        uint32 AddReferenceCounter() override { Mutex::ScopedLock scopedLock(mMutex); return ++mReferenceCounter; }
-        uint32 SubReferenceCounter() override { Mutex::ScopedLock scopedLock(mMutex); LEASSERT(mReferenceCounter > 0); return --mReferenceCounter; }
+        // Taking a new reference needs no ordering, the caller already holds one.
+        uint32 AddReferenceCounter() override { return mReferenceCounter.fetch_add(1u, std::memory_order_relaxed) + 1u; }
+        // Releasing must publish our writes to (and acquire others' writes before) whoever deletes the object at zero.
+        uint32 SubReferenceCounter() override
+        {
+            const uint32 prevCounter = mReferenceCounter.fetch_sub(1u, std::memory_order_acq_rel);
+            LEASSERT(prevCounter > 0);
+            return prevCounter - 1u;
+        }
     protected:
-        ReferenceCountedObject() : mReferenceCounter(0u), mMutex() {}
+        ReferenceCountedObject() : mReferenceCounter(0u) {}
         virtual ~ReferenceCountedObject() {}
     private:
-        Mutex mMutex;
-        uint32 mReferenceCounter;
+        std::atomic<uint32> mReferenceCounter;
     };
 }
\ No newline at end of file
@@ -28,6 +28,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 #ifndef LIMITENGINEV2_CORE_REFERENCECOUNTEDPOINTER_H_
 #define LIMITENGINEV2_CORE_REFERENCECOUNTEDPOINTER_H_
 
+#include "Core/Util.h"
+
 namespace LimitEngine {
     template<typename T>
     class ReferenceCountedPointer
@@ -39,6 +41,9 @@ namespace LimitEngine {
                 mData->AddReferenceCounter();
             }
         }
+        ReferenceCountedPointer(ReferenceCountedPointer &&In) : mData(In.mData) {
+            In.mData = nullptr;
+        }
         ReferenceCountedPointer(T *Data) : mData(Data) {
             if (mData) {
                 mData->AddReferenceCounter();
@@ -69,6 +74,14 @@ namespace LimitEngine {
                 mData->AddReferenceCounter();
             return *this;
         }
+        ReferenceCountedPointer& operator = (ReferenceCountedPointer &&InPointer) {
+            if (this != &InPointer) {
+                Release();
+                mData = InPointer.mData;
+                InPointer.mData = nullptr;
+            }
+            return *this;
+        }
         ReferenceCountedPointer& operator = (T *InPointer) {
             Release();
             mData = InPointer;
@@ -85,6 +98,10 @@ namespace LimitEngine {
     private:
         T *mData;
     };
+
+    // Only holds a pointer, so VectorArray can relocate it by memcpy
+    template<typename T>
+    struct IsTriviallyRelocatable<ReferenceCountedPointer<T>> { static constexpr bool Value = true; };
 }
 
 #endif // LIMITENGINEV2_CORE_REFERENCECOUNTEDPOINTER_H_
\ No newline at end of file
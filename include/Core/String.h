@@ -17,202 +17,140 @@
 #include <string.h>
 #include "Core/MemoryAllocator.h"
 #include "Core/Object.h"
+#include "Core/Hash.h"
+#include "Core/Util.h"
 
 namespace LimitEngine {
+// Strings up to InlineCapacity characters are kept inside of String (no heap allocation).
+// Length and capacity are cached, heap buffer grows geometrically on append.
 class String : public Object<LimitEngineMemoryCategory::Common>
 {
+public:
+    static constexpr uint32 InlineCapacity = 22u;       //!< Max length stored inline (without null terminator)
+
 public:
     String(const char *str = 0);
     String(const String &str);
+    String(String &&str);
+    String(const char *str, size_t length);
     String(const float &f);
     virtual ~String();
 
     // ============================================
     // Operators (inline)
     // ============================================
-    inline         void    operator =  (const String &str)
+    inline       String& operator =  (const String &str)
     {
-        Release();
-        if (str.IsEmpty())
-            return;
-        if (mBuffer)
-        {
-            free(mBuffer);
-            mBuffer = 0;
-        }
-        size_t strlen = str.GetLength();
-        mBuffer = (char *)malloc(strlen+1);
-        memcpy(mBuffer, str.GetCharPtr(), strlen+1);
+        if (this != &str)
+            Assign(str.GetCharPtr(), str.GetLength());
+        return *this;
     }
-    inline       void   operator =  (const char *str)
+    inline       String& operator =  (String &&str)
     {
-        Release();
-        if (!str || !strlen(str))
-            return;
-        if (mBuffer)
-        {
-            free(mBuffer);
-            mBuffer = 0;
+        if (this != &str) {
+            Release();
+            moveFrom(str);
         }
-        size_t strlen = ::strlen(str);
-        mBuffer = (char *)malloc(strlen+1);
-        memcpy(mBuffer, str, strlen+1);
+        return *this;
     }
-    inline       bool   operator == (const String &str)
+    inline       String& operator =  (const char *str)
     {
-        if (str.IsEmpty())
-        {
-            if (IsEmpty()) return true;
-            else return false;
-        }
-        else if (!IsEmpty())
-        {
-            return (::strcmp(mBuffer, str.mBuffer) == 0);
-        }
-        return false;
+        Assign(str, str ? ::strlen(str) : 0u);
+        return *this;
     }
     inline       bool   operator == (const String &str) const
     {
-        if (str.IsEmpty())
-        {
-            if (IsEmpty()) return true;
-            else return false;
-        }
-        else if (!IsEmpty())
-        {
-            return (::strcmp(mBuffer, str.mBuffer) == 0);
-        }
-        return false;
-    }
-    inline       bool   operator == (const char *str)
-    {
-        if (!strlen(str))
-        {
-            if (IsEmpty()) return true;
-            else return false;
-        }
-        else if (!IsEmpty())
-        {
-            return (::strcmp(mBuffer, str) == 0);
-        }
-        return false;
+        return GetLength() == str.GetLength() && ::memcmp(GetCharPtr(), str.GetCharPtr(), GetLength()) == 0;
     }
     inline       bool   operator == (const char *str) const
     {
-        if (!strlen(str))
-        {
-            if (IsEmpty()) return true;
-            else return false;
-        }
-        else if (!IsEmpty())
-        {
-            return (::strcmp(mBuffer, str) == 0);
-        }
-        return false;
-    }
-    inline       bool   operator != (const String &str)
-    {
-        if (str.IsEmpty()) return !IsEmpty();
-        else return (::strcmp(mBuffer, str.mBuffer) == 0);
-    }
-    inline       bool   operator != (const String &str) const
-    {
-        if (str.IsEmpty()) return !IsEmpty();
-        else return !(::strcmp(mBuffer, str.mBuffer) == 0);
-    }
-    inline       bool   operator != (const char *str)
-    {
-        if (!strlen(str)) return !IsEmpty();
-        else return !(::strcmp(mBuffer, str) == 0);
-    }
-    inline       bool   operator != (const char *str) const
-    {
-        if (!strlen(str)) return !IsEmpty();
-        else return !(::strcmp(mBuffer, str) == 0);
-    }
-    inline         char    operator [] (int n)
-    { 
-        if (mBuffer) return mBuffer[n]; 
-        else return 0;
-    }
-    inline         void    operator += (const String &str)
-    {
-        size_t thisLength = GetLength();
-        size_t tarLength = str.GetLength();
-        char *dstBuf = (char *)malloc(thisLength + tarLength + 1);
-        memcpy(dstBuf, mBuffer, thisLength);
-        memcpy(&dstBuf[thisLength], str.GetCharPtr(), tarLength+1);
-        free(mBuffer);
-        mBuffer = dstBuf;
-    }
-    inline       void    operator += (const char* str)
-    {
-        size_t thisLength = GetLength();
-        size_t tarLength = strlen(str);
-        char *dstBuf = (char *)malloc(thisLength + tarLength + 1);
-        memcpy( dstBuf, mBuffer, thisLength);
-        memcpy(&dstBuf[thisLength], str, tarLength+1);
-        free(mBuffer);
-        mBuffer = dstBuf;
-    }
-    inline       void   operator += (char c)
-    {
-        size_t thisLength = GetLength();
-        char *dstBuf = (char *)malloc(thisLength + 2);
-        ::memset(dstBuf, 0, thisLength + 2);
-        memcpy(dstBuf, mBuffer, thisLength);
-        dstBuf[thisLength] = c;
-        free(mBuffer);
-        mBuffer = dstBuf;        
-    }
+        if (!str) return IsEmpty();
+        return ::strcmp(GetCharPtr(), str) == 0;
+    }
+    inline       bool   operator != (const String &str) const   { return !(*this == str); }
+    inline       bool   operator != (const char *str) const     { return !(*this == str); }
+    inline         char    operator [] (int n) const            { return GetCharPtr()[n]; }
+    inline         String& operator += (const String &str)      { Append(str.GetCharPtr(), str.GetLength()); return *this; }
+    inline         String& operator += (const char* str)        { if (str) Append(str, ::strlen(str)); return *this; }
+    inline         String& operator += (char c)                 { Append(&c, 1u); return *this; }
     inline const String    operator + (const String &s1) const
     {
-        String output(*this);
-        output += s1;
+        String output;
+        output.Reserve(GetLength() + s1.GetLength());
+        output.Append(GetCharPtr(), GetLength());
+        output.Append(s1.GetCharPtr(), s1.GetLength());
         return output;
     }
     inline operator const char*() const {
-        return mBuffer;
+        return GetCharPtr();
     }
     inline operator char*() {
-        return mBuffer;
+        return GetCharPtr();
     }
 
     // ============================================
     // Get & Set
     // ============================================
-    bool        IsEmpty() const                        { return (!mBuffer || strlen(mBuffer) == 0); }
-    size_t        GetLength() const                    { if (mBuffer) return strlen(mBuffer); else return 0; }
-    char*        GetCharPtr()                        { return mBuffer; }
-    const char*    GetCharPtr() const                    { return mBuffer; }
+    bool        IsEmpty() const                     { return GetLength() == 0; }
+    size_t      GetLength() const                   { return isInline() ? getInlineLength() : mHeap.length; }
+    size_t      GetCapacity() const                 { return isInline() ? InlineCapacity : mHeap.capacity; }
+    char*       GetCharPtr()                        { return isInline() ? mInline : mHeap.buffer; }
+    const char* GetCharPtr() const                  { return isInline() ? mInline : mHeap.buffer; }
     char*       GetCopiedCharPtr() const
     {
         if (!GetLength()) return NULL;
         char *output = (char *)malloc(GetLength() + 1);
-        ::memcpy(output, mBuffer, GetLength() + 1);
+        ::memcpy(output, GetCharPtr(), GetLength() + 1);
         return output;
     }
 
     // ============================================
     // Convert
     // ============================================
-    int         ToInt() const                       { if (GetLength()) return atoi(mBuffer); else return 0; }
-    float       ToFloat() const                     { if (GetLength()) return float(atof(mBuffer)); else return 0.0f; }
+    int         ToInt() const                       { if (GetLength()) return atoi(GetCharPtr()); else return 0; }
+    float       ToFloat() const                     { if (GetLength()) return float(atof(GetCharPtr())); else return 0.0f; }
     
     // ============================================
     // Public
     // ============================================
     void    Release();
+    void    Reserve(size_t capacity);
+    void    Assign(const char *str, size_t length);
+    void    Append(const char *str, size_t length);
+    void    Truncate(size_t length);
     bool    IsContain(const String &str) const;
     uint32  FindWord(const String &str) const;
     String  Replace(const String &str, const String &tar);
     void    Split(const String &SplitWord, String &A, String &B) const;
 
 private:
-    char        *mBuffer;
+    static constexpr uint8 HeapMarker = 0xffu;          // Last byte of mInline when buffer is on heap
+
+    bool    isInline() const                { return static_cast<uint8>(mInline[InlineCapacity + 1]) != HeapMarker; }
+    size_t  getInlineLength() const         { return static_cast<uint8>(mInline[InlineCapacity + 1]); }
+    void    initEmpty();
+    void    setLength(size_t length);
+    void    moveFrom(String &str);
+
+    union {
+        struct {
+            char   *buffer;                 // Null terminated
+            uint32  length;
+            uint32  capacity;               // Without null terminator
+        } mHeap;
+        char mInline[InlineCapacity + 2];   // Characters + null terminator + (inline length or HeapMarker)
+    };
 
     friend class Archive;
 };
+
+// No pointer into itself, so VectorArray can relocate it by memcpy
+template<> struct IsTriviallyRelocatable<String> { static constexpr bool Value = true; };
+
+template<> struct HashTraits<String>
+{
+    static uint64 GetHash(const String &Value) { return Hash::Generate(Value.GetCharPtr(), Value.GetLength()); }
+};
 }
 
 #endif // _LE_STRING_H_
\ No newline at end of file
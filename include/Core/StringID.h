@@ -0,0 +1,118 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file StringID.h
+@brief Interned name ID (hash of string)
+@author minseob
+**********************************************************************/
+#ifndef LIMITENGINEV2_CORE_STRINGID_H_
+#define LIMITENGINEV2_CORE_STRINGID_H_
+
+#include <string.h>
+#include <type_traits>
+
+#include "Core/Common.h"
+#include "Core/Hash.h"
+#include "Core/String.h"
+
+// Keep names of StringIDs made at runtime for reverse lookup (logging) and collision check.
+// The table keeps every distinct name until StringID::TerminateTable and is not pruned, so it grows
+// with each new runtime name (generated per object names, user input...). Every runtime StringID also
+// takes the table lock. On by default only in debug builds, do not force it on in shipping builds.
+#ifndef STRINGID_KEEP_NAMES
+#ifdef _DEBUG
+#define STRINGID_KEEP_NAMES 1
+#else
+#define STRINGID_KEEP_NAMES 0
+#endif
+#endif // STRINGID_KEEP_NAMES
+
+// StringID of literal, hashed at compile time in any context (FindChild(LE_STRINGID("POSITION")) is integer compares only)
+#define LE_STRINGID(Literal) ::LimitEngine::StringID::FromHash(std::integral_constant<uint64, ::LimitEngine::StringID(Literal).GetHash()>::value)
+
+namespace LimitEngine {
+// 64bit hash of name (Hash::Generate). Comparing and hashing are single integer operations.
+// Literals can be hashed at compile time : LE_STRINGID("POSITION") / constexpr StringID PositionID("POSITION");
+// Strings at runtime are interned to global table (only if STRINGID_KEEP_NAMES, the table only grows).
+class StringID
+{
+public:
+    // Name at runtime. Needs a conversion, so literals prefer constexpr constructor.
+    struct DynamicName
+    {
+        DynamicName(const char *InName) : Name(InName), Length(InName ? ::strlen(InName) : 0u) {}
+        DynamicName(const String &InName) : Name(InName.GetCharPtr()), Length(InName.GetLength()) {}
+        const char *Name;
+        size_t      Length;
+    };
+
+    constexpr StringID() : mHash(0u) {}
+    template<size_t N>
+    constexpr StringID(const char (&Literal)[N]) : mHash(Generate(Literal, getLength(Literal, N))) {}
+    explicit StringID(const DynamicName &Name)  : mHash(0u) { intern(Name.Name, Name.Length); }
+    StringID(const char *Name, size_t Length)   : mHash(0u) { intern(Name, Length); }
+
+    static constexpr StringID FromHash(uint64 Hash) { return StringID(Hash, 0); }
+    static constexpr uint64 Generate(const char *Name, size_t Length) { return Hash::GenerateConstexpr(Name, Length); }
+
+    constexpr uint64 GetHash() const                    { return mHash; }
+    constexpr bool IsValid() const                      { return mHash != 0u; }
+    constexpr bool operator == (const StringID &Other) const { return mHash == Other.mHash; }
+    constexpr bool operator != (const StringID &Other) const { return mHash != Other.mHash; }
+    constexpr bool operator <  (const StringID &Other) const { return mHash <  Other.mHash; }
+
+    // Name of interned ID (empty if unknown or names are not kept)
+    String GetName() const;
+
+    // Release names in table (call on termination of engine)
+    static void TerminateTable();
+
+private:
+    static constexpr size_t getLength(const char *Name, size_t Capacity)
+    {
+        size_t length = 0u;
+        while (length < Capacity && Name[length])
+            length++;
+        return length;
+    }
+    void intern(const char *Name, size_t Length)
+    {
+        mHash = Hash::Generate(Name, Length);
+#if STRINGID_KEEP_NAMES
+        registerName(Name, Length);
+#endif
+    }
+    void registerName(const char *Name, size_t Length) const;
+    constexpr StringID(uint64 Hash, int) : mHash(Hash) {}
+
+private:
+    uint64 mHash;
+};
+
+template<> struct HashTraits<StringID>
+{
+    static uint64 GetHash(const StringID &Value) { return Value.GetHash(); }
+};
+}
+
+#endif // LIMITENGINEV2_CORE_STRINGID_H_
@@ -16,8 +16,10 @@
 #include <LEFloatMatrix4x4.h>
 
 #include "Core/String.h"
+#include "Core/StringID.h"
 #include "Core/ReferenceCountedObject.h"
 #include "Containers/VectorArray.h"
+#include "Containers/SmallVectorArray.h"
 #include "Renderer/ByteColorRGBA.h"
 
 namespace LimitEngine {
@@ -27,9 +29,10 @@ namespace LimitEngine {
         typedef struct _NODE
         {
             String                   name;
+            StringID                 nameID;                // Interned name (compare this)
             _NODE                   *parent;
-            VectorArray<String>      values;
-            VectorArray<_NODE*>      children;
+            SmallVectorArray<String, 4> values;             // Mostly 1~4 values
+            SmallVectorArray<_NODE*, 4> children;
             
             // ------------------------------------------
             // Ctor & Dtor
@@ -53,18 +56,23 @@ namespace LimitEngine {
             // ------------------------------------------
             // Operators
             // ------------------------------------------
-            _NODE* operator[](const String &name)   { return FindChild(name); }
+            _NODE* operator[](const StringID &id)   { return FindChild(id); }
             // ------------------------------------------
             // Interface
             // ------------------------------------------
-            _NODE* FindChild(const String &name)
+            _NODE* FindChild(const StringID &id)
             {
                 for(uint32 n=0;n<children.count();n++)
                 {
-                    if (children[n]->name == name) return children[n];
+                    if (children[n]->nameID == id) return children[n];
                 }
                 return NULL;
             }
+            void SetName(const char *buf, uint32 length)
+            {
+                name.Assign(buf, length);
+                nameID = StringID(buf, length);
+            }
             bool IsValueNumber(int n) const
             {
                 for(uint32 i=0;i<values[n].GetLength();i++)
@@ -136,7 +144,7 @@ namespace LimitEngine {
         bool Parse(const char *text);
         bool Save(const char *filename);
 
-        NODE* GetNode(const char *name);
+        NODE* GetNode(const StringID &id);
     private:
         void addNewNode(NODE *Parent, const char *NodeName, NODE **OutNode);
         void inputData(NODE *parent, NODE **node, char *buf, uint32 length, bool sequneceIn);
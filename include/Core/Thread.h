@@ -37,8 +37,10 @@ namespace LimitEngine {
     class ThreadImpl
     {
     public:
-        static HANDLE CreateThread(Thread *thread, const ThreadParam &param);
+        static THREADHANDLE CreateThread(Thread *thread, const ThreadParam &param);
         static void Join(THREADHANDLE threadhandle);
+        static void Sleep(uint32 milliSecond);
+        static void YieldThread();
     };
     class Thread : public Object<LimitEngineMemoryCategory::Common>
     {
@@ -77,6 +79,15 @@ namespace LimitEngine {
             mFunc();
         }
 
+        // Sleep current thread
+        static void Sleep(uint32 milliSecond) {
+            ThreadImpl::Sleep(milliSecond);
+        }
+        // Give rest of time slice to other ready thread (returns at once if nothing to run)
+        static void YieldThread() {
+            ThreadImpl::YieldThread();
+        }
+
     private:
         ThreadFunction mFunc;
         THREADHANDLE mHandle;
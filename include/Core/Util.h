@@ -14,6 +14,7 @@
 #define _LE_UTIL_H_
 
 #include <string.h>
+#include <type_traits>
 
 #include <LEIntVector2.h>
 #include <LEFloatVector2.h>
@@ -115,6 +116,17 @@ namespace LimitEngine {
     {
         return (T&&)Obj;
     }
+
+    template <typename T>
+    typename RemoveReference<T>::Type&& Move(T &&Obj)
+    {
+        return (typename RemoveReference<T>::Type&&)Obj;
+    }
+
+    // Types that can be moved to other memory by memcpy (no move constructor / destructor call needed).
+    // Specialize for handle-like types that are not trivially copyable.
+    template <typename T>
+    struct IsTriviallyRelocatable { static constexpr bool Value = std::is_trivially_copyable<T>::value; };
 }
 
 #endif // _LE_UTIL_H_
\ No newline at end of file
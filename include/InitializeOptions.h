@@ -29,6 +29,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #include <LEIntVector2.h>
 
+#include "Core/FramePacer.h"
+
 namespace LimitEngine {
 struct InitializeOptions
 {
@@ -40,11 +42,17 @@ struct InitializeOptions
     LEMath::IntSize Resolution;
     ColorSpace SceneColorSpace;
     ColorSpace OutputColorSpace;
+    uint32 FrameLatency;            // Frames drawing thread may be behind game thread (1 ~ 3)
+    FramePacer::Mode FramePacing;   // Pacing of drawing thread
+    double FrameRate;               // Frames per second (FixedRate, Adaptive)
 
     explicit InitializeOptions(const LEMath::IntSize &InResolution, ColorSpace InSceneColorSpace, ColorSpace InOutputColorSpace)
         : Resolution(InResolution)
         , SceneColorSpace(InSceneColorSpace)
         , OutputColorSpace(InOutputColorSpace)
+        , FrameLatency(1u)
+        , FramePacing(FramePacer::Mode::FixedRate)
+        , FrameRate(60.0)
     {}
 };
 }
\ No newline at end of file
@@ -26,6 +26,9 @@
 #include "Core/Singleton.h"
 #include "Core/Thread.h"
 #include "Core/Util.h"
+#include "Core/FrameAllocator.h"
+#include "Core/FramePacer.h"
+#include "Containers/IntrusiveMPSCQueue.h"
 #include "Containers/VectorArray.h"
 #include "Renderer/DrawCommand.h"
 #include "Renderer/RenderState.h"
@@ -76,11 +79,20 @@ public:
 
 class RendererTask : public Object<LimitEngineMemoryCategory::Graphics>
 {
+    friend class DrawManager;
 public:
+    RendererTask() : mNextTask(nullptr) {}
     virtual ~RendererTask() {}
     virtual void Run() = 0;
 
     void Release() { delete this; }
+
+    // Run and deleted by the next DrawManager::Run (within a frame), so it can live in the frame area
+    void* operator new (size_t size) { return FrameAllocator::AllocObject(size, LimitEngineMemoryCategory::Graphics); }
+    void operator delete (void *data) { FrameAllocator::FreeObject(data); }
+
+private:
+    RendererTask *mNextTask;        // Link in queue of DrawManager
 };
 
 template<typename LAMBDA>
@@ -91,7 +103,6 @@ public:
 
     virtual void Run() override final {
         mLambda();
-        mLambda.~LAMBDA();
     }
 private:
     LAMBDA mLambda;
@@ -120,6 +131,25 @@ public:             // Public Definition
         float u, v;                // Texcoord
         uint32 color;            // Color (RGBA32)
     } VERTEX_DRAW2D;
+
+    // Frames the drawing thread may be behind the game thread (FrameAllocator keeps an area more than this)
+    static constexpr uint32 MaxFrameLatency = 3u;
+
+    // Frame fences and time spent waiting for them (Last* : last frame, Total* : since ResetFrameStatistics)
+    struct FrameStatistics
+    {
+        uint64 SubmittedFrames = 0u;            // Fence of last frame submitted by game thread
+        uint64 CompletedFrames = 0u;            // Fence of last frame flushed by drawing thread
+        uint32 FrameLatency = 0u;
+        uint32 PeakFramesInFlight = 0u;         // Most frames submitted and not flushed yet
+        uint64 LastGameThreadWaitUSec = 0u;     // Game thread waited for frame fence
+        uint64 TotalGameThreadWaitUSec = 0u;
+        uint64 MaxGameThreadWaitUSec = 0u;
+        uint64 LastDrawThreadWaitUSec = 0u;     // Drawing thread waited for submitted frame
+        uint64 TotalDrawThreadWaitUSec = 0u;
+        uint64 LastFlushUSec = 0u;              // Drawing thread flushed commands of frame
+        uint64 TotalFlushUSec = 0u;
+    };
     
 public:                    // Interfaces
     void Init(WINDOW_HANDLE handle, const InitializeOptions &Options);
@@ -134,21 +164,34 @@ public:                    // Interfaces
     // Is ready to rendering?
     bool IsReadyToRender() { return mReadyToRender; }
 
-    // Add renderer task (auto release)
-    void AddRendererTask(AutoPointer<RendererTask> &task) { Mutex::ScopedLock lock(mRendererTaskMutex); if (RendererTask *TaskPtr = task.Pop()) mRendererTasks.Add(TaskPtr); }
+    // Add renderer task (auto release). Any thread, without lock; tasks run in order of adding.
+    void AddRendererTask(AutoPointer<RendererTask> &task) { if (RendererTask *TaskPtr = task.Pop()) mRendererTasks.Push(TaskPtr); }
 
     template<typename L>
-    void AddRendererTaskLambda(L &&Lambda) { Mutex::ScopedLock lock(mRendererTaskMutex); mRendererTasks.Add(new RendererTaskLambda<L>(Forward<L>(Lambda))); }
+    void AddRendererTaskLambda(L &&Lambda) { mRendererTasks.Push(new RendererTaskLambda<L>(Forward<L>(Lambda))); }
 
     void PreRenderFinished()
     { /*if (mInstance && mInstance->mImpl) mInstance->mImpl->preRenderFinished();*/ }
 
     // Flush all commands (Multithread)
     void FlushCommandThread();
-    // Flush all commands
-    void FlushCommand();
-    // Wait for flushing commands
+    // Submit commands recorded until now as a frame to drawing thread. Returns fence of the frame.
+    uint64 FlushCommand();
+    // Wait until frames in flight are within frame latency
     void WaitForFlushing();
+    // Wait until commands of frame are flushed
+    void WaitForFrameFence(uint64 FrameFence);
+    uint64 GetCompletedFrameFence();
+
+    // Frames submitted and not flushed yet when game thread starts next frame (1 ~ MaxFrameLatency)
+    void SetFrameLatency(uint32 Latency);
+    uint32 GetFrameLatency() const { return mFrameLatency; }
+
+    FrameStatistics GetFrameStatistics();
+    void ResetFrameStatistics();
+
+    // Pacing of drawing thread (mode, rate and statistics of pacing error)
+    FramePacer& GetFramePacer() { return mFramePacer; }
 
     // Screen size
     void SetScreenOrientation(uint32 o);
@@ -212,12 +255,17 @@ private:            // Private Properties
 
     Thread                              *mDrawThread;                       //!< Thread for drawing. (Run commandbuffer)
     bool                                 mDrawThreadExitCode;               //!< Exit flag for drawing thread
-    Event                                mDrawEvent;                        //!< Event for flushing command buffer
-    Event                                mReadyCommandBufferEvent;          //!< Event about ready commandbuffer
+    Event                                mDrawEvent;                        //!< Event about submitted frame
+    Event                                mFrameCompletedEvent;              //!< Event about flushed frame
+
+    uint32                               mFrameLatency;                     //!< Frames drawing thread may be behind
+    uint64                               mSubmittedFrameFence;              //!< Fence of last submitted frame
+    uint64                               mCompletedFrameFence;              //!< Fence of last flushed frame
+    FrameStatistics                      mFrameStatistics;                  //!< Waiting for frame fences
+    Mutex                                mFrameFenceMutex;                  //!< Mutex for frame fences (and statistics)
+    FramePacer                           mFramePacer;                       //!< Start time of frames on drawing thread
 
-    Mutex                                mRendererTaskMutex;                //!< Mutex for running renderer tasks
-    Mutex                                mCommandFlushMutex;                //!< Mutex for flushing commands
-    VectorArray<RendererTask*>           mRendererTasks;                    //!< Task before flushing commands
+    IntrusiveMPSCQueue<RendererTask, &RendererTask::mNextTask> mRendererTasks; //!< Task before flushing commands
                                                                             
     bool                                 mInitialized;                      //!< Is drawmanager initialized?
     bool                                 mSceneBegan;                       //!< Is scene began?
@@ -235,7 +283,7 @@ private:            // Private Properties
 class DrawManagerRendererAccessor
 {
 public:
-    const explicit DrawManagerRendererAccessor(class DrawManager* manager)
+    explicit DrawManagerRendererAccessor(class DrawManager* manager)
         : mImpl(manager->mImpl)
         , mCommandBuffer(manager->mCommandBuffer)
     {}
@@ -268,7 +316,7 @@ private:
     CommandBuffer* mCommandBuffer = nullptr;
 };
 
-#define sDrawManager LimitEngine::DrawManager::GetSingletonPtr()
-#define LE_DrawManager LimitEngine::DrawManager::GetSingleton()
-#define LE_DrawManagerRendererAccessor DrawManagerRendererAccessor(LimitEngine::DrawManager::GetSingletonPtr())
+#define sDrawManager ::LimitEngine::DrawManager::GetSingletonPtr()
+#define LE_DrawManager ::LimitEngine::DrawManager::GetSingleton()
+#define LE_DrawManagerRendererAccessor DrawManagerRendererAccessor(::LimitEngine::DrawManager::GetSingletonPtr())
 }
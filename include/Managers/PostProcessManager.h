@@ -27,7 +27,7 @@ OTHER DEALINGS IN THE SOFTWARE.
 **********************************************************************/
 #pragma once
 
-#include <leRenderer>
+#include <LERenderer>
 
 #include "InitializeOptions.h"
 #include "Core/Singleton.h"
@@ -33,18 +33,21 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Core/Singleton.h"
 #include "Core/EventListener.h"
+#include "Core/FrameAllocator.h"
 #include "Core/ReferenceCountedPointer.h"
 #include "Core/Mutex.h"
 #include "Containers/VectorArray.h"
+#include "Renderer/BoundingVolumeHierarchy.h"
 #include "Renderer/Camera.h"
 #include "Renderer/ConstantBuffer.h"
+#include "Renderer/DrawList.h"
 #include "Renderer/Model.h"
 #include "Renderer/ModelInstance.h"
 #include "Renderer/Light.h"
 #include "Managers/TaskManager.h"
 #include "Managers/RenderTargetPoolManager.h"
 
-#define s_SceneManager LimitEngine::SceneManager::GetSingleton()
+#define s_SceneManager ::LimitEngine::SceneManager::GetSingleton()
 
 namespace LimitEngine {
 class Camera;
@@ -59,7 +62,8 @@ class SceneManager : public SingletonSceneManager
     static constexpr uint32 PendingDeleteRenderTargetCount = 0xfu;
 
 public:
-    struct SceneUpdateTask : public Object<LimitEngineMemoryCategory::Graphics>
+    // Consumed by the next Update, so allocated from the frame area
+    struct SceneUpdateTask : public FrameObject<LimitEngineMemoryCategory::Graphics>
     {
     public:
         virtual ~SceneUpdateTask() {}
@@ -71,6 +75,10 @@ public:
     ~SceneManager();
 
 	size_t          GetModelCount()				 { return mModels.size();}
+    uint32          GetVisibleModelCount() const    { return mVisibleModels.count(); }
+    void            SetFrustumCullingEnabled(bool b) { mFrustumCullingEnabled = b; }
+    // Draws and state changes of models in last Draw (all passes)
+    const DrawList::Statistics& GetDrawStatistics() const { return mDrawList.GetStatistics(); }
     uint32          AddModel(const ModelRefPtr &m);
     void            AddLight(const LightRefPtr &l);
     CameraRefPtr    GetCamera() const               { return mCamera; }
@@ -78,6 +86,12 @@ public:
 
     void UpdateModelTransform(uint32 InstanceID, const Transform &InTransform);
 
+    // Queries against world bounds of model instances (BVH of last Update)
+    // Nearest instance hit by ray (org to tar)
+    ModelInstRefPtr RayCastModels(const fRay &Ray, float *OutDistance = nullptr) const;
+    void FindModelsInSphere(const LEMath::FloatVector3 &Center, float Radius, VectorArray<ModelInstRefPtr> &OutModels) const;
+    void FindModelsInBox(const AABB &Box, VectorArray<ModelInstRefPtr> &OutModels) const;
+
     const PooledRenderTarget& GetSceneColor() const { return mSceneColor; }
     const PooledDepthStencil& GetSceneDepth() const { return mSceneDepth; }
     const PooledRenderTarget& GetSceneNormal() const { return mSceneNormal; }
@@ -105,24 +119,36 @@ public:
     }
 
     void AddModel_UpdateTask(Model *InModel, uint32 InID);
+    void UpdateModelTransform_UpdateTask(uint32 InstanceID, const Transform &InTransform);
     void AddLight_UpdateTask(Light *InLight);
     void SetCamera_UpdateTask(Camera *InCamera);
 
 private:
     void updateSceneTasks();
+    void updateModelBVH();
+    void buildVisibleModels();
     void drawBackground();
+    void drawModels(const RenderState &rs);
     void drawPrePass();
     PooledRenderTarget drawAmbientOcclusion();
     void drawBasePass();
     void drawTranslucencyPass();
 
-    ModelInstRefPtr findModelInstance(uint32 InstanceID);
+    uint32 findModelIndex(uint32 InstanceID) const;
 
 private:
     Mutex                               mUpdateSceneMutex;
 
     CameraRefPtr                        mCamera;
     VectorArray<ModelInstRefPtr>        mModels;
+    VectorArray<ModelInstance*>         mVisibleModels;         //!< Built once a frame by Update, drawn by all passes (kept alive by mModels)
+    bool                                mFrustumCullingEnabled;
+    mutable Mutex                       mModelBVHMutex;         //!< Queries from other threads
+    BoundingVolumeHierarchy             mModelBVH;              //!< Items are indices of mModels
+    VectorArray<uint32>                 mUnboundedModels;       //!< Not in mModelBVH (no bounds yet), always visible
+    VectorArray<uint32>                 mModelQueryResult;
+    bool                                mModelBVHDirty;
+    DrawList                            mDrawList;              //!< Draws of visible models, built and sorted for each pass
     VectorArray<LightRefPtr>            mLights;
     LightRefPtr                         mEnvironmentLight;
 
@@ -153,5 +179,5 @@ private:
     friend struct SceneUpdateTask;
     friend class SceneUpdateTask_UpdateModelTransform;
 };
-#define LE_SceneManager LimitEngine::SceneManager::GetSingleton()
+#define LE_SceneManager ::LimitEngine::SceneManager::GetSingleton()
 }
@@ -12,8 +12,9 @@
 #include "Containers/VectorArray.h"
 #include "Renderer/Shader.h"
 #include "Core/ReferenceCountedPointer.h"
+#include "Core/StringID.h"
 
-#define LE_ShaderManager LimitEngine::ShaderManager::GetSingleton()
+#define LE_ShaderManager ::LimitEngine::ShaderManager::GetSingleton()
 
 namespace LimitEngine {
 	class ShaderManager;
@@ -31,14 +32,19 @@ namespace LimitEngine {
 
         void LoadShaderSet(const char *filename);
         void AddShader(Shader *shader);
-        uint32 GetShaderID(const char *shaderName);
-        ShaderRefPtr GetShader(const char *name);
+        uint32 GetShaderID(const char *shaderName)      { return GetShaderID(StringID(shaderName)); }
+        uint32 GetShaderID(const StringID &shaderName);
+        ShaderRefPtr GetShader(const char *name)        { return GetShader(StringID(name)); }
+        ShaderRefPtr GetShader(const StringID &name);
         
     private:
         Shader* findshader(const ShaderHash& hash) const;
+        int32 findshader(const StringID &name) const;
+        void addshader(Shader *shader);
 
     private:
 		uint32						mShaderID;
         VectorArray<ShaderRefPtr>   mShaders;
+        VectorArray<StringID>       mShaderNames;       // Interned names of mShaders (same order)
     }; // ShaderManager
 }
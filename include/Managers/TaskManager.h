@@ -8,14 +8,42 @@
  *****************************************************************************/
 #pragma once
 
+#include <atomic>
+
+#include "Core/Event.h"
 #include "Core/Singleton.h"
 #include "Core/String.h"
 #include "Core/Function.h"
 #include "Core/Mutex.h"
 #include "Core/Thread.h"
+#include "Core/Util.h"
 #include "Containers/VectorArray.h"
 
 namespace LimitEngine {
+// Counter for waiting completion of jobs
+class TaskCounter
+{
+public:
+    TaskCounter() : mCount(0), mMutex(), mCompletedEvent(NULL, false, true) {}
+
+    void Add(int32 n) { Mutex::ScopedLock scopedLock(mMutex); mCount += n; }
+    void Done()
+    {
+        Mutex::ScopedLock scopedLock(mMutex);
+        LEASSERT(mCount > 0);
+        if (--mCount == 0)
+            mCompletedEvent.Signal();
+    }
+    bool IsDone() { Mutex::ScopedLock scopedLock(mMutex); return mCount == 0; }
+
+private:
+    int32   mCount;
+    Mutex   mMutex;
+    Event   mCompletedEvent;
+
+    friend class TaskManager;
+};
+
 class TaskManager;
 typedef Singleton<TaskManager, LimitEngineMemoryCategory::Common> SingletonTaskManager;
 class TaskManager : public SingletonTaskManager
@@ -33,16 +61,22 @@ private:			// Private Structure
 		uint32			reserved[1];			//                                          [ 4 ]
 	} TASK;		// [ 32 ]
 
+    typedef struct _JOB : public Object<LimitEngineMemoryCategory::Common>
+    {
+        Function<void>      func;                   //!<Function of job
+        class TaskCounter  *counter = nullptr;      //!<Counter notified when job is finished
+        virtual ~_JOB() {}
+    } JOB;
+
     template<typename L>
-    struct ParallelForTask : public TASK
+    struct ParallelForJob : public JOB
     {
-        ParallelForTask(L &&LambdaFunc, uint32 StepBegin, uint32 StepEnd) 
-            : mLambdaFunc(Forward<L>(LambdaFunc))
+        ParallelForJob(L &LambdaFunc, uint32 StepBegin, uint32 StepEnd)
+            : mLambdaFunc(LambdaFunc)
             , mStepBegin(StepBegin)
             , mStepEnd(StepEnd)
         {
-            func = ThreadFunction(this, &ParallelForTask::RunLambda);
-            transient = 1;
+            func = ThreadFunction(this, &ParallelForJob::RunLambda);
         }
 
         void RunLambda()
@@ -50,35 +84,74 @@ private:			// Private Structure
             mLambdaFunc(mStepBegin, mStepEnd);
         }
 
-        L mLambdaFunc;
+        L &mLambdaFunc;                 // Owned by caller of ParallelFor (waits until finished)
         uint32 mStepBegin;
         uint32 mStepEnd;
     };
 
-    class ParallelTask : public Object<LimitEngineMemoryCategory::Common>
+    template<typename L>
+    struct LambdaJob : public JOB
+    {
+        LambdaJob(L &&LambdaFunc)
+            : mLambdaFunc(Forward<L>(LambdaFunc))
+        {
+            func = ThreadFunction(this, &LambdaJob::RunLambda);
+        }
+
+        void RunLambda()
+        {
+            mLambdaFunc();
+        }
+
+        typename RemoveReference<L>::Type mLambdaFunc;
+    };
+
+    // Deque of jobs owned by one worker (owner uses back, thieves use front)
+    class JobQueue
     {
-        VectorArray<TASK*> mTasks;
+    public:
+        JobQueue() : mHead(0u), mCount(0u) {}
+
+        bool IsEmpty() const { return mCount.load(std::memory_order_relaxed) == 0u; }
+
+        void PushBack(JOB *job);
+        JOB* PopBack();
+        JOB* StealFront();
+
+    private:
+        void grow();
+
+        Mutex               mMutex;
+        VectorArray<JOB*>   mRing;
+        uint32              mHead;
+        std::atomic<uint32> mCount;
+    };
+
+    class WorkerThread : public Object<LimitEngineMemoryCategory::Common>
+    {
+        TaskManager *mOwner;
+        uint32 mIndex;
         Thread mThread;
-        bool mExitCode = false;
+        JobQueue mQueue;
     public:
-        ParallelTask() {}
-        virtual ~ParallelTask() {}
+        WorkerThread(TaskManager *Owner, uint32 Index) : mOwner(Owner), mIndex(Index) {}
+        virtual ~WorkerThread() {}
 
         inline bool IsRunning() const { return mThread.IsRunning(); }
-        inline bool IsIdle() const { return mTasks.count() == 0; }
+        inline JobQueue& GetQueue() { return mQueue; }
 
         void Init(const String &ThreadName);
         void Join();
-        void AddTask(TASK *task) { mTasks.Add(task); }
 
         void Run();
-
-        void Exit();
     };
     
 public:				// Public Definition
 	typedef uint32 TaskID;
-    static constexpr uint32 ParallelTaskCount = 5;
+    static constexpr uint32 ReservedThreadCount = 2u;          //!< MainTask + DrawCommand threads
+    static constexpr uint32 ParallelForBatchesPerWorker = 2u;   //!< Batches per worker for balancing ParallelFor
+    static constexpr uint32 ParallelSortThreshold = 4096u;      //!< Arrays smaller than this are sorted on calling thread
+    static constexpr uint32 TransientTaskInlineCount = 8u;      //!< Transient tasks removed per pass without allocation
 
 public:				// Public Functions
 	// ==================================================
@@ -115,40 +188,176 @@ public:				// Public Functions
 	void Init();
 	void Term();
 
+    uint32 GetWorkerCount() const { return mWorkers.count(); }
+
+    // Run job on worker threads. Counter (optional) is notified when job is finished.
+    template<typename L>
+    void AddJob(L &&Func, TaskCounter *Counter = nullptr) {
+        JOB *job = new LambdaJob<L>(Forward<L>(Func));
+        job->counter = Counter;
+        if (Counter) Counter->Add(1);
+        submitJob(job);
+    }
+
+    // Wait until counter becomes zero. Caller runs queued jobs while waiting.
+    void WaitForCounter(TaskCounter &Counter);
+
     template<typename L>
     void ParallelFor(uint32 LoopCount, L &&Func) {
-        VectorArray<ParallelTask*> idleParallels;
-        for (uint32 Index = 0; Index < ParallelTaskCount; Index++) {
-            if (mParallelThreads[Index]->IsIdle()) {
-                idleParallels.Add(mParallelThreads[Index]);
+        if (LoopCount == 0u)
+            return;
+
+        const uint32 batchCount = MIN(LoopCount, (mWorkers.count() + 1u) * ParallelForBatchesPerWorker);
+        TaskCounter counter;
+        counter.Add(static_cast<int32>(batchCount - 1u));
+        for (uint32 Index = 0; Index < batchCount - 1u; Index++) {
+            const uint32 stepBegin = static_cast<uint32>(static_cast<uint64>(LoopCount) * Index / batchCount);
+            const uint32 stepEnd = static_cast<uint32>(static_cast<uint64>(LoopCount) * (Index + 1u) / batchCount) - 1u;
+            JOB *job = new ParallelForJob<typename RemoveReference<L>::Type>(Func, stepBegin, stepEnd);
+            job->counter = &counter;
+            submitJob(job);
+        }
+        Func(static_cast<uint32>(static_cast<uint64>(LoopCount) * (batchCount - 1u) / batchCount), LoopCount - 1u);
+        WaitForCounter(counter);
+    }
+
+    // Sort chunks on workers then merge them pairwise (also on workers).
+    // Order of equal elements is not kept. Comp is same as VectorArray::Sort.
+    template<typename T, typename AllocatorT, typename Compare>
+    void ParallelSort(VectorArray<T, AllocatorT> &Array, Compare Comp) {
+        const uint32 count = Array.size();
+        if (count < ParallelSortThreshold || mWorkers.count() == 0u) {
+            Array.Sort(Comp);
+            return;
+        }
+
+        // Power of two chunks so that every merge pass pairs them up evenly
+        uint32 chunkCount = 1u;
+        while (chunkCount < mWorkers.count() + 1u)
+            chunkCount <<= 1;
+        T *data = Array.GetData();
+        auto chunkBegin = [count, chunkCount](uint32 chunkIndex) {
+            return static_cast<uint32>(static_cast<uint64>(count) * chunkIndex / chunkCount);
+        };
+
+        ParallelFor(chunkCount, [&](uint32 stepBegin, uint32 stepEnd) {
+            for (uint32 chunkIndex = stepBegin; chunkIndex <= stepEnd; chunkIndex++) {
+                SortAlgorithm::Sort(data + chunkBegin(chunkIndex), data + chunkBegin(chunkIndex + 1u), Comp);
             }
+        });
+
+        T *buffer = (T*)malloc(sizeof(T) * count);
+        for (uint32 width = 1u; width < chunkCount; width <<= 1) {
+            ParallelFor(chunkCount / (width * 2u), [&](uint32 stepBegin, uint32 stepEnd) {
+                for (uint32 pairIndex = stepBegin; pairIndex <= stepEnd; pairIndex++) {
+                    const uint32 first = chunkBegin(pairIndex * width * 2u);
+                    const uint32 mid = chunkBegin(pairIndex * width * 2u + width);
+                    const uint32 last = chunkBegin((pairIndex + 1u) * width * 2u);
+                    SortAlgorithm::MergeSortedRuns(data + first, data + mid, data + last, buffer + first, Comp);
+                }
+            });
+        }
+        free(buffer);
+    }
+
+    // LSD radix sort by 64bit key (SortAlgorithm::RadixSort), GetKey(const T&) returns uint64. Stable.
+    // Each chunk counts and scatters its elements on workers, offsets of chunks are summed up on calling thread.
+    template<typename T, typename AllocatorT, typename KeyFunc>
+    void ParallelRadixSort(VectorArray<T, AllocatorT> &Array, KeyFunc GetKey) {
+        const uint32 count = Array.size();
+        if (count < 2u)
+            return;
+        T *buffer = (T*)malloc(sizeof(T) * count);
+        if (count < ParallelSortThreshold || mWorkers.count() == 0u) {
+            SortAlgorithm::RadixSort(Array.GetData(), Array.GetData() + count, buffer, GetKey);
+            free(buffer);
+            return;
         }
 
-        uint32 step = max(1, LoopCount / (idleParallels.count() + 1));
-        uint32 currentLoopNum = 0u;
-        uint32 usedParallelTaskCount = 0u;
-        for (uint32 Index = 0; Index < idleParallels.count(); Index++, usedParallelTaskCount++) {
-            idleParallels[Index]->AddTask(new ParallelForTask<L>(Forward<L>(Func), currentLoopNum, currentLoopNum + step - 1));
-            currentLoopNum += step;
-            if (currentLoopNum >= LoopCount) {
-                usedParallelTaskCount++;
-                break;
+        typedef uint32 Histogram[SortAlgorithm::RadixBucketCount];
+        const uint32 chunkCount = mWorkers.count() + 1u;
+        auto chunkBegin = [count, chunkCount](uint32 chunkIndex) {
+            return static_cast<uint32>(static_cast<uint64>(count) * chunkIndex / chunkCount);
+        };
+        // Histograms of all digits at once to find digits to skip, then [chunk] for current digit
+        Histogram *histograms = (Histogram*)malloc(sizeof(Histogram) * SortAlgorithm::RadixDigitCount * chunkCount);
+        ::memset(histograms, 0, sizeof(Histogram) * SortAlgorithm::RadixDigitCount * chunkCount);
+
+        T *source = Array.GetData();
+        T *destination = buffer;
+        ParallelFor(chunkCount, [&](uint32 stepBegin, uint32 stepEnd) {
+            for (uint32 chunkIndex = stepBegin; chunkIndex <= stepEnd; chunkIndex++) {
+                Histogram *chunkHistograms = histograms + chunkIndex * SortAlgorithm::RadixDigitCount;
+                for (uint32 index = chunkBegin(chunkIndex); index < chunkBegin(chunkIndex + 1u); index++) {
+                    const uint64 key = GetKey(source[index]);
+                    for (uint32 digit = 0u; digit < SortAlgorithm::RadixDigitCount; digit++)
+                        chunkHistograms[digit][SortAlgorithm::GetRadixBucket(key, digit)]++;
+                }
             }
+        });
+        bool sortDigits[SortAlgorithm::RadixDigitCount];
+        const uint64 firstKey = GetKey(source[0]);
+        for (uint32 digit = 0u; digit < SortAlgorithm::RadixDigitCount; digit++) {
+            const uint32 bucket = SortAlgorithm::GetRadixBucket(firstKey, digit);
+            uint32 bucketCount = 0u;
+            for (uint32 chunkIndex = 0u; chunkIndex < chunkCount; chunkIndex++)
+                bucketCount += histograms[chunkIndex * SortAlgorithm::RadixDigitCount + digit][bucket];
+            sortDigits[digit] = bucketCount != count;
         }
-        if (currentLoopNum < LoopCount)
-            Func(currentLoopNum, static_cast<uint32>(LoopCount - 1));
-        while (1) {
-            bool bAllClear = true;
-            for (uint32 Index = 0; Index < usedParallelTaskCount; Index++) {
-                bAllClear &= idleParallels[Index]->IsIdle();
+
+        bool firstPass = true;
+        for (uint32 digit = 0u; digit < SortAlgorithm::RadixDigitCount; digit++) {
+            if (sortDigits[digit] == false)
+                continue;
+            // Chunks of first pass are counted already, others have to be counted again after scatter
+            if (firstPass) {
+                for (uint32 chunkIndex = 0u; chunkIndex < chunkCount; chunkIndex++)
+                    ::memmove(histograms[chunkIndex], histograms[chunkIndex * SortAlgorithm::RadixDigitCount + digit], sizeof(Histogram));
+                firstPass = false;
+            }
+            else {
+                ParallelFor(chunkCount, [&](uint32 stepBegin, uint32 stepEnd) {
+                    for (uint32 chunkIndex = stepBegin; chunkIndex <= stepEnd; chunkIndex++) {
+                        uint32 *histogram = histograms[chunkIndex];
+                        ::memset(histogram, 0, sizeof(Histogram));
+                        for (uint32 index = chunkBegin(chunkIndex); index < chunkBegin(chunkIndex + 1u); index++)
+                            histogram[SortAlgorithm::GetRadixBucket(GetKey(source[index]), digit)]++;
+                    }
+                });
             }
-            if (bAllClear) break;
+            // Bucket major, chunk minor offsets keep order of equal keys
+            uint32 offset = 0u;
+            for (uint32 bucket = 0u; bucket < SortAlgorithm::RadixBucketCount; bucket++) {
+                for (uint32 chunkIndex = 0u; chunkIndex < chunkCount; chunkIndex++) {
+                    const uint32 bucketCount = histograms[chunkIndex][bucket];
+                    histograms[chunkIndex][bucket] = offset;
+                    offset += bucketCount;
+                }
+            }
+            ParallelFor(chunkCount, [&](uint32 stepBegin, uint32 stepEnd) {
+                for (uint32 chunkIndex = stepBegin; chunkIndex <= stepEnd; chunkIndex++) {
+                    uint32 *offsets = histograms[chunkIndex];
+                    for (uint32 index = chunkBegin(chunkIndex); index < chunkBegin(chunkIndex + 1u); index++)
+                        destination[offsets[SortAlgorithm::GetRadixBucket(GetKey(source[index]), digit)]++] = source[index];
+                }
+            });
+            T *swapped = source;
+            source = destination;
+            destination = swapped;
         }
+        if (source != Array.GetData())
+            ::memcpy(Array.GetData(), source, sizeof(T) * count);
+        free(histograms);
+        free(buffer);
     }
 
     void Run();
 private:			// Private Functions
     void runTasks();
+    void submitJob(JOB *job);
+    JOB* findJob(int32 workerIndex);
+    bool runOneJob(int32 workerIndex);
+    void workerLoop(uint32 workerIndex);
     TaskID getIDfromName(const char *name);
     TaskID addTask(TASK *task);
 	void removeTask(TaskID id);
@@ -163,7 +372,15 @@ private:			// Private Members
     Mutex                        mMutex;                   //!< Mutex
     Thread                      *mWorkThread;              //!< Thread for run tasks
     bool                         mWorkThreadExitCode;      //!< Exitcode for work thread
-    ParallelTask                *mParallelThreads[ParallelTaskCount];           //!< Thread for parallel
+
+    VectorArray<WorkerThread*>   mWorkers;                 //!< Worker threads for jobs
+    Event                        mWorkerWakeEvent;         //!< Event for waking parked workers
+    std::atomic<uint32>          mPendingJobCount;         //!< Count of jobs in queues
+    std::atomic<uint32>          mSleepingWorkerCount;     //!< Count of parked workers
+    std::atomic<uint32>          mSubmitQueueIndex;        //!< Round-robin queue index for non-worker threads
+    std::atomic<bool>            mWorkerExitCode;          //!< Exitcode for worker threads
+
+    static thread_local int32    sWorkerIndex;             //!< Index of worker running on this thread (-1 : not worker)
 };
 #define LE_TaskManager TaskManager::GetSingleton()
 }
@@ -0,0 +1,75 @@
+/***********************************************************
+ LIMITEngine Header File
+ Copyright (C), LIMITGAME, 2020
+ -----------------------------------------------------------
+ @file  Platform_Linux.h
+ @brief Definitions for platform (Linux, POSIX)
+ @author minseob (https://github.com/rasidin)
+ ***********************************************************/
+#pragma once
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef pthread_t THREADHANDLE;
+
+#ifdef _DEBUG
+#define DEBUG_MESSAGE(str, ...) { fprintf(stderr, str, ##__VA_ARGS__); }
+#else
+#define DEBUG_MESSAGE(str, ...)
+#endif
+
+// No window (headless)
+#define WINDOW_HANDLE void*
+struct EventHandle_Linux;
+#define EVENT_HANDLE EventHandle_Linux*
+
+typedef unsigned int frame_time;
+typedef uintptr_t uint_ptr;
+typedef uint64_t uint64;
+typedef int64_t int64;
+typedef uint32_t uint32;
+typedef int32_t int32;
+typedef uint16_t uint16;
+typedef int16_t int16;
+typedef uint8_t uint8;
+typedef int8_t int8;
+
+#ifndef LITTLE_ENDIAN
+#define LITTLE_ENDIAN
+#endif
+
+// Functions of CRT (Windows) used by engine
+inline int vsprintf_s(char *buffer, size_t size, const char *format, va_list args)
+{
+    return vsnprintf(buffer, size, format, args);
+}
+inline int sprintf_s(char *buffer, size_t size, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const int result = vsnprintf(buffer, size, format, args);
+    va_end(args);
+    return result;
+}
+template<size_t Size>
+inline int sprintf_s(char (&buffer)[Size], const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const int result = vsnprintf(buffer, Size, format, args);
+    va_end(args);
+    return result;
+}
+#define _strdup strdup
+inline int fopen_s(FILE **fp, const char *filename, const char *mode)
+{
+    *fp = fopen(filename, mode);
+    return *fp ? 0 : errno;
+}
@@ -27,7 +27,7 @@ OTHER DEALINGS IN THE SOFTWARE.
 **********************************************************************/
 #pragma once
 
-#include <LeRenderer>
+#include <LERenderer>
 #include <LEFloatVector2.h>
 
 #include "PostProcessor.h"
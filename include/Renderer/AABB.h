@@ -35,6 +35,8 @@ namespace LimitEngine {
         }
         
         bool IsIn(const LEMath::FloatVector3 &v) { if (minimum < v && maximum > v) return true; return false; }
+        // Has at least one point merged
+        bool IsValid() const { return minimum.X() <= maximum.X() && minimum.Y() <= maximum.Y() && minimum.Z() <= maximum.Z(); }
         INTERSECT_RESULT Intersect(const fRay &r);
         
 		LEMath::FloatVector3 GetNormal(const LEMath::FloatVector3 &v);
@@ -58,6 +60,8 @@ namespace LimitEngine {
             output.minimum = (LEMath::FloatVector3)m.Translate(LEMath::FloatVector4(minimum).SetW(1.0f));
             return output;
         }
+        // Box bounding all 8 transformed corners (v * m, row vectors)
+        AABB TransformBounds(const LEMath::FloatMatrix4x4 &m) const;
         
         LEMath::FloatVector3 maximum;
         LEMath::FloatVector3 minimum;
@@ -0,0 +1,141 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  BoundingVolumeHierarchy.h
+@brief Bounding volume hierarchy over boxes (culling / ray / overlap queries)
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#ifndef LIMITENGINEV2_BOUNDINGVOLUMEHIERARCHY_H_
+#define LIMITENGINEV2_BOUNDINGVOLUMEHIERARCHY_H_
+
+#include <LEFloatVector3.h>
+
+#include "Core/Common.h"
+#include "Containers/SmallVectorArray.h"
+#include "Containers/VectorArray.h"
+#include "Renderer/AABB.h"
+#include "Renderer/FRay.h"
+
+namespace LimitEngine {
+class Frustum;
+// Binary tree of boxes built by binned SAH.
+// Items are indices of the box array given to Build (boxes that are not valid are left out).
+// Moving items are refitted by Update. Tree gets worse by refits, so rebuild if NeedsRebuild.
+class BoundingVolumeHierarchy
+{
+public:
+    static constexpr uint32 InvalidIndex = 0xffffffffu;
+    static constexpr uint32 MaxLeafItemCount = 4u;
+
+    struct RayHit
+    {
+        uint32 Item = InvalidIndex;
+        float  Distance = 0.0f;         // From origin of ray (0 if origin is in box)
+    };
+
+    BoundingVolumeHierarchy();
+
+    void Build(const AABB *Boxes, uint32 Count);
+    void Clear();
+
+    // Refit for new box of item. Returns false if item is not in tree (has to be rebuilt).
+    bool Update(uint32 Item, const AABB &Box);
+    // Refitted tree is much worse than built one
+    bool NeedsRebuild() const;
+
+    bool   IsEmpty() const          { return mNodes.count() == 0u; }
+    uint32 GetItemCount() const     { return mItems.count(); }
+    uint32 GetNodeCount() const     { return mNodes.count(); }
+    // Surface area heuristic of tree relative to root (cost of traversal)
+    float  GetCost() const;
+
+    // Items with box intersecting frustum (planes made by Frustum::UpdatePlanes)
+    void QueryFrustum(const Frustum &InFrustum, VectorArray<uint32> &OutItems) const;
+    // Items with box overlapping box
+    void QueryBox(const AABB &Box, VectorArray<uint32> &OutItems) const;
+    // Items with box overlapping sphere
+    void QuerySphere(const LEMath::FloatVector3 &Center, float Radius, VectorArray<uint32> &OutItems) const;
+    // Nearest item with box hit by ray (org to tar)
+    bool RayCast(const fRay &Ray, RayHit &OutHit) const;
+
+private:
+    struct Bounds
+    {
+        float Min[3];
+        float Max[3];
+
+        void SetEmpty()                     { Min[0] = Min[1] = Min[2] = FLT_MAX; Max[0] = Max[1] = Max[2] = -FLT_MAX; }
+        void Merge(const Bounds &b)
+        {
+            for (int axis = 0; axis < 3; axis++) {
+                Min[axis] = (Min[axis] < b.Min[axis]) ? Min[axis] : b.Min[axis];
+                Max[axis] = (Max[axis] > b.Max[axis]) ? Max[axis] : b.Max[axis];
+            }
+        }
+        float GetHalfArea() const
+        {
+            const float x = Max[0] - Min[0], y = Max[1] - Min[1], z = Max[2] - Min[2];
+            return x * y + y * z + z * x;
+        }
+        bool operator == (const Bounds &b) const
+        {
+            return Min[0] == b.Min[0] && Min[1] == b.Min[1] && Min[2] == b.Min[2] && Max[0] == b.Max[0] && Max[1] == b.Max[1] && Max[2] == b.Max[2];
+        }
+    };
+    struct Node
+    {
+        Bounds Box;
+        uint32 Parent;
+        uint32 Child;           // Left child (right is Child + 1), InvalidIndex for leaf
+        uint32 ItemBegin;       // Items of subtree are mItems[ItemBegin, ItemBegin + ItemCount)
+        uint32 ItemCount;
+
+        bool IsLeaf() const { return Child == InvalidIndex; }
+    };
+
+    struct BuildItem
+    {
+        Bounds Box;
+        float  Centroid[3];
+        uint32 Item;
+    };
+
+    uint32 splitItems(uint32 Begin, uint32 End, const Bounds &CentroidBounds);
+    void   refitNode(uint32 NodeIndex);
+    static float getNodeCost(const Node &InNode);
+    void   addItems(const Node &InNode, VectorArray<uint32> &OutItems) const;
+
+private:
+    VectorArray<Node>       mNodes;         // Root is mNodes[0]
+    VectorArray<uint32>     mItems;         // Items in order of leaves
+    VectorArray<Bounds>     mItemBounds;    // Box of item (in order of leaves, same as mItems)
+    VectorArray<uint32>     mItemSlots;     // Index of item in mItems (by item, InvalidIndex if not in tree)
+    VectorArray<uint32>     mItemLeaves;    // Leaf node of item (by item)
+    VectorArray<BuildItem>  mBuildItems;    // Temporary of Build
+    float                   mAreaSum;       // Sum of node costs (kept by refits)
+    float                   mBuiltCost;     // GetCost on Build
+    uint32                  mUpdateCount;   // Refits since Build
+};
+} // namespace LimitEngine
+
+#endif // LIMITENGINEV2_BOUNDINGVOLUMEHIERARCHY_H_
@@ -53,6 +53,8 @@ namespace LimitEngine {
         virtual float GetFovRadians() const                             { if(mFrustum) return mFrustum->GetFOVRadians(); return DefaultFOVRadians; }
         // Get view matrix
         const LEMath::FloatMatrix4x4& GetViewMatrix() const             { return mViewMatrix; }
+        // Get frustum (planes for culling)
+        Frustum* GetFrustum() const                                     { return mFrustum; }
         // Get projection matrix
         LEMath::FloatMatrix4x4  GetProjectionMatrix()                   { if(mFrustum) return mFrustum->GetProjectionMatrix(); return LEMath::FloatMatrix4x4::Identity; }
 
@@ -16,6 +16,7 @@ Copyright (C), LIMITGAME, 2020
 #include <LEIntVector4.h>
 
 #include "Core/Singleton.h"
+#include "Core/Util.h"
 #include "Core/Mutex.h"
 #include "Core/ReferenceCountedPointer.h"
 
@@ -61,6 +62,8 @@ public:
     virtual void Dispatch(int X, int Y, int Z) = 0;
     virtual void DrawPrimitive(uint32 Primitive, uint32 Offset, uint32 Count) = 0;
     virtual void DrawIndexedPrimitive(uint32 Primitive, uint32 VertexCount, uint32 Count) = 0;
+    // InstanceData (InstanceCount * InstanceStride bytes) is valid only in this call, it's bound to vertex slot 1
+    virtual void DrawIndexedInstanced(uint32 Primitive, uint32 IndexCount, uint32 InstanceCount, const void *InstanceData, uint32 InstanceStride) = 0;
     virtual void SetRenderTarget(uint32 Index, const TextureRendererAccessor &Color, const TextureRendererAccessor &Depth, uint32 SurfaceIndex) = 0;
     virtual void CopyResource(void* Dst, uint32 DstOffset, void* Org, uint32 OrgOffset, uint32 Size) = 0;
     virtual void ResourceBarrier(void* Resource, const ResourceState& Before, const ResourceState& After) = 0;
@@ -68,15 +71,25 @@ public:
     virtual void BeginEvent(const char *InEventName) = 0;
     virtual void EndEvent() = 0;
 };
+class CommandSegment;
 class CommandBuffer : public Object<LimitEngineMemoryCategory::Graphics>
 {
     friend DrawManager;
     friend DrawCommand;
+    friend CommandSegment;
 private:            // Private Definitions
-    static const uint32 CommandReservedMemorySize = 1 * (1 << 20); // 1MB
+    static const uint32 CommandReservedMemorySize = 1 * (1 << 20); // 1MB (Pages made at start)
+    static const uint32 CommandPageSize = 64 * (1 << 10);           // 64KB (Page of command memory, larger commands get own page)
+    static const uint32 SegmentChunkSize = 64 * (1 << 10);         // 64KB (Chunk of CommandSegment)
+    static const uint32 ShadowSlotCount = 16u;                      // Slots of constant buffers / textures / samplers tracked by shadow state
+    static const uint32 CommandAlignment = 16u;                     // Commands (and data following them) are packed at this boundary
+    static const uint32 CommandSizeLimit = 1u << 24;                // Commands (with data) have to be smaller (24bit commandSize)
+    static_assert(CommandPageSize < CommandSizeLimit, "Rest of page skipped by NextPage has to fit in commandSize");
 
 private:            // Private Structure
                     // Render command list
+                    // Commands are packed one after another with their own size (no padding to fixed slot, no vtable),
+                    // data of command (constant buffer, marker name) follows the command in the same stream.
     typedef struct _COMMAND_COMMON
     {
         enum Commands
@@ -99,6 +112,7 @@ private:            // Private Structure
             cDispatch,
             cDrawPrimitive,
             cDrawIndexedPrimitive,
+            cDrawIndexedInstanced,
             cSetPipelineState,
             cUpdateConstantBuffer,
             cSetConstantBuffer,
@@ -107,23 +121,17 @@ private:            // Private Structure
             cSetMarker,
             cBeginEvent,
             cEndEvent,
+            cExecuteSegment,
+            cNextPage,
             CommandNum,
         };
-        uint16       commandType;               //!<Type of command                  [ 2 ]
-        uint16       nextOffset;                // Offset to next command            [ 2 ]
+        uint32       commandType : 8;           //!<Type of command                  [ 1 ]
+        uint32       commandSize : 24;          // Bytes to next command (with data) [ 3 ]
 
-        _COMMAND_COMMON() : nextOffset(1) {}
-        _COMMAND_COMMON(uint16 t) : commandType(t), nextOffset(1) {}
-        _COMMAND_COMMON(uint16 t, uint16 o) : commandType(t), nextOffset(o) {}
-
-        virtual size_t GetSize() const { return 64u; } // Get Command Size
+        _COMMAND_COMMON(uint32 t) : commandType(t), commandSize(0u) {}
     } COMMAND_COMMON;    // [ 4 ]
+    static_assert(COMMAND_COMMON::CommandNum <= (1u << 8), "Command type doesn't fit in header");
 
-    // Empty command
-    typedef struct _COMMAND : public _COMMAND_COMMON
-    {
-        char                data[44];        //!<Data of command                    [ 44 ]
-    } COMMAND;    // [ 64 | 64 ]
     // Begin scene
     typedef struct _COMMAND_BEGINSCENE : public _COMMAND_COMMON
     {
@@ -257,17 +265,15 @@ private:            // Private Structure
     // Upload constant buffer using local cpu memory
     typedef struct _COMMAND_UPDATECONSTANTBUFFER : public _COMMAND_COMMON
     {
-        _COMMAND_UPDATECONSTANTBUFFER(ConstantBuffer* cb, void* dt, size_t sz)
+        _COMMAND_UPDATECONSTANTBUFFER(ConstantBuffer* cb, uint32 sz)
             : _COMMAND_COMMON(cUpdateConstantBuffer)
-            , buffer(cb)
-            , data(dt)
             , size(sz)
+            , buffer(cb)
         {
             cb->AddReferenceCounter();
         }
+        uint32 size;                                // Data follows command
         ConstantBuffer* buffer;
-        void* data;
-        size_t size;
     } COMMAND_UPDATECONSTANTBUFFER;
     // Set constant buffer
     typedef struct _COMMAND_SETCONSTANTBUFFER : public _COMMAND_COMMON
@@ -321,6 +327,21 @@ private:            // Private Structure
         uint32               vtxcount;
         uint32                 count;
     } COMMAND_DRAWINDEXEDPRIMITIVE;
+    // Draw indexed primitive for each instance
+    typedef struct _COMMAND_DRAWINDEXEDINSTANCED : public _COMMAND_COMMON
+    {
+        _COMMAND_DRAWINDEXEDINSTANCED(RendererFlag::PrimitiveTypes t, uint32 c, uint32 ic, uint32 is)
+            : _COMMAND_COMMON(cDrawIndexedInstanced)
+            , primitive(static_cast<uint32>(t))
+            , count(c)
+            , instancecount(ic)
+            , instancestride(is)
+        {}
+        uint32              primitive;
+        uint32              count;
+        uint32              instancecount;
+        uint32              instancestride;     // Data of instances follows command
+    } COMMAND_DRAWINDEXEDINSTANCED;
     // Set render target for drawing
     typedef struct _COMMAND_SETRENDERTARGET : public _COMMAND_COMMON
     {
@@ -381,19 +402,17 @@ private:            // Private Structure
     } COMMAND_RESOURCEBARRIER;
     typedef struct _COMMAND_SETMARKER : public _COMMAND_COMMON
     {
-        _COMMAND_SETMARKER(char *InMarkerName)
+        _COMMAND_SETMARKER()
             : _COMMAND_COMMON(cSetMarker)
-            , MarkerName(InMarkerName)
         {}
-        char                *MarkerName;
+        // Name follows command
     } COMMAND_SETMARKER;
     typedef struct _COMMAND_BEGINEVENT : public _COMMAND_COMMON
     {
-        _COMMAND_BEGINEVENT(char *InEventName)
+        _COMMAND_BEGINEVENT()
             : _COMMAND_COMMON(cBeginEvent)
-            , EventName(InEventName)
         {}
-        char               *EventName;
+        // Name follows command
     } COMMAND_BEGINEVENT;
     typedef struct _COMMAND_ENDEVENT : public _COMMAND_COMMON
     {
@@ -407,6 +426,49 @@ private:            // Private Structure
             : _COMMAND_COMMON(cPresent)
         {}
     } COMMAND_PRESENT;
+    // Run commands recorded to segment
+    typedef struct _COMMAND_EXECUTESEGMENT : public _COMMAND_COMMON
+    {
+        _COMMAND_EXECUTESEGMENT(CommandSegment *s)
+            : _COMMAND_COMMON(cExecuteSegment)
+            , segment(s)
+        {}
+        CommandSegment     *segment;
+    } COMMAND_EXECUTESEGMENT;
+    // Rest of page is skipped (next command didn't fit in page)
+    typedef struct _COMMAND_NEXTPAGE : public _COMMAND_COMMON
+    {
+        _COMMAND_NEXTPAGE()
+            : _COMMAND_COMMON(cNextPage)
+        {}
+    } COMMAND_NEXTPAGE;
+public:
+    // Counters of recording (since last ResetRecordingStatistics)
+    struct RecordingStatistics
+    {
+        uint32 RecordedCommands = 0u;       // Commands written to buffer
+        uint32 RecordedBytes = 0u;          // Bytes of commands written to buffer (with their data)
+        uint32 ElidedCommands = 0u;         // Binds dropped because the state was already bound
+        uint32 ElidedPipelineStates = 0u;
+        uint32 ElidedVertexBuffers = 0u;
+        uint32 ElidedIndexBuffers = 0u;
+        uint32 ElidedConstantBuffers = 0u;
+        uint32 ElidedTextures = 0u;
+        uint32 ElidedSamplers = 0u;
+    };
+    // Usage of command memory (pages are pooled, and grow if recording runs ahead of flushing)
+    struct MemoryStatistics
+    {
+        uint32 PageCount = 0u;              // Pages made by buffer (in use + pooled)
+        uint32 PagesInUse = 0u;             // Pages holding commands that are not flushed yet
+        uint32 PeakPagesInUse = 0u;
+        size_t BytesInUse = 0u;
+        size_t FrameHighWaterBytes = 0u;    // Most memory held by pages in use while recording this frame
+        size_t LastFrameHighWaterBytes = 0u;
+        uint32 PageSwitches = 0u;           // Recording moved to next page
+        uint32 PageGrowths = 0u;            // New pages made because every pooled page was waiting for flush
+        uint32 OversizedCommands = 0u;      // Commands larger than page (recorded to own page)
+    };
 public:
     // Ctor & Dtor
     CommandBuffer(size_t bufferSize = CommandReservedMemorySize);
@@ -422,31 +484,166 @@ public:
     void Finalize(uint64 CompletedFenceIndex) const { mImpl->Finalize(CompletedFenceIndex); }
     void ProcessAfterPresent() const { mImpl->ProcessAfterPresent(); }
 
-    uint32 CalculateCommandOffset(COMMAND *cmd);
+    // Commands recorded until now make a frame. Frames are flushed by FlushFrame in the order of marking,
+    // so recording of next frames can go on while they are flushed.
+    void MarkFrameEnd();
+    // Flush commands of oldest marked frame (false if there is no marked frame)
+    bool FlushFrame(RenderState *rs);
+    // Resources released by flushed commands can be deleted after the frame is flushed (called by drawing thread)
+    void RetireRendererResources();
+
+    // Drop binds that don't change bound state while recording (disable for debugging)
+    void SetRedundantStateElimination(bool Enabled);
+    bool IsRedundantStateElimination() const { return mRecording.RedundantStateElimination; }
+
+    RecordingStatistics GetRecordingStatistics();
+    void ResetRecordingStatistics();
 
-    void SetCommand(COMMAND_COMMON *cmd);
-    void AddCommand(COMMAND_COMMON *cmd);
+    // Counters are reset, gauges (page count, pages in use) are kept
+    MemoryStatistics GetMemoryStatistics();
+    void ResetMemoryStatistics();
 
-    void LockWriteCommandBuffer() { mMutex.Lock(); }
-    void Flush(RenderState *rs);
+    // Segment for recording commands by other thread (reused after its commands are flushed)
+    CommandSegment* AcquireSegment();
+    // Stitch segments into command stream in the order of array. Empty segments are released here.
+    void SubmitSegments(CommandSegment **Segments, uint32 Count);
+    // Commands of this thread are recorded to segment (nullptr : command buffer)
+    static void SetRecordingSegment(CommandSegment *Segment) { sRecordingSegment = Segment; }
+    static CommandSegment* GetRecordingSegment() { return sRecordingSegment; }
 private:
-    void* allocateFromCommandBuffer(size_t size);
-    void* copyDataToGPUBuffer(void *data, size_t size);
-    void* duplicateBuffer(void* data, size_t size);
-    float* copyMatrixToBuffer(float *ptr);
-    char* duplicateString(const char *src);
-
-    COMMAND* popPushCommandBuffer();
-    COMMAND* nextPushCommandBuffer(int count = 1);
-    COMMAND* nextPullCommandBuffer();
+    // Resources bound to slots (ValidMask has a bit for each known slot)
+    struct ShadowSlots
+    {
+        const void *Resources[ShadowSlotCount];
+        uint32      ValidMask;
+    };
+    // State bound by recorded commands. It follows the backend: pipeline state / buffers are kept until they are changed,
+    // constant buffers / textures / samplers until pipeline state is changed, and everything is reset at scene begin / end and present.
+    // Resources are compared by pointer, so they have to live until the frame is presented (commands keep reference until flushing).
+    struct ShadowState
+    {
+        const void     *PipelineState;
+        const void     *VertexBuffer;
+        const void     *IndexBuffer;
+        ShadowSlots     ConstantBuffers;
+        ShadowSlots     Textures;
+        ShadowSlots     Samplers;
+
+        void ClearSlots()
+        {
+            ConstantBuffers.ValidMask = 0u;
+            Textures.ValidMask = 0u;
+            Samplers.ValidMask = 0u;
+        }
+        void Clear()
+        {
+            PipelineState = nullptr;
+            VertexBuffer = nullptr;
+            IndexBuffer = nullptr;
+            ClearSlots();
+        }
+    };
+    // Shadow state and counters of command buffer or segment
+    struct RecordingContext
+    {
+        ShadowState             Shadow;
+        RecordingStatistics     Statistics;
+        bool                    RedundantStateElimination;
+
+        void Reset(bool InRedundantStateElimination)
+        {
+            Shadow.Clear();
+            Statistics = RecordingStatistics();
+            RedundantStateElimination = InRedundantStateElimination;
+        }
+    };
+    // Recording context of this thread (locks mMutex when recording to command buffer)
+    struct RecordingTarget;
+
+    // Update shadow state by bind. Returns false if the bind is redundant and its command has to be elided.
+    bool shadowPipelineState(PipelineState *pso);
+    bool shadowVertexBuffer(VertexBufferGeneric *vb);
+    bool shadowIndexBuffer(IndexBuffer *ib);
+    bool shadowConstantBuffer(uint32 Index, ConstantBuffer *cb);
+    bool shadowTexture(uint32 Index, TextureInterface *tex);
+    bool shadowSampler(uint32 Index, SamplerState *sampler);
+    // Slot is bound by resource that can't be compared (pooled render target)
+    void invalidateShadowTexture(uint32 Index);
+    void resetShadowState();
+
+    static bool shadowBinding(RecordingContext &Context, const void *&Bound, const void *Resource, uint32 &ElidedCount);
+    static bool shadowBinding(RecordingContext &Context, ShadowSlots &Slots, uint32 Index, const void *Resource, uint32 &ElidedCount);
+
+    // Function of each command type (Flush decodes commands by table of them)
+    struct CommandExecutor;
+    void executeCommand(COMMAND_COMMON *cmd, RenderState *rs, Texture *nullTexture);
+    void releaseSegment(CommandSegment *Segment);
+
+    // Record command of type T (its size is set after construction)
+    template<typename T, typename... Args>
+    T* recordCommand(Args&&... args)
+    {
+        static_assert(alignof(T) <= CommandAlignment, "Command needs larger alignment");
+        const size_t commandSize = GetSizeAlign<size_t>(sizeof(T), CommandAlignment);
+        LEASSERT(commandSize < CommandSizeLimit);
+        T *command = new(allocateCommand(commandSize)) T(Forward<Args>(args)...);
+        command->commandSize = static_cast<uint32>(commandSize);
+        return command;
+    }
+    // Record command of type T followed by copy of Data
+    template<typename T, typename... Args>
+    T* recordCommandWithData(const void *Data, size_t DataSize, Args&&... args)
+    {
+        static_assert(alignof(T) <= CommandAlignment, "Command needs larger alignment");
+        const size_t commandSize = GetSizeAlign<size_t>(sizeof(T), CommandAlignment) + GetSizeAlign<size_t>(DataSize, CommandAlignment);
+        LEASSERT(commandSize < CommandSizeLimit);
+        T *command = new(allocateCommand(commandSize)) T(Forward<Args>(args)...);
+        command->commandSize = static_cast<uint32>(commandSize);
+        ::memcpy(getCommandData(command), Data, DataSize);
+        return command;
+    }
+    template<typename T>
+    static void* getCommandData(T *cmd) { return reinterpret_cast<uint8*>(cmd) + GetSizeAlign<size_t>(sizeof(T), CommandAlignment); }
+
+    // Memory for command of Size bytes (aligned by CommandAlignment) in page or segment of this thread
+    void* allocateCommand(size_t Size);
+
+    // Page of command memory (header of allocated block, memory follows it)
+    struct CommandPage
+    {
+        CommandPage    *Next;           // Page recorded after this
+        size_t          Size;
+
+        uint8* GetMemory() { return reinterpret_cast<uint8*>(this) + GetSizeAlign<size_t>(sizeof(CommandPage), CommandAlignment); }
+        uint8* GetEnd() { return GetMemory() + Size; }
+    };
+    CommandPage* createPage(size_t Size);
+    // Pooled page, or new page if there is no free one. Locked by mMutex.
+    CommandPage* acquirePage(size_t Size);
+    void releasePage(CommandPage *Page);
+    // Frame high-water moves to last frame (at recording present)
+    void closeFrameMemoryStatistics();
+    // Run commands until pull pointer reaches the end
+    void flushCommands(RenderState *rs, CommandPage *EndPage, uint8 *EndPointer);
+
+    // End of commands of marked frame
+    struct FrameMark
+    {
+        CommandPage    *Page;
+        uint8          *Pointer;
+    };
 private:
     CommandImpl             *mImpl;
 
-    void                    *mCommandBuffer;
-    void                    *mPushCommandBufferPointer;
-    void                    *mPullCommandBufferPointer;
+    CommandPage             *mPushPage;                 // Page recording to
+    uint8                   *mPushCommandBufferPointer;
+    CommandPage             *mPullPage;                 // Page flushing from
+    uint8                   *mPullCommandBufferPointer;
+    VectorArray<CommandPage*> mFreePages;
+    MemoryStatistics         mMemoryStatistics;
+    VectorArray<FrameMark>   mFrameMarks;               // Frames not flushed yet (oldest first)
 
-    struct {
+    struct RendererResources {
         void Clear() {
             Textures.Clear();
             IndexBuffers.Clear();
@@ -469,8 +666,67 @@ private:
         void Add(ConstantBuffer* c)         { if (ConstantBuffers.IndexOf(c) < 0) ConstantBuffers.Add(c); }
         void Add(SamplerState* s)           { if (SamplerStates.IndexOf(s) < 0) SamplerStates.Add(s); }
         void Add(PipelineState *p)          { if (PipelineStates.IndexOf(p) < 0) PipelineStates.Add(p); }
-    } ReservedRendererResources;
+        void Append(RendererResources &r)
+        {
+            for (TextureInterface *t : r.Textures)          Add(t);
+            for (IndexBuffer *i : r.IndexBuffers)           Add(i);
+            for (VertexBufferGeneric *v : r.VertexBuffers)  Add(v);
+            for (ConstantBuffer *c : r.ConstantBuffers)     Add(c);
+            for (SamplerState *ss : r.SamplerStates)        Add(ss);
+            for (PipelineState *p : r.PipelineStates)       Add(p);
+        }
+    } ReservedRendererResources;                        // Released while flushing (drawing thread)
+    RendererResources        mRetiredRendererResources; // Released by flushed frames (deleted by ReleaseRendererResources)
+    Mutex                    mRetiredRendererResourceMutex;
+
+    RecordingContext         mRecording;
 
     Mutex                    mMutex;
+
+    VectorArray<CommandSegment*> mSegments;         // All segments made by this buffer
+    VectorArray<CommandSegment*> mFreeSegments;
+    Mutex                    mSegmentMutex;
+
+    static thread_local CommandSegment *sRecordingSegment;
+};
+
+// Commands recorded by one thread without locking (chunked linear buffers).
+// Recording : CommandSegment::ScopedRecording, stitched into command stream : CommandBuffer::SubmitSegments
+class CommandSegment : public Object<LimitEngineMemoryCategory::Graphics>
+{
+    friend CommandBuffer;
+public:
+    // Records commands of this thread to segment in scope
+    class ScopedRecording
+    {
+    public:
+        ScopedRecording(CommandSegment *Segment) : mPrevious(CommandBuffer::GetRecordingSegment()) { CommandBuffer::SetRecordingSegment(Segment); }
+        ~ScopedRecording() { CommandBuffer::SetRecordingSegment(mPrevious); }
+    private:
+        CommandSegment *mPrevious;
+    };
+
+    CommandSegment() : mCommandCount(0u), mChunkIndex(0u) {}
+    ~CommandSegment();
+
+    bool IsEmpty() const { return mCommandCount == 0u; }
+    uint32 GetCommandCount() const { return mCommandCount; }
+
+private:
+    struct Chunk
+    {
+        uint8  *Memory;
+        size_t  Size;
+        size_t  Used;
+    };
+
+    void reset(bool RedundantStateElimination);
+    void* allocateCommand(size_t Size);
+
+private:
+    VectorArray<Chunk>                  mChunks;
+    uint32                              mCommandCount;
+    uint32                              mChunkIndex;            // Chunk used for allocating now
+    CommandBuffer::RecordingContext     mRecording;
 };
 }
@@ -27,6 +27,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 **********************************************************************/
 #pragma once
 
+#include <stddef.h>
+
 namespace LimitEngine {
 enum class RenderPass : char {
     PrePass = 0,
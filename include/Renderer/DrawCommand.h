@@ -36,6 +36,7 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "Managers/RenderTargetPoolManager.h"
 
 namespace LimitEngine {
+class CommandSegment;
 
 class DrawCommand
 { public:
@@ -59,6 +60,8 @@ class DrawCommand
 	static void Dispatch(int x, int y, int z);
     static void DrawPrimitive(RendererFlag::PrimitiveTypes type, uint32 offset, uint32 count);
     static void DrawIndexedPrimitive(RendererFlag::PrimitiveTypes type, uint32 vtxcount, uint32 count);
+    // Data of instances (instancecount * instancestride bytes) is copied to command buffer
+    static void DrawIndexedInstanced(RendererFlag::PrimitiveTypes type, uint32 count, uint32 instancecount, const void *instancedata, uint32 instancestride);
     static void SetRenderTarget(uint32 index, TextureInterface *color, TextureInterface *depthstencil, uint32 surfaceIndex = 0);
     static void UpdateConstantBuffer(ConstantBuffer* buffer, void* data, size_t size);
     static void SetPipelineState(PipelineState *pso);
@@ -70,6 +73,10 @@ class DrawCommand
     static void BeginEvent(const char *InEventName);
     static void EndEvent();
     static void Present();
+
+    // Segment recorded by worker thread (CommandSegment::ScopedRecording), submitted in order from recording thread
+    static CommandSegment* AcquireSegment();
+    static void SubmitSegments(CommandSegment **Segments, uint32 Count);
 }; // DrawCommand
 }
 #endif // LIMITENGINEV2_RENDERER_DRAWCOMMAND_H_
\ No newline at end of file
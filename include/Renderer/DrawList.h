@@ -0,0 +1,146 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  DrawList.h
+@brief Draws of a render pass sorted by state (pipeline state, material, vertex buffer, depth)
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#ifndef LIMITENGINEV2_DRAWLIST_H_
+#define LIMITENGINEV2_DRAWLIST_H_
+
+#include <LERenderer>
+
+#include <LEFloatMatrix4x4.h>
+
+#include "Core/Common.h"
+#include "Containers/VectorArray.h"
+
+namespace LimitEngine {
+class CommandSegment;
+class IndexBuffer;
+class Material;
+class PipelineState;
+class RenderState;
+class VertexBufferGeneric;
+// Draws of one render pass, sorted by 64bit key and submitted to DrawCommand in key order.
+// Key (high to low) : pass | pipeline state | material | vertex buffer | depth (front to back)
+// Translucency      : pass | depth (back to front) | pipeline state | material | vertex buffer
+// Pipeline state / index buffer / vertex buffer are set only when they change.
+// Large lists are split into ranges of sorted draws, recorded by TaskManager workers into command segments
+// and submitted in order of ranges (same commands as serial recording except binds at start of each range).
+// Building the list (AddInstance / AddDraw / Sort) stays on one thread : draws are appended to unguarded arrays,
+// and Model::preparePipelineState fills pipeline state slots of draw groups shared by all instances of a model.
+// (PipelineStateCache itself is thread-safe.)
+// Consecutive draws of same mesh / material given with instanced pipeline state (instances of a model)
+// are drawn by one DrawIndexedInstanced with world matrices of instances in command buffer.
+class DrawList
+{
+public:
+    static constexpr uint32 InvalidIndex = 0xffffffffu;
+
+    static constexpr uint32 PassBits = 2u;
+    static constexpr uint32 PipelineStateBits = 12u;
+    static constexpr uint32 MaterialBits = 14u;
+    static constexpr uint32 VertexBufferBits = 12u;
+    static constexpr uint32 DepthBits = 24u;
+    static constexpr uint32 ParallelSubmitMinDraws = 512u;    // Draws of one range recorded by a worker at least
+    static constexpr uint32 MinInstancesPerDraw = 2u;         // Less draws of same mesh are drawn without instancing
+    static constexpr uint32 MaxInstancesPerDraw = 512u;       // Instance data of a draw (32KB) fits in command page
+    static_assert(PassBits + PipelineStateBits + MaterialBits + VertexBufferBits + DepthBits == 64u, "Sort key has to fill 64bit");
+
+    // Commands issued by Submit (accumulated until ResetStatistics)
+    struct Statistics
+    {
+        uint32 DrawCount = 0u;                  // Draw commands (instanced draw is one)
+        uint32 InstancedDrawCount = 0u;
+        uint32 InstanceCount = 0u;              // Draws given to AddDraw which are drawn by instanced draws
+        uint32 PipelineStateChanges = 0u;
+        uint32 MaterialChanges = 0u;
+        uint32 VertexBufferChanges = 0u;
+        uint32 IndexBufferChanges = 0u;
+    };
+
+    DrawList();
+
+    // Remove draws (keeps memory for next pass)
+    void Clear();
+
+    // Matrices of instance for its draws, returns index for AddDraw
+    uint32 AddInstance(const LEMath::FloatMatrix4x4 &World, const LEMath::FloatMatrix4x4 &WorldViewProj);
+    // ViewDepth is distance along view direction (w of clip space)
+    // InInstancedPipelineState (instance input layout and instanced shader of material) allows draw to be instanced
+    void AddDraw(uint32 Instance, RenderPass Pass, float ViewDepth, PipelineState *InPipelineState, Material *InMaterial,
+                 VertexBufferGeneric *InVertexBuffer, IndexBuffer *InIndexBuffer, uint32 VertexCount, uint32 IndexCount,
+                 PipelineState *InInstancedPipelineState = nullptr);
+
+    void Sort();
+    // Draws in order of key with matrices of instances set to rs
+    void Submit(const RenderState &rs);
+
+    uint32 GetDrawCount() const                     { return mItems.count(); }
+    uint64 GetSortKey(uint32 Index) const           { return mItems[Index].SortKey; }
+    const Statistics& GetStatistics() const         { return mStatistics; }
+    void ResetStatistics()                          { mStatistics = Statistics(); }
+
+    static uint64 MakeSortKey(RenderPass Pass, uint32 PipelineStateID, uint32 MaterialID, uint32 VertexBufferID, float ViewDepth);
+
+private:
+    struct Item
+    {
+        uint64 SortKey;
+        uint32 Draw;
+        uint32 Reserved;
+    };
+    struct Draw
+    {
+        uint32               Instance;
+        uint32               VertexCount;
+        uint32               IndexCount;
+        PipelineState       *PSO;
+        PipelineState       *InstancedPSO;
+        Material            *DrawMaterial;
+        VertexBufferGeneric *Vertices;
+        IndexBuffer         *Indices;
+    };
+    struct Instance
+    {
+        LEMath::FloatMatrix4x4 World;
+        LEMath::FloatMatrix4x4 WorldViewProj;
+    };
+
+    void submitRange(const RenderState &rs, uint32 Begin, uint32 End, Statistics &OutStatistics) const;
+    // End of draws from Begin which can be drawn by one instanced draw (Begin + 1 if not instanced)
+    uint32 findInstancedBatchEnd(uint32 Begin, uint32 End) const;
+
+private:
+    VectorArray<Item>       mItems;         // Sorted by Sort
+    VectorArray<Draw>       mDraws;
+    VectorArray<Instance>   mInstances;
+    Statistics              mStatistics;
+
+    VectorArray<CommandSegment*>    mSegments;          // Segment of each range in parallel submission
+    VectorArray<Statistics>         mRangeStatistics;
+};
+} // namespace LimitEngine
+
+#endif // LIMITENGINEV2_DRAWLIST_H_
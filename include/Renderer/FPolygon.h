@@ -13,7 +13,7 @@
 #include <LEFloatVector3.h>
 
 #include "Containers/Pair.h"
-#include "Renderer/fRay.h"
+#include "Renderer/FRay.h"
 
 namespace LimitEngine {
     class fPolygon { public:
@@ -11,6 +11,7 @@
 #include <LEFloatMatrix4x4.h>
 
 #include "Core/Common.h"
+#include "Renderer/AABB.h"
 
 namespace LimitEngine {
 #define LE_DEFAULT_ASPECTRATIO      1.0f
@@ -24,12 +25,42 @@ namespace LimitEngine {
     class Frustum
     {
     public:
+        enum Plane { Left = 0, Right, Bottom, Top, Near, Far, PlaneCount };
+
+        // World space boxes of 4 objects (center / half extent in SoA), unit of CullBoxes
+        struct BoxBatch
+        {
+            float CenterX[4], CenterY[4], CenterZ[4];
+            float ExtentX[4], ExtentY[4], ExtentZ[4];
+
+            void Set(uint32 Lane, const AABB &Box)
+            {
+                CenterX[Lane] = (Box.minimum.X() + Box.maximum.X()) * 0.5f;
+                CenterY[Lane] = (Box.minimum.Y() + Box.maximum.Y()) * 0.5f;
+                CenterZ[Lane] = (Box.minimum.Z() + Box.maximum.Z()) * 0.5f;
+                ExtentX[Lane] = (Box.maximum.X() - Box.minimum.X()) * 0.5f;
+                ExtentY[Lane] = (Box.maximum.Y() - Box.minimum.Y()) * 0.5f;
+                ExtentZ[Lane] = (Box.maximum.Z() - Box.minimum.Z()) * 0.5f;
+            }
+            // Box that passes every plane (object without bounds)
+            void SetInfinite(uint32 Lane)
+            {
+                CenterX[Lane] = CenterY[Lane] = CenterZ[Lane] = 0.0f;
+                ExtentX[Lane] = ExtentY[Lane] = ExtentZ[Lane] = FLT_MAX;
+            }
+        };
+
         Frustum()
         : mAspectRatio  (LE_DEFAULT_ASPECTRATIO)
         , mFarMeters    (LE_DEFAULT_FARCLIP_METERS)
         , mNearMeters   (LE_DEFAULT_NEARCLIP_METERS)
         , mFovRadians   (LE_DEFAULT_FOV_RADIANS)
-        {}
+        {
+            // Everything is visible until UpdatePlanes
+            for (int planeIndex = 0; planeIndex < PlaneCount; planeIndex++) {
+                mPlaneX[planeIndex] = mPlaneY[planeIndex] = mPlaneZ[planeIndex] = mPlaneW[planeIndex] = 0.0f;
+            }
+        }
         
         // Set aspect ratio of screen
         void  SetAspectRatio(float ratio)       { mAspectRatio = ratio; }
@@ -79,10 +110,27 @@ namespace LimitEngine {
             return LEMath::FloatVector4(mNearMeters, mFarMeters, mFarMeters - mNearMeters, 0.0f);
         }
 
+        // Extract planes (normals point inside) from view projection matrix of GetProjectionMatrix
+        void UpdatePlanes(const LEMath::FloatMatrix4x4 &ViewProj);
+        // Get plane (xyz : normal, w : distance) made by UpdatePlanes
+        LEMath::FloatVector4 GetPlane(Plane InPlane) const
+        {
+            return LEMath::FloatVector4(mPlaneX[InPlane], mPlaneY[InPlane], mPlaneZ[InPlane], mPlaneW[InPlane]);
+        }
+        // Test boxes against planes. Bit n of OutMasks[i] is set if box n of Batches[i] may be visible.
+        void CullBoxes(const BoxBatch *Batches, uint32 BatchCount, uint8 *OutMasks) const;
+        // Test one box (reference of CullBoxes)
+        bool IsBoxVisible(const AABB &Box) const;
+
     protected:
         float       mFovRadians;        // Field of view (radians)
         float       mAspectRatio;       // Apect ratio of screen
         float       mFarMeters;         // Far clip of screen (meters)
         float       mNearMeters;        // Near clip of screen (meters)
+
+        float       mPlaneX[PlaneCount];    // Planes in SoA for CullBoxes
+        float       mPlaneY[PlaneCount];
+        float       mPlaneZ[PlaneCount];
+        float       mPlaneW[PlaneCount];
     };
 }
@@ -40,7 +40,7 @@ namespace LimitEngine {
 
         LightIBL                *mStandardIBL;
     }; // LightManager
-#define LE_LightManager LimitEngine::LightManager::GetSingleton()
+#define LE_LightManager ::LimitEngine::LightManager::GetSingleton()
 } // LimitEngine
 
 #endif // _LE_LIGHTMANAGER_H_
\ No newline at end of file
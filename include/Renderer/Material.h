@@ -28,12 +28,15 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
+#include <atomic>
+
 #include <LERenderer>
 
 #include <LEFloatVector4.h>
 
 #include "Core/Object.h"
 #include "Core/String.h"
+#include "Core/StringID.h"
 #include "Core/TextParser.h"
 #include "Renderer/Texture.h"
 #include "Containers/MapArray.h"
@@ -58,10 +61,19 @@ public:
     Material* Load(rapidxml::xml_node<const char> *XMLNode);
     void SetupShaderParameters();
     void ReadyToRender(const RenderState& rs, PipelineStateDescriptor& desc);
-    void Bind(const RenderState &rs);
-
-    void SetID(const String &n) { mId = n; }
+    // Parts of ReadyToRender : shaders of pass to descriptor / per draw constants (matrices in rs)
+    // Instanced : vertex shader taking world matrix per instance (vertex slot 1) instead of constants
+    void SetupPipelineStateDescriptor(const RenderPass &InRenderPass, PipelineStateDescriptor &desc, bool Instanced = false) const;
+    void UpdateConstantBuffers(const RenderState &rs, bool Instanced = false);
+    void Bind(const RenderState &rs, bool Instanced = false);
+    // Has vertex shader for instanced draws in the pass (<shader>_<pass>_instanced_VS)
+    bool IsInstancingSupported(const RenderPass &InRenderPass) const;
+
+    void SetID(const String &n) { mId = n; mStringID = StringID(n); }
     const String& GetID() const { return mId; }
+    const StringID& GetStringID() const { return mStringID; }
+    // Sequential number of creation (sort key of draws)
+    uint32 GetSortID() const { return mSortID; }
     void SetName(const String &name) { mName = name; }
     const String& GetName() const { return mName; }
         
@@ -86,6 +98,8 @@ private:
 
 private:
     String                                      mId;
+    StringID                                    mStringID;  // Interned mId for comparing
+    uint32                                      mSortID;
     String                                      mName;
 
     bool                                        mIsEnabledRenderPass[(uint32)RenderPass::NumOfRenderPass];
@@ -94,17 +108,23 @@ private:
 
     ShaderRefPtr                                mVertexShader[(uint32)RenderPass::NumOfRenderPass];
     ShaderRefPtr                                mPixelShader[(uint32)RenderPass::NumOfRenderPass];
+    ShaderRefPtr                                mInstancedVertexShader[(uint32)RenderPass::NumOfRenderPass];
     ConstantBufferRefPtr                        mVSConstantBuffer[(uint32)RenderPass::NumOfRenderPass];
     ConstantBufferRefPtr                        mPSConstantBuffer[(uint32)RenderPass::NumOfRenderPass];
+    ConstantBufferRefPtr                        mInstancedVSConstantBuffer[(uint32)RenderPass::NumOfRenderPass];
     void*                                       mVSConstantUpdateBuffer[(uint32)RenderPass::NumOfRenderPass];
     void*                                       mPSConstantUpdateBuffer[(uint32)RenderPass::NumOfRenderPass];
+    void*                                       mInstancedVSConstantUpdateBuffer[(uint32)RenderPass::NumOfRenderPass];
     RenderState::ShaderDriverForRenderState     mVSShaderDriver[(uint32)RenderPass::NumOfRenderPass];
     RenderState::ShaderDriverForRenderState     mPSShaderDriver[(uint32)RenderPass::NumOfRenderPass];
+    RenderState::ShaderDriverForRenderState     mInstancedVSShaderDriver[(uint32)RenderPass::NumOfRenderPass];
     RenderState::TexturePositionForRenderState  mVSTexturePosition[(uint32)RenderPass::NumOfRenderPass];
     RenderState::TexturePositionForRenderState  mPSTexturePosition[(uint32)RenderPass::NumOfRenderPass];
     RenderState::SamplerPositionForRenderState  mVSSamplerPosition[(uint32)RenderPass::NumOfRenderPass];
     RenderState::SamplerPositionForRenderState  mPSSamplerPosition[(uint32)RenderPass::NumOfRenderPass];
 
+    static std::atomic<uint32>                  sSortIDCounter;
+
     friend Archive;
 };
 }
@@ -35,6 +35,7 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include <LEFloatMatrix4x4.h>
 
 #include "Containers/VectorArray.h"
+#include "Containers/SmallVectorArray.h"
 #include "Core/ReferenceCountedObject.h"
 #include "Core/TextParser.h"
 #include "Core/SerializableResource.h"
@@ -56,6 +57,7 @@ namespace LimitEngine {
 typedef Vertex<FVF_PNCTTB, SIZE_PNCTTB> RigidVertex;
 typedef VertexBuffer<FVF_PNCTTB, SIZE_PNCTTB> RigidVertexBuffer;
 class ModelFactory;
+class DrawList;
 class IndexBuffer;
 class Material;
 class Shader;
@@ -74,12 +76,14 @@ public:
         IndexBufferRefPtr                   indexBuffer;
 
         PipelineStateRefPtr                 pipelinestates[static_cast<int>(RenderPass::NumOfRenderPass)];
+        PipelineStateRefPtr                 instancedpipelinestates[static_cast<int>(RenderPass::NumOfRenderPass)];
 
         ~_DRAWGROUP()
         {
             indexBuffer = nullptr;
             for (int psidx = 0; psidx < static_cast<int>(RenderPass::NumOfRenderPass); psidx++) {
                 pipelinestates[psidx].Release();
+                instancedpipelinestates[psidx].Release();
             }
         }
         void InitResource();
@@ -93,7 +97,7 @@ public:
         LEMath::FloatMatrix4x4   worldMatrix;
 
         VertexBufferRefPtr       vertexbuffer;
-        VectorArray<DRAWGROUP*>  drawgroups;
+        SmallVectorArray<DRAWGROUP*, 4> drawgroups;     // Mostly one per material
         _MESH()
         {
             pos = LEMath::FloatVector3::Zero;
@@ -126,8 +130,12 @@ public:
     virtual ~Model();
 
     AABB GetBoundingBox() { return mBoundingbox; }
+    // Bounding box in world space drawn with Transform (same matrix as Draw)
+    AABB GetWorldBoundingBox(const LEMath::FloatMatrix4x4 &Transform);
 
     void Draw(const RenderState &rs, const LEMath::FloatMatrix4x4 &Transform);
+    // Draws of pass in rs to List (submitted later in sorted order), ViewDepth is for sort key
+    void AddToDrawList(DrawList &List, const RenderState &rs, const LEMath::FloatMatrix4x4 &Transform, float ViewDepth);
 
     void SetName(const String &name)        { mName = name; }
     String GetName()                        { return mName; }
@@ -169,6 +177,9 @@ private:
     void calcTangentBinormal();
     void setupMaterialShaderParameters();
     LEMath::FloatMatrix4x4 getTransformMatrix();
+    // Pipeline state of drawgroup for pass in rs (created on first use)
+    // Instanced : with input of InstanceVertex and instanced vertex shader of material
+    PipelineState* preparePipelineState(const RenderState &rs, MESH *Mesh, DRAWGROUP *DrawGroup, bool Instanced = false);
 private:
     AABB                     mBoundingbox;
         
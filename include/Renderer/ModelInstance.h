@@ -11,10 +11,12 @@
 #include <LERenderer>
 
 #include "Core/ReferenceCountedObject.h"
+#include "AABB.h"
 #include "RenderState.h"
 #include "Transform.h"
 
 namespace LimitEngine {
+    class DrawList;
     class ModelInstance : public ReferenceCountedObject<LimitEngineMemoryCategory::Graphics>
     {
     public:
@@ -22,17 +24,26 @@ namespace LimitEngine {
             : mID(ID)
             , mTransform()
             , mModel(InModel) 
+            , mWorldBoundingBox()
+            , mWorldBoundingBoxUpdated(false)
         {}
         virtual ~ModelInstance() {}
 
         uint32 GetInstanceID() const { return mID; }
-        void SetTransform(const Transform &InTransform) { mTransform = InTransform; }
+        void SetTransform(const Transform &InTransform) { mTransform = InTransform; mWorldBoundingBoxUpdated = false; }
+        // Bounding box in world space (invalid if model has no bounds yet)
+        const AABB& GetWorldBoundingBox();
 
         void Draw(const RenderState &rs);
+        // Draws of pass in rs to List, sorted by depth of world bounds
+        void AddToDrawList(DrawList &List, const RenderState &rs);
 
     private:
         uint32      mID;
         Transform   mTransform;
         ModelRefPtr mModel;
+
+        AABB        mWorldBoundingBox;          // Cache of GetWorldBoundingBox
+        bool        mWorldBoundingBoxUpdated;
     };
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  NullBackend.h
+@brief Counters of null rendering backend
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#ifndef LIMITENGINEV2_NULLBACKEND_H_
+#define LIMITENGINEV2_NULLBACKEND_H_
+
+#include <atomic>
+
+#include "Core/Common.h"
+
+namespace LimitEngine {
+// Null backend (USE_NULL) renders nothing and counts what would be sent to GPU,
+// so CPU cost of frame (update, culling, recording, flush) can be measured without GPU.
+class NullBackend
+{
+public:
+    enum class Counter : uint32
+    {
+        Commands = 0,           // Calls to CommandImpl
+        DrawCalls,
+        DrawnInstances,         // Instances of draw calls (1 for non-instanced draw)
+        Dispatches,
+        StateBinds,             // Pipeline states, buffers, textures, samplers and render targets bound
+        StateChanges,           // Binds which changed bound object
+        ConstantBufferUpdates,
+        UploadedBytes,          // Data of constant buffer updates and instances
+        CreatedResources,       // Buffers, textures, samplers and pipeline states
+        ResourceBytes,          // Memory of created buffers and data given to textures
+        Presents,
+        Num
+    };
+    struct Statistics
+    {
+        uint64 Commands = 0u;
+        uint64 DrawCalls = 0u;
+        uint64 DrawnInstances = 0u;
+        uint64 Dispatches = 0u;
+        uint64 StateBinds = 0u;
+        uint64 StateChanges = 0u;
+        uint64 ConstantBufferUpdates = 0u;
+        uint64 UploadedBytes = 0u;
+        uint64 CreatedResources = 0u;
+        uint64 ResourceBytes = 0u;
+        uint64 Presents = 0u;
+    };
+
+    static Statistics GetStatistics();
+    static void ResetStatistics();
+
+    // Called by backend (from draw thread and renderer tasks)
+    static void Count(Counter InCounter, uint64 Value = 1u)
+    {
+        sCounters[static_cast<uint32>(InCounter)].fetch_add(Value, std::memory_order_relaxed);
+    }
+
+private:
+    static std::atomic<uint64> sCounters[static_cast<uint32>(Counter::Num)];
+};
+} // namespace LimitEngine
+
+#endif // LIMITENGINEV2_NULLBACKEND_H_
@@ -28,6 +28,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 #ifndef LIMITENGINEV2_PIPELINESTATE_H_
 #define LIMITENGINEV2_PIPELINESTATE_H_
 
+#include <atomic>
+
 #include <LERenderer>
 
 #include "Core/Memory.h"
@@ -64,8 +66,14 @@ public:
     bool IsValid() const { return mImpl->IsValid(); }
     bool Init(const PipelineStateDescriptor& desc) { return mImpl->Init(desc); }
 
+    // Sequential number of creation (sort key of draws)
+    uint32 GetSortID() const { return mSortID; }
+
 private:
     PipelineStateImpl*      mImpl;
+    uint32                  mSortID;
+
+    static std::atomic<uint32> sSortIDCounter;
 
     friend PipelineStateRendererAccessor;
 };
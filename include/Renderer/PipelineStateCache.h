@@ -0,0 +1,77 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  PipelineStateCache.h
+@brief Pipeline states shared by descriptor
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#ifndef LIMITENGINEV2_PIPELINESTATECACHE_H_
+#define LIMITENGINEV2_PIPELINESTATECACHE_H_
+
+#include <LERenderer>
+
+#include "Containers/MapArray.h"
+#include "Core/Mutex.h"
+#include "Renderer/PipelineState.h"
+#include "Renderer/PipelineStateDescriptor.h"
+
+namespace LimitEngine {
+// Pipeline states keyed by finalized descriptor (PipelineStateDescriptor::Hash)
+// Draws with same shaders / states / vertex format / render targets share one PipelineState.
+class PipelineStateCache
+{
+public:
+    struct Statistics
+    {
+        uint32 HitCount = 0u;               // Found in cache
+        uint32 MissCount = 0u;              // Created (or initialized again after failure)
+        uint64 CreationTimeUSec = 0u;       // Sum of time in PipelineState::Init
+        uint64 LongestCreationTimeUSec = 0u;
+    };
+
+    // Shared pipeline state for descriptor (descriptor has to be finalized)
+    static PipelineStateRefPtr Get(const PipelineStateDescriptor &Desc);
+    // Release all pipeline states (call on termination of renderer)
+    static void Terminate();
+
+    static Statistics GetStatistics();
+    static void ResetStatistics();
+    // Count of different descriptors seen
+    static uint32 GetCount();
+    // Enumerate descriptors seen, Func(const PipelineStateDescriptor&)
+    template<typename FuncType>
+    static void ForEachDescriptor(FuncType Func)
+    {
+        Mutex::ScopedLock scopedLock(sMutex);
+        for (uint32 index = 0; index < sCache.GetSize(); index++)
+            Func(sCache.GetAt(index).key);
+    }
+
+private:
+    static Mutex                                                    sMutex;
+    static MapArray<PipelineStateDescriptor, PipelineStateRefPtr>   sCache;
+    static Statistics                                               sStatistics;
+};
+} // namespace LimitEngine
+
+#endif // LIMITENGINEV2_PIPELINESTATECACHE_H_
@@ -32,7 +32,6 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Core/Util.h"
 #include "Core/Hash.h"
-#include "Core/MemoryAllocator.h"
 #include "Renderer/Shader.h"
 #include "Renderer/Texture.h"
 
@@ -151,29 +150,36 @@ struct PipelineStateDescriptor {
         RendererFlag::InputClassification InputSlotClass;
         uint32 InstanceDataStepRate;
     } InputElementDescriptors[MaxInputElementsNum];
-    uint32 InputElementCount;
+    uint32 InputElementCount = 0u;
 
     uint64 Hash = 0ull;
 
     void ComputeHash() {
-        const size_t ThisClassSizeAligned = GetSizeAlign(sizeof(PipelineStateDescriptor), 16ull);
-        void *HashSource = (void*)MemoryAllocator::Alloc(ThisClassSizeAligned);
-        uint8* HashSourcePtr = (uint8*)HashSource;
-        ::memset(HashSource, 0, ThisClassSizeAligned);
-        ::memcpy(HashSourcePtr, Shaders, sizeof(Shaders));
-        HashSourcePtr += sizeof(Shaders);
-        ::memcpy(HashSourcePtr, &BlendDescriptor, sizeof(BlendDescriptor));
-        HashSourcePtr += sizeof(BlendDescriptor);
-        ::memcpy(HashSourcePtr, &RasterizerDescriptor, sizeof(RasterizerDescriptor));
-        HashSourcePtr += sizeof(RasterizerDescriptor);
-        ::memcpy(HashSourcePtr, &DepthStencilDescriptor, sizeof(DepthStencilDescriptor));
-        HashSourcePtr += sizeof(DepthStencilDescriptor);
-        ::memcpy(HashSourcePtr, &Topology, sizeof(Topology));
-        HashSourcePtr += sizeof(Topology);
-        ::memcpy(HashSourcePtr, InputElementDescriptors, sizeof(InputElementDescriptors));
-
-        Hash = Hash::GenerateHash(static_cast<uint64*>(HashSource), ThisClassSizeAligned);
-        MemoryAllocator::Free(HashSource);
+        // Field by field, padding bytes and unused input elements are not part of the state
+        HashBuilder builder;
+        for (const ShaderRefPtr &shader : Shaders)
+            builder << shader.Get();
+        builder << BlendDescriptor.AlphaToCoverageEnabled << BlendDescriptor.IndependentBlendEnabled;
+        for (const auto &rtBlend : BlendDescriptor.RenderTargetBlendDescriptor) {
+            builder << rtBlend.BlendEnabled << rtBlend.SrcBlend << rtBlend.DestBlend << rtBlend.BlendOp
+                    << rtBlend.SrcAlpha << rtBlend.DestAlpha << rtBlend.BlendOpAlpha;
+        }
+        builder << RasterizerDescriptor.FillMode << RasterizerDescriptor.CullMode << RasterizerDescriptor.Culling;
+        builder << RenderTargetsNum << RenderTargetFormats << DepthTargetFormat;
+        builder << DepthStencilDescriptor.DepthEnabled << DepthStencilDescriptor.DepthWriteMask << DepthStencilDescriptor.DepthFunc
+                << DepthStencilDescriptor.StencilEnabled << DepthStencilDescriptor.StencilReadMask << DepthStencilDescriptor.StencilWriteMask;
+        const StencilFaceOperator &frontFace = DepthStencilDescriptor.StencilFrontFace;
+        const StencilFaceOperator &backFace = DepthStencilDescriptor.StencilBackFace;
+        builder << frontFace.FailOperator << frontFace.DepthFailOperator << frontFace.PassOperator << frontFace.StencilFunc;
+        builder << backFace.FailOperator << backFace.DepthFailOperator << backFace.PassOperator << backFace.StencilFunc;
+        builder << Topology;
+        builder << InputElementCount;
+        for (uint32 ieidx = 0; ieidx < InputElementCount; ieidx++) {
+            const auto &inputElement = InputElementDescriptors[ieidx];
+            builder << inputElement.SemanticName << inputElement.SemanticIndex << inputElement.Format << inputElement.InputSlot
+                    << inputElement.AlignedByteOffset << inputElement.InputSlotClass << inputElement.InstanceDataStepRate;
+        }
+        Hash = builder.Finalize();
     }
 
     void Finalize() {
@@ -185,6 +191,12 @@ struct PipelineStateDescriptor {
         return Hash == desc.Hash;
     }
 };
+
+// Descriptors are compared by their computed hash
+template<> struct HashTraits<PipelineStateDescriptor>
+{
+    static uint64 GetHash(const PipelineStateDescriptor &Value) { LEASSERT(Value.Hash); return Value.Hash; }
+};
 }
 
 #endif //  LIMITENGINEV2_PIPELINESTATEDESCRIPTOR_H_
\ No newline at end of file
@@ -36,6 +36,7 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Core/Object.h"
 #include "Core/ReferenceCountedPointer.h"
+#include "Core/StringID.h"
 #include "Renderer/DrawCommand.h"
 #include "Renderer/Texture.h"
 #include "Renderer/PipelineStateDescriptor.h"
@@ -45,6 +46,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "Shaders/Standard_prepass.ps.h"
 #include "Shaders/Standard_basepass.vs.h"
 #include "Shaders/Standard_basepass.ps.h"
+#include "Shaders/Standard_prepass_instanced.vs.h"
+#include "Shaders/Standard_basepass_instanced.vs.h"
 
 namespace LimitEngine {
 class RenderState : public Object<LimitEngineMemoryCategory::Graphics>
@@ -81,6 +84,26 @@ public:
             ViewProjectionMatrix = (LEMath::FloatMatrix4x4*)&cb.ViewProjectionMatrix[0];
             WorldViewProjectionMatrix = (LEMath::FloatMatrix4x4*)&cb.WorldViewProjMatrix[0];
         }
+        void Setup(const Standard_prepass_instanced_VS::ConstantBuffer0& cb)
+        {
+            FrameIndexContext = (LEMath::IntVector4*)&cb.FrameIndexContext[0];
+            BlueNoiseContext = (LEMath::FloatVector4*)&cb.BlueNoiseContext[0];
+            ViewMatrix = (LEMath::FloatMatrix4x4*)&cb.ViewMatrix[0];
+            ProjectionMatrix = (LEMath::FloatMatrix4x4*)&cb.ProjectionMatrix[0];
+            WorldMatrix = (LEMath::FloatMatrix4x4*)&cb.WorldMatrix[0];
+            ViewProjectionMatrix = (LEMath::FloatMatrix4x4*)&cb.ViewProjectionMatrix[0];
+            WorldViewProjectionMatrix = (LEMath::FloatMatrix4x4*)&cb.WorldViewProjMatrix[0];
+        }
+        void Setup(const Standard_basepass_instanced_VS::ConstantBuffer0& cb)
+        {
+            FrameIndexContext = (LEMath::IntVector4*)&cb.FrameIndexContext[0];
+            BlueNoiseContext = (LEMath::FloatVector4*)&cb.BlueNoiseContext[0];
+            ViewMatrix = (LEMath::FloatMatrix4x4*)&cb.ViewMatrix[0];
+            ProjectionMatrix = (LEMath::FloatMatrix4x4*)&cb.ProjectionMatrix[0];
+            WorldMatrix = (LEMath::FloatMatrix4x4*)&cb.WorldMatrix[0];
+            ViewProjectionMatrix = (LEMath::FloatMatrix4x4*)&cb.ViewProjectionMatrix[0];
+            WorldViewProjectionMatrix = (LEMath::FloatMatrix4x4*)&cb.WorldViewProjMatrix[0];
+        }
         void Setup(const Standard_basepass_PS::ConstantBuffer0& cb)
         {
             FrameIndexContext = (LEMath::IntVector4*)&cb.FrameIndexContext[0];
@@ -92,6 +115,29 @@ public:
             ViewProjectionMatrix = (LEMath::FloatMatrix4x4*)&cb.ViewProjectionMatrix[0];
             WorldViewProjectionMatrix = (LEMath::FloatMatrix4x4*)&cb.WorldViewProjMatrix[0];
         }
+        // Driver for copy of constant buffer (From : buffer given to Setup, To : copy of it)
+        ShaderDriverForRenderState Relocate(const void *From, void *To) const
+        {
+            ShaderDriverForRenderState output;
+            output.TemporalContext = relocate(TemporalContext, From, To);
+            output.FrameIndexContext = relocate(FrameIndexContext, From, To);
+            output.BlueNoiseContext = relocate(BlueNoiseContext, From, To);
+            output.IBLReflectionInfo = relocate(IBLReflectionInfo, From, To);
+            output.ViewMatrix = relocate(ViewMatrix, From, To);
+            output.ProjectionMatrix = relocate(ProjectionMatrix, From, To);
+            output.WorldMatrix = relocate(WorldMatrix, From, To);
+            output.ViewProjectionMatrix = relocate(ViewProjectionMatrix, From, To);
+            output.WorldViewProjectionMatrix = relocate(WorldViewProjectionMatrix, From, To);
+            return output;
+        }
+    private:
+        template<typename T>
+        static T* relocate(T *Pointer, const void *From, void *To)
+        {
+            if (Pointer == nullptr)
+                return nullptr;
+            return reinterpret_cast<T*>(static_cast<uint8*>(To) + (reinterpret_cast<const uint8*>(Pointer) - static_cast<const uint8*>(From)));
+        }
     };
     struct TexturePositionForRenderState
     {
@@ -102,17 +148,11 @@ public:
         void Setup(const char **texturenames, uint32 count)
         {
             for (uint32 nameidx = 0; nameidx < count; nameidx++) {
-                if (strcmp(texturenames[nameidx], "IBLReflectionTexture") == 0) {
-                    IBLReflectionTexturePosition = nameidx;
-                }
-                else if (strcmp(texturenames[nameidx], "IBLIrradianceTexture") == 0) {
-                    IBLIrradianceTexturePosition = nameidx;
-                }
-                else if (strcmp(texturenames[nameidx], "EnvironmentBRDFTexture") == 0) {
-                    EnvironmentBRDFTexturePosition = nameidx;
-                }
-                else if (strcmp(texturenames[nameidx], "AmbientOcclusionTexture") == 0) {
-                    AmbientOcclusionTexturePosition = nameidx;
+                switch (StringID(texturenames[nameidx]).GetHash()) {
+                case StringID("IBLReflectionTexture").GetHash():    IBLReflectionTexturePosition = nameidx;     break;
+                case StringID("IBLIrradianceTexture").GetHash():    IBLIrradianceTexturePosition = nameidx;     break;
+                case StringID("EnvironmentBRDFTexture").GetHash():  EnvironmentBRDFTexturePosition = nameidx;   break;
+                case StringID("AmbientOcclusionTexture").GetHash(): AmbientOcclusionTexturePosition = nameidx;  break;
                 }
             }
         }
@@ -126,17 +166,11 @@ public:
         void Setup(const char** samplernames, uint32 count)
         {
             for (uint32 nameidx = 0; nameidx < count; nameidx++) {
-                if (strcmp(samplernames[nameidx], "IBLReflectionSampler") == 0) {
-                    IBLReflectionSamplerPosition = nameidx;
-                }
-                else if (strcmp(samplernames[nameidx], "IBLIrradianceSampler") == 0) {
-                    IBLIrradianceSamplerPosition = nameidx;
-                }
-                else if (strcmp(samplernames[nameidx], "EnvironmentBRDFSampler") == 0) {
-                    EnvironmentBRDFSamplerPosition = nameidx;
-                }
-                else if (strcmp(samplernames[nameidx], "AmbientOcclusionSampler") == 0) {
-                    AmbientOcclusionSamplerPosition = nameidx;
+                switch (StringID(samplernames[nameidx]).GetHash()) {
+                case StringID("IBLReflectionSampler").GetHash():    IBLReflectionSamplerPosition = nameidx;     break;
+                case StringID("IBLIrradianceSampler").GetHash():    IBLIrradianceSamplerPosition = nameidx;     break;
+                case StringID("EnvironmentBRDFSampler").GetHash():  EnvironmentBRDFSamplerPosition = nameidx;   break;
+                case StringID("AmbientOcclusionSampler").GetHash(): AmbientOcclusionSamplerPosition = nameidx;  break;
                 }
             }
         }
@@ -13,6 +13,7 @@
 #include <LEFloatVector2.h>
 #include <LEFloatVector3.h>
 #include <LEFloatVector4.h>
+#include <LEFloatMatrix4x4.h>
 
 #include "Core/Common.h"
 #include "Core/Object.h"
@@ -64,6 +65,13 @@ enum FVF_INDEX
 };
 extern const RendererFlag::BufferFormat FVF_FORMATS[FVF_INDEX_MAX];
 extern const char* FVF_NAMES[FVF_INDEX_MAX];
+// Data of one instance in instanced draws (vertex slot 1, rows of World are INSTANCEWORLD0~3)
+struct InstanceVertex
+{
+    LEMath::FloatMatrix4x4 World;
+};
+static constexpr uint32 INSTANCE_VERTEX_SLOT = 1u;
+extern const char* INSTANCE_WORLD_NAME;
 enum FVF_SIZE
 {
 	FVF_SIZE_NONE		= 0,
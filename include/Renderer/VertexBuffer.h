@@ -8,6 +8,8 @@
  ***********************************************************/
 #pragma once
 
+#include <atomic>
+
 #include <LERenderer>
 
 #include "Core/Memory.h"
@@ -84,12 +86,18 @@ namespace LimitEngine {
         virtual uint32 GetBufferSize() const = 0;
         virtual uint32 GetStride() const = 0;
 
+        // Sequential number of creation (sort key of draws)
+        uint32 GetSortID() const { return mSortID; }
+
     protected: // RendererAccessorOnly
         virtual ResourceState GetResourceState() const = 0;
         virtual void SetResourceState(const ResourceState& state) = 0;
 
     protected:
         VertexBufferImpl* mImpl = nullptr;
+        uint32 mSortID;
+
+        static std::atomic<uint32> sSortIDCounter;
 
         friend class VertexBufferRendererAccessor;
     };
@@ -115,6 +123,8 @@ namespace LimitEngine {
     };
 
     VertexBufferImpl* CreateImplementation();
+    // Elements of InstanceVertex (per instance, INSTANCE_VERTEX_SLOT) after elements of vertex buffer in desc
+    void GenerateInstanceInputElementDescriptors(PipelineStateDescriptor& desc);
     template<uint32 tFVF> void GenerateInputElementDescriptorsUsingFVF(PipelineStateDescriptor& desc) {
         desc.InputElementCount = 0u;
         uint32 descriptorindex = 0u;
@@ -0,0 +1,61 @@
+/*********************************************************************
+Copyright(c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this softwareand associated documentation
+files(the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and /or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright noticeand this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file Standard_basepass_instanced.vs
+@brief Standard basepass vertex shader for instanced draws (world matrix per instance)
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#include "CommonDefinitions.shh"
+
+struct VS_INPUT
+{
+    float4 Position     : POSITION0;
+    float4 Normal       : NORMAL;
+    float4 Color        : COLOR0;
+    float2 Texcoord0    : TEXCOORD;
+//    float4 Tangent      : TANGENT;
+//    float4 Binormal     : BINORMAL;
+    float4x4 InstanceWorld : INSTANCEWORLD;     // Vertex slot 1, rows of world matrix of instance
+};
+
+struct VS_OUTPUT
+{
+    float4 Position      : SV_POSITION;
+    float4 Normal        : NORMAL;
+    float4 Color         : COLOR0;
+    float2 Texcoord0     : TEXCOORD0;
+    float4 WorldPosition : POSITION1;
+    float4 WorldNormal   : POSITION2;
+};
+
+VS_OUTPUT vs_main(VS_INPUT In)
+{
+    VS_OUTPUT Out = (VS_OUTPUT)0;
+    Out.WorldPosition = mul(In.Position, In.InstanceWorld);
+    Out.Position = mul(ViewProjectionMatrix, Out.WorldPosition);
+    Out.Normal = In.Normal;
+    Out.Color = In.Color;
+    Out.Texcoord0 = In.Texcoord0;
+    Out.WorldNormal.xyz = normalize(mul(In.Normal.xyz, (float3x3)In.InstanceWorld));
+    return Out;
+}
@@ -8,7 +8,9 @@
  ***********************************************************/
 #include "Core/Archive.h"
 
+#ifdef WINDOWS
 #include <io.h>
+#endif
 
 #include "Core/SerializableResource.h"
 #include "Renderer/AABB.h"
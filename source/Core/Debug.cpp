@@ -11,11 +11,13 @@
 
 #ifdef WINDOWS
 #include "../Platform/Windows/DebugImpl_Windows.inl"
+#elif defined(LINUX)
+#include "../Platform/Linux/DebugImpl_Linux.inl"
 #endif
 
 namespace LimitEngine {
-#ifdef WINDOWS
-	Debug* SingletonDebug::mInstance = NULL;
+#if defined(WINDOWS) || defined(LINUX)
+	template<> Debug* SingletonDebug::mInstance = NULL;
 #endif
 	Debug::Debug()
 		: mPrintflag(PRINTFLAG_LOG | PRINTFLAG_GUI)
@@ -23,6 +25,8 @@ namespace LimitEngine {
 	{
 #ifdef WINDOWS
 		mImpl = new DebugImpl_Windows();
+#elif defined(LINUX)
+		mImpl = new DebugImpl_Linux();
 #else
 #error No implementation for Debug
 #endif
@@ -9,6 +9,8 @@ Copyright (C), LIMITGAME, 2020
 #include "Core/Event.h"
 #ifdef WINDOWS
 #include "../Platform/Windows/EventImpl_Windows.inl"
+#elif defined(LINUX)
+#include "../Platform/Linux/EventImpl_Linux.inl"
 #else
 #error No implementation for Event
 #endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+/***********************************************************
+ LIMITEngine Source File
+ Copyright (C), LIMITGAME, 2020
+ -----------------------------------------------------------
+ @file  FrameAllocator.cpp
+ @brief Linear allocator for data living for one frame
+ @author minseob (https://github.com/rasidin)
+ ***********************************************************/
+
+#include "Core/FrameAllocator.h"
+#include "Core/MemoryAllocator.h"
+#include "Core/Util.h"
+
+namespace LimitEngine {
+FrameAllocator::STATS FrameAllocator::mStats;
+
+uint8* FrameAllocator::mPool = nullptr;
+size_t FrameAllocator::mFrameMemorySize = 0u;
+uint32 FrameAllocator::mFrameCounter = 0u;
+std::atomic<uint32> FrameAllocator::mCurrentFrameIndex(0u);
+std::atomic<size_t> FrameAllocator::mFrameOffsets[FrameAllocator::FrameCount];
+
+void FrameAllocator::Init(size_t frameMemorySize)
+{
+    LEASSERT(mPool == nullptr);
+
+    mFrameMemorySize = GetSizeAlign(frameMemorySize, AllocationAlign);
+    mPool = reinterpret_cast<uint8*>(MemoryAllocator::Alloc(mFrameMemorySize * FrameCount, LimitEngineMemoryCategory::Common));
+    LEASSERT((mPool != nullptr) && "allocate frame memory failed!!!");
+
+    mFrameCounter = 0u;
+    mCurrentFrameIndex.store(0u);
+    for (uint32 frameIndex = 0; frameIndex < FrameCount; frameIndex++) {
+        mFrameOffsets[frameIndex].store(0u);
+    }
+}
+
+void FrameAllocator::Term()
+{
+    if (mPool == nullptr)
+        return;
+
+    MemoryAllocator::Free(mPool);
+    mPool = nullptr;
+    mFrameMemorySize = 0u;
+}
+
+void FrameAllocator::BeginFrame(uint32 frameCounter)
+{
+    if (mPool == nullptr || frameCounter == mFrameCounter)
+        return;
+
+    const uint32 lastFrameIndex = mCurrentFrameIndex.load(std::memory_order_relaxed);
+    const uint32 newFrameIndex = frameCounter % FrameCount;
+    mFrameCounter = frameCounter;
+
+    mStats.LastFrameAllocationCount = mStats.AllocationCount.exchange(0u, std::memory_order_relaxed);
+    mStats.LastFrameFallbackCount = mStats.FallbackCount.exchange(0u, std::memory_order_relaxed);
+    const size_t lastFrameOffset = mFrameOffsets[lastFrameIndex].load(std::memory_order_relaxed);
+    mStats.LastFrameUsedMemory = (lastFrameOffset < mFrameMemorySize) ? lastFrameOffset : mFrameMemorySize;
+
+    if (newFrameIndex == lastFrameIndex)
+        return;
+
+    // Everything in the reused area is FrameCount-1 frames old and has retired
+    mFrameOffsets[newFrameIndex].store(0u, std::memory_order_relaxed);
+    mCurrentFrameIndex.store(newFrameIndex, std::memory_order_release);
+}
+
+void* FrameAllocator::Alloc(size_t size)
+{
+    if (mPool == nullptr)
+        return nullptr;
+
+    const size_t alignedSize = GetSizeAlign(size ? size : 1u, AllocationAlign);
+    const uint32 frameIndex = mCurrentFrameIndex.load(std::memory_order_acquire);
+    const size_t offset = mFrameOffsets[frameIndex].fetch_add(alignedSize, std::memory_order_relaxed);
+    if (offset + alignedSize > mFrameMemorySize) {
+        mStats.FallbackCount.fetch_add(1u, std::memory_order_relaxed);
+        return nullptr;
+    }
+    mStats.AllocationCount.fetch_add(1u, std::memory_order_relaxed);
+    return mPool + mFrameMemorySize * frameIndex + offset;
+}
+}
@@ -0,0 +1,164 @@
+/***********************************************************
+ LIMITEngine Source File
+ Copyright (C), LIMITGAME, 2020
+ -----------------------------------------------------------
+ @file  FramePacer.cpp
+ @brief Pacing of frames (uncapped, fixed rate, adaptive)
+ @author minseob (https://github.com/rasidin)
+ ***********************************************************/
+
+#include "Core/FramePacer.h"
+#include "Core/Thread.h"
+#include "Core/Timer.h"
+
+namespace LimitEngine {
+static constexpr uint64 SleepMarginUSec = 500u;                // Spin at least this long before deadline
+static constexpr uint64 InitialSleepOvershootUSec = 2000u;     // Until sleep is measured (timer tick may be coarse)
+
+FramePacer::FramePacer(Mode InMode, double InRate)
+    : mMode(InMode)
+    , mRate(InRate)
+    , mBaseIntervalUSec(0u)
+    , mAdaptiveDivisor(1u)
+    , mAverageWorkUSec(0u)
+    , mFrameTime(0u)
+    , mFrameStartTime(0u)
+    , mSleepOvershootUSec(InitialSleepOvershootUSec)
+    , mSleepDeviationUSec(0u)
+    , mStatistics()
+    , mMutex()
+{
+    SetMode(InMode, InRate);
+}
+
+void FramePacer::SetMode(Mode InMode, double InRate)
+{
+    Mutex::ScopedLock scopedLock(mMutex);
+    mMode = InMode;
+    mRate = (InRate > 0.0) ? InRate : 60.0;
+    mBaseIntervalUSec = static_cast<uint64>(1000000.0 / mRate);
+    mAdaptiveDivisor = 1u;
+    mAverageWorkUSec = 0u;
+    // Schedule starts again from next frame
+    mFrameTime = 0u;
+    mStatistics.TargetIntervalUSec = (mMode == Mode::Uncapped) ? 0u : mBaseIntervalUSec;
+}
+
+FramePacer::Mode FramePacer::GetMode()
+{
+    Mutex::ScopedLock scopedLock(mMutex);
+    return mMode;
+}
+
+double FramePacer::GetRate()
+{
+    Mutex::ScopedLock scopedLock(mMutex);
+    return mRate;
+}
+
+void FramePacer::WaitForNextFrame()
+{
+    const uint64 now = Timer::GetTimeUSec();
+    uint64 deadline = 0u;
+    {
+        Mutex::ScopedLock scopedLock(mMutex);
+        if (mMode != Mode::Uncapped && mFrameTime) {
+            if (mMode == Mode::Adaptive)
+                updateAdaptiveDivisor(now - mFrameStartTime, mBaseIntervalUSec);
+            deadline = mFrameTime + mBaseIntervalUSec * mAdaptiveDivisor;
+        }
+    }
+
+    uint64 sleepTime = 0u;
+    uint64 spinTime = 0u;
+    if (deadline > now) {
+        const uint64 sleepEndTime = waitUntil(deadline);
+        sleepTime = sleepEndTime - now;
+        spinTime = Timer::GetTimeUSec() - sleepEndTime;
+    }
+    const uint64 startTime = Timer::GetTimeUSec();
+
+    Mutex::ScopedLock scopedLock(mMutex);
+    Statistics &statistics = mStatistics;
+    if (mFrameStartTime && statistics.Frames) {
+        statistics.LastIntervalUSec = startTime - mFrameStartTime;
+    }
+    if (deadline) {
+        const uint64 interval = mBaseIntervalUSec * mAdaptiveDivisor;
+        statistics.LastErrorUSec = (startTime > deadline) ? (startTime - deadline) : 0u;
+        statistics.TotalErrorUSec += statistics.LastErrorUSec;
+        statistics.MaxErrorUSec = MAX(statistics.MaxErrorUSec, statistics.LastErrorUSec);
+        if (deadline <= now)
+            statistics.LateFrames++;
+        if (statistics.LastIntervalUSec) {
+            statistics.LastIntervalErrorUSec = (statistics.LastIntervalUSec > interval) ? (statistics.LastIntervalUSec - interval) : (interval - statistics.LastIntervalUSec);
+            statistics.TotalIntervalErrorUSec += statistics.LastIntervalErrorUSec;
+            statistics.MaxIntervalErrorUSec = MAX(statistics.MaxIntervalErrorUSec, statistics.LastIntervalErrorUSec);
+        }
+        statistics.TotalSleepUSec += sleepTime;
+        statistics.TotalSpinUSec += spinTime;
+        statistics.TargetIntervalUSec = interval;
+    }
+    statistics.Frames++;
+    // Late frame starts new schedule (no burst of short frames to catch up)
+    mFrameTime = (deadline > now) ? deadline : startTime;
+    mFrameStartTime = startTime;
+}
+
+uint64 FramePacer::waitUntil(uint64 Time)
+{
+    uint64 now = Timer::GetTimeUSec();
+    // Sleep can end later by average + 2 * deviation (rare longer oversleep makes frame late, not the estimate huge)
+    const uint64 sleepMargin = mSleepOvershootUSec + mSleepDeviationUSec * 2u + SleepMarginUSec;
+    const uint32 sleepMilliSecond = (Time > now + sleepMargin) ? static_cast<uint32>((Time - now - sleepMargin) / 1000u) : 0u;
+    if (sleepMilliSecond) {
+        Thread::Sleep(sleepMilliSecond);
+        const uint64 sleepEndTime = Timer::GetTimeUSec();
+        const uint64 sleptTime = sleepEndTime - now;
+        const uint64 overshoot = (sleptTime > sleepMilliSecond * 1000u) ? (sleptTime - sleepMilliSecond * 1000u) : 0u;
+        const uint64 deviation = (overshoot > mSleepOvershootUSec) ? (overshoot - mSleepOvershootUSec) : (mSleepOvershootUSec - overshoot);
+        mSleepOvershootUSec = (mSleepOvershootUSec * 7u + overshoot) / 8u;
+        mSleepDeviationUSec = (mSleepDeviationUSec * 7u + deviation) / 8u;
+        now = sleepEndTime;
+    }
+    else if (Time > now + SleepMarginUSec + 1000u) {
+        // Estimate too large to sleep at all can't be measured again, so it falls until sleeping is tried
+        mSleepOvershootUSec -= mSleepOvershootUSec / 16u;
+        mSleepDeviationUSec -= mSleepDeviationUSec / 16u;
+    }
+    const uint64 sleepEndTime = now;
+    while (now < Time) {
+        Thread::YieldThread();
+        now = Timer::GetTimeUSec();
+    }
+    return sleepEndTime;
+}
+
+void FramePacer::updateAdaptiveDivisor(uint64 WorkTime, uint64 BaseInterval)
+{
+    // One long hitch (loading) must not hold low rate for many frames
+    const uint64 workTime = MIN(WorkTime, BaseInterval * MaxAdaptiveDivisor);
+    mAverageWorkUSec = mAverageWorkUSec ? (mAverageWorkUSec * 7u + workTime) / 8u : workTime;
+    if (mAdaptiveDivisor < MaxAdaptiveDivisor && mAverageWorkUSec > BaseInterval * mAdaptiveDivisor) {
+        mAdaptiveDivisor++;
+    }
+    // Back to higher rate when frames fit in it with room
+    else if (mAdaptiveDivisor > 1u && mAverageWorkUSec * 100u < BaseInterval * (mAdaptiveDivisor - 1u) * 85u) {
+        mAdaptiveDivisor--;
+    }
+}
+
+FramePacer::Statistics FramePacer::GetStatistics()
+{
+    Mutex::ScopedLock scopedLock(mMutex);
+    return mStatistics;
+}
+
+void FramePacer::ResetStatistics()
+{
+    Mutex::ScopedLock scopedLock(mMutex);
+    Statistics statistics;
+    statistics.TargetIntervalUSec = mStatistics.TargetIntervalUSec;
+    mStatistics = statistics;
+}
+}
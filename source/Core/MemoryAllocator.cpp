@@ -11,10 +11,67 @@
 #include "Core/Mutex.h"
 #include "Core/Util.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace LimitEngine {
 static Mutex gMutexForMemoryAllocator;
 
+static inline uint32 FindFirstSetBit(uint32 value)
+{
+    LEASSERT(value != 0u);
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<uint32>(index);
+#else
+    return static_cast<uint32>(__builtin_ctz(value));
+#endif
+}
+
+static inline uint32 FindLastSetBit(uint32 value)
+{
+    LEASSERT(value != 0u);
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, value);
+    return static_cast<uint32>(index);
+#else
+    return 31u - static_cast<uint32>(__builtin_clz(value));
+#endif
+}
+
+// Payload blocks of each thread cache size class, and the class serving each block count
+static constexpr uint64 gSizeClassMemBlocks[] = { 1u, 2u, 3u, 4u, 6u, 8u, 12u, 16u };
+static constexpr uint32 gSizeClassIndices[] = { 0u, 0u, 1u, 2u, 3u, 4u, 4u, 5u, 5u, 6u, 6u, 6u, 6u, 7u, 7u, 7u, 7u };
+
 MemoryAllocator::STATS MemoryAllocator::mStats;
+thread_local MemoryAllocator::THREADCACHE MemoryAllocator::sThreadCache;
+
+//!---- Pool lock with contention statistics
+class MemoryAllocator::ScopedAllocatorLock
+{
+public:
+    ScopedAllocatorLock()
+    {
+        if (!gMutexForMemoryAllocator.TryLock()) {
+            gMutexForMemoryAllocator.Lock();
+            mStats.LockContentionCount++;
+        }
+        mStats.LockCount++;
+    }
+    ~ScopedAllocatorLock()
+    {
+        gMutexForMemoryAllocator.Unlock();
+    }
+};
+
+//!---- Thread cache
+MemoryAllocator::THREADCACHE::~THREADCACHE()
+{
+    MemoryAllocator::flushThreadCache(*this);
+}
 
 void* MemoryAllocator::mPool = NULL;
 size_t MemoryAllocator::mPoolSize = 0;
@@ -22,6 +79,10 @@ size_t MemoryAllocator::mPoolSize = 0;
 MemoryAllocator::MEMBLOCKHEADER* MemoryAllocator::mMemBlocks = NULL;
 uint64 MemoryAllocator::mWholeMemBlocksCount = 0u;
 
+uint32 MemoryAllocator::mFirstLevelBitmap = 0u;
+uint32 MemoryAllocator::mSecondLevelBitmaps[MemoryAllocator::FirstLevelCount] = { 0u, };
+MemoryAllocator::MEMBLOCKHEADER* MemoryAllocator::mFreeMemoryAreas[MemoryAllocator::FirstLevelCount][MemoryAllocator::SecondLevelCount] = { { nullptr, }, };
+
 //!---- MEMBLOCKHEADER
 MemoryAllocator::MEMBLOCKHEADER* MemoryAllocator::MEMBLOCKHEADER::splitMemoryArea(uint64 splitBlocks)
 {
@@ -68,6 +129,10 @@ void MemoryAllocator::Init()
     mPoolSize = NULL;
     mMemBlocks = NULL;
     mWholeMemBlocksCount = 0u;
+
+    mFirstLevelBitmap = 0u;
+    ::memset(mSecondLevelBitmaps, 0, sizeof(mSecondLevelBitmaps));
+    ::memset(mFreeMemoryAreas, 0, sizeof(mFreeMemoryAreas));
 }
 
 void MemoryAllocator::InitWithMemoryPool(size_t size)
@@ -79,45 +144,73 @@ void MemoryAllocator::InitWithMemoryPool(size_t size)
 
     mMemBlocks = reinterpret_cast< MEMBLOCKHEADER* >( mPool );
     mWholeMemBlocksCount = size / MemoryBlockSize;
-    LEASSERT( 1 <= mWholeMemBlocksCount );
+    LEASSERT( 2 <= mWholeMemBlocksCount );
+    LEASSERT( (mWholeMemBlocksCount < InvalidBlockIndex) && "memory pool is too large for 32bit block indices" );
+
+    mFirstLevelBitmap = 0u;
+    ::memset(mSecondLevelBitmaps, 0, sizeof(mSecondLevelBitmaps));
+    ::memset(mFreeMemoryAreas, 0, sizeof(mFreeMemoryAreas));
 
     MEMBLOCKHEADER* header = mMemBlocks;
     header->clear();
     header->memBlocks = mWholeMemBlocksCount - 1;
+    insertFreeMemoryArea(header);
 }
 
 void* MemoryAllocator::Alloc(size_t size, LimitEngineMemoryCategory category)
 {
-    Mutex::ScopedLock scopedLock(gMutexForMemoryAllocator);
     if (mPool == nullptr)
     {
         return Memory::Malloc(size);
     }
     else
     {
-        const uint64 newMemBlocks = GetSizeAlign(size, MemoryBlockSize) / MemoryBlockSize;
+        // Free areas need at least one payload block to hold their links and footer
+        // Rounded up without adding to size (size near max of size_t must not wrap to small area)
+        uint64 newMemBlocks = size / MemoryBlockSize + ((size % MemoryBlockSize) ? 1u : 0u);
 
-        MEMBLOCKHEADER* memAreaUnused = findUnusedMemoryArea(newMemBlocks);
-        if (memAreaUnused == nullptr)
+        if (newMemBlocks == 0u)
+            newMemBlocks = 1u;
+
+        MEMBLOCKHEADER* memArea = nullptr;
+        if (newMemBlocks <= ThreadCacheMaxMemBlocks)
+        {
+            // Small areas come from this thread's cache without taking the pool lock
+            static_assert(sizeof(gSizeClassIndices) / sizeof(gSizeClassIndices[0]) == ThreadCacheMaxMemBlocks + 1u, "size class table mismatch");
+            const uint32 sizeClass = gSizeClassIndices[newMemBlocks];
+            THREADCACHE &cache = sThreadCache;
+            if (cache.freeAreas[sizeClass] == nullptr) {
+                refillThreadCache(cache, sizeClass);
+            }
+            else {
+                cache.hitCount++;
+            }
+            memArea = cache.freeAreas[sizeClass];
+            if (memArea) {
+                cache.freeAreas[sizeClass] = *reinterpret_cast<MEMBLOCKHEADER**>(memArea + 1);
+                cache.freeAreaCounts[sizeClass]--;
+                memArea->inThreadCache = false;
+            }
+        }
+        else
+        {
+            ScopedAllocatorLock scopedLock;
+            memArea = allocMemoryArea(newMemBlocks);
+        }
+        if (memArea == nullptr)
         {
             DEBUG_MESSAGE("[MemoryAllocator] not enough memory!!!!!!!!!");
             return nullptr;
         }
+        memArea->category = static_cast<uint32>(category);
 
-        MEMBLOCKHEADER* nextArea = memAreaUnused->splitMemoryArea(newMemBlocks);
-        memAreaUnused->allocated = true;
-        memAreaUnused->category = static_cast<uint32>(category);
-
-        mStats.AllocatedMemory += (newMemBlocks + 1) * MemoryBlockSize;
-
-        void* retAddr = memAreaUnused + 1;
+        void* retAddr = memArea + 1;
         return retAddr;
     }
 }
 
 void MemoryAllocator::Free(void* ptr)
 {
-    Mutex::ScopedLock scopedLock(gMutexForMemoryAllocator);
     if (mPool == NULL) {
         Memory::Free(ptr);
     }
@@ -129,13 +222,26 @@ void MemoryAllocator::Free(void* ptr)
 
         MEMBLOCKHEADER* memArea = reinterpret_cast<MEMBLOCKHEADER*>(ptr) - 1;
 
-        mStats.AllocatedMemory -= memArea->memBlocks * MemoryBlockSize;
-
         LEASSERT(memArea->allocated && "[MemoryAllocator][Free]double free??");
+        LEASSERT(!memArea->inThreadCache && "[MemoryAllocator][Free]double free??");
 
-        memArea->allocated = false;
-
-        mergeUnusedMemoryAreaAll();
+        if (memArea->sizeClass)
+        {
+            // Return to this thread's cache, handing a batch back to the pool when it grows too large
+            const uint32 sizeClass = memArea->sizeClass - 1u;
+            THREADCACHE &cache = sThreadCache;
+            memArea->inThreadCache = true;
+            *reinterpret_cast<MEMBLOCKHEADER**>(memArea + 1) = cache.freeAreas[sizeClass];
+            cache.freeAreas[sizeClass] = memArea;
+            if (++cache.freeAreaCounts[sizeClass] > ThreadCacheMaxCount) {
+                releaseThreadCache(cache, sizeClass, ThreadCacheReleaseCount);
+            }
+        }
+        else
+        {
+            ScopedAllocatorLock scopedLock;
+            freeMemoryArea(memArea);
+        }
     }
 }
     
@@ -143,8 +249,9 @@ void MemoryAllocator::Term()
 {
     if (mPool == NULL)
         return;
+
+    flushThreadCache(sThreadCache);
         
-    mergeUnusedMemoryAreaAll();
 	uint32 memoryAreasCount = getMemoryAreasCount();
     LEASSERT( (1 == memoryAreasCount) && "[MemoryAllocator::Term] Leak!!!" );
         
@@ -156,23 +263,210 @@ void MemoryAllocator::Term()
     mPoolSize = 0;
 }
     
-MemoryAllocator::MEMBLOCKHEADER* MemoryAllocator::findUnusedMemoryArea(size_t requiredMemBlocks)
+MemoryAllocator::MEMBLOCKHEADER* MemoryAllocator::allocMemoryArea(uint64 newMemBlocks)
 {
-    MEMBLOCKHEADER* curAreaHeader = mMemBlocks;
-    const MEMBLOCKHEADER* endAddr = getMemoryEndAddr();
-    while (true)
-    {
-        if ((!curAreaHeader->allocated) && (requiredMemBlocks <= curAreaHeader->memBlocks))
-        {
-            return curAreaHeader;
-        }
+    MEMBLOCKHEADER* memAreaUnused = findUnusedMemoryArea(newMemBlocks);
+    if (memAreaUnused == nullptr)
+        return nullptr;
+
+    // Only split when the remainder can be a valid free area (header + one payload block)
+    if (newMemBlocks + 2 <= memAreaUnused->memBlocks) {
+        MEMBLOCKHEADER* nextArea = memAreaUnused->splitMemoryArea(newMemBlocks);
+        insertFreeMemoryArea(nextArea);
+    }
+    memAreaUnused->allocated = true;
+    memAreaUnused->sizeClass = 0u;
+    memAreaUnused->inThreadCache = false;
 
-        curAreaHeader = curAreaHeader->getNextMemoryArea();
-        if (endAddr <= curAreaHeader) {
+    mStats.AllocatedMemory += memAreaUnused->getWholeAreaBlocks() * MemoryBlockSize;
+
+    return memAreaUnused;
+}
+
+void MemoryAllocator::freeMemoryArea(MEMBLOCKHEADER *memArea)
+{
+    mStats.AllocatedMemory -= memArea->getWholeAreaBlocks() * MemoryBlockSize;
+
+    memArea->allocated = false;
+    memArea->category = 0u;
+    memArea->sizeClass = 0u;
+    memArea->inThreadCache = false;
+
+    // Coalesce with physical neighbours right away
+    MEMBLOCKHEADER* nextArea = memArea->getNextMemoryArea();
+    if (nextArea < getMemoryEndAddr() && !nextArea->allocated) {
+        removeFreeMemoryArea(nextArea);
+        memArea->mergeNextMemoryArea();
+    }
+    if (memArea->prevAreaFree) {
+        MEMBLOCKHEADER* prevArea = mMemBlocks + *(reinterpret_cast<uint64*>(memArea) - 1);
+        LEASSERT(!prevArea->allocated && prevArea->getNextMemoryArea() == memArea);
+        removeFreeMemoryArea(prevArea);
+        prevArea->mergeNextMemoryArea();
+        memArea = prevArea;
+    }
+    insertFreeMemoryArea(memArea);
+}
+
+void MemoryAllocator::refillThreadCache(THREADCACHE &cache, uint32 sizeClass)
+{
+    ScopedAllocatorLock scopedLock;
+    mStats.ThreadCacheMissCount++;
+    mStats.ThreadCacheHitCount += cache.hitCount;
+    cache.hitCount = 0u;
+    for (uint32 areaIndex = 0; areaIndex < ThreadCacheRefillCount; areaIndex++) {
+        MEMBLOCKHEADER* memArea = allocMemoryArea(gSizeClassMemBlocks[sizeClass]);
+        if (memArea == nullptr)
             break;
+        memArea->sizeClass = sizeClass + 1u;
+        memArea->inThreadCache = true;
+        *reinterpret_cast<MEMBLOCKHEADER**>(memArea + 1) = cache.freeAreas[sizeClass];
+        cache.freeAreas[sizeClass] = memArea;
+        cache.freeAreaCounts[sizeClass]++;
+    }
+}
+
+void MemoryAllocator::releaseThreadCache(THREADCACHE &cache, uint32 sizeClass, uint32 releaseCount)
+{
+    ScopedAllocatorLock scopedLock;
+    mStats.ThreadCacheHitCount += cache.hitCount;
+    cache.hitCount = 0u;
+    for (uint32 areaIndex = 0; areaIndex < releaseCount && cache.freeAreas[sizeClass]; areaIndex++) {
+        MEMBLOCKHEADER* memArea = cache.freeAreas[sizeClass];
+        cache.freeAreas[sizeClass] = *reinterpret_cast<MEMBLOCKHEADER**>(memArea + 1);
+        cache.freeAreaCounts[sizeClass]--;
+        freeMemoryArea(memArea);
+    }
+}
+
+void MemoryAllocator::flushThreadCache(THREADCACHE &cache)
+{
+    if (mPool == nullptr) {
+        // Pool is already gone, nothing to give back
+        // (not cache = THREADCACHE() : destructor of the temporary would flush again)
+        for (uint32 sizeClass = 0; sizeClass < SizeClassCount; sizeClass++) {
+            cache.freeAreas[sizeClass] = nullptr;
+            cache.freeAreaCounts[sizeClass] = 0u;
+        }
+        cache.hitCount = 0u;
+        return;
+    }
+    for (uint32 sizeClass = 0; sizeClass < SizeClassCount; sizeClass++) {
+        if (cache.freeAreas[sizeClass]) {
+            releaseThreadCache(cache, sizeClass, cache.freeAreaCounts[sizeClass]);
         }
     }
-    return NULL;
+}
+
+void MemoryAllocator::mappingInsert(uint64 memBlocks, uint32 &firstLevel, uint32 &secondLevel)
+{
+    if (memBlocks < SecondLevelCount) {
+        firstLevel = 0u;
+        secondLevel = static_cast<uint32>(memBlocks);
+    }
+    else {
+        const uint32 lastBit = FindLastSetBit(static_cast<uint32>(memBlocks));
+        firstLevel = lastBit - SecondLevelIndexBits + 1u;
+        secondLevel = static_cast<uint32>(memBlocks >> (lastBit - SecondLevelIndexBits)) ^ SecondLevelCount;
+    }
+}
+
+void MemoryAllocator::mappingSearch(uint64 memBlocks, uint32 &firstLevel, uint32 &secondLevel)
+{
+    // Larger than any area (block index is 32bit), checked before bits of it are narrowed to 32bit
+    if (memBlocks >= InvalidBlockIndex) {
+        firstLevel = FirstLevelCount;
+        secondLevel = 0u;
+        return;
+    }
+    // Round up to the next list so that any area found there is large enough
+    if (memBlocks >= SecondLevelCount) {
+        memBlocks += (1ull << (FindLastSetBit(static_cast<uint32>(memBlocks)) - SecondLevelIndexBits)) - 1u;
+    }
+    if (memBlocks >= InvalidBlockIndex) {
+        firstLevel = FirstLevelCount;
+        secondLevel = 0u;
+        return;
+    }
+    mappingInsert(memBlocks, firstLevel, secondLevel);
+}
+
+void MemoryAllocator::insertFreeMemoryArea(MEMBLOCKHEADER *memArea)
+{
+    LEASSERT(!memArea->allocated && 1u <= memArea->memBlocks);
+
+    uint32 firstLevel, secondLevel;
+    mappingInsert(memArea->memBlocks, firstLevel, secondLevel);
+
+    const uint32 areaIndex = getMemoryAreaIndex(memArea);
+    MEMBLOCKHEADER* headArea = mFreeMemoryAreas[firstLevel][secondLevel];
+    MEMBLOCKHEADER::FREELINK* link = memArea->getFreeLink();
+    link->nextFreeIndex = headArea ? getMemoryAreaIndex(headArea) : InvalidBlockIndex;
+    link->prevFreeIndex = InvalidBlockIndex;
+    if (headArea) {
+        headArea->getFreeLink()->prevFreeIndex = areaIndex;
+    }
+    mFreeMemoryAreas[firstLevel][secondLevel] = memArea;
+    mFirstLevelBitmap |= 1u << firstLevel;
+    mSecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+
+    *memArea->getFooter() = areaIndex;
+    MEMBLOCKHEADER* nextArea = memArea->getNextMemoryArea();
+    if (nextArea < getMemoryEndAddr()) {
+        nextArea->prevAreaFree = true;
+    }
+}
+
+void MemoryAllocator::removeFreeMemoryArea(MEMBLOCKHEADER *memArea)
+{
+    uint32 firstLevel, secondLevel;
+    mappingInsert(memArea->memBlocks, firstLevel, secondLevel);
+
+    MEMBLOCKHEADER::FREELINK* link = memArea->getFreeLink();
+    if (link->nextFreeIndex != InvalidBlockIndex) {
+        mMemBlocks[link->nextFreeIndex].getFreeLink()->prevFreeIndex = link->prevFreeIndex;
+    }
+    if (link->prevFreeIndex != InvalidBlockIndex) {
+        mMemBlocks[link->prevFreeIndex].getFreeLink()->nextFreeIndex = link->nextFreeIndex;
+    }
+    else {
+        LEASSERT(mFreeMemoryAreas[firstLevel][secondLevel] == memArea);
+        mFreeMemoryAreas[firstLevel][secondLevel] = (link->nextFreeIndex != InvalidBlockIndex) ? &mMemBlocks[link->nextFreeIndex] : nullptr;
+        if (mFreeMemoryAreas[firstLevel][secondLevel] == nullptr) {
+            mSecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+            if (mSecondLevelBitmaps[firstLevel] == 0u) {
+                mFirstLevelBitmap &= ~(1u << firstLevel);
+            }
+        }
+    }
+
+    MEMBLOCKHEADER* nextArea = memArea->getNextMemoryArea();
+    if (nextArea < getMemoryEndAddr()) {
+        nextArea->prevAreaFree = false;
+    }
+}
+
+MemoryAllocator::MEMBLOCKHEADER* MemoryAllocator::findUnusedMemoryArea(size_t requiredMemBlocks)
+{
+    uint32 firstLevel, secondLevel;
+    mappingSearch(requiredMemBlocks, firstLevel, secondLevel);
+    if (firstLevel >= FirstLevelCount)
+        return NULL;
+
+    uint32 secondLevelMap = mSecondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+    if (secondLevelMap == 0u) {
+        const uint32 firstLevelMap = mFirstLevelBitmap & (~0u << (firstLevel + 1u));
+        if (firstLevelMap == 0u)
+            return NULL;
+        firstLevel = FindFirstSetBit(firstLevelMap);
+        secondLevelMap = mSecondLevelBitmaps[firstLevel];
+    }
+    secondLevel = FindFirstSetBit(secondLevelMap);
+
+    MEMBLOCKHEADER* foundArea = mFreeMemoryAreas[firstLevel][secondLevel];
+    LEASSERT(foundArea && requiredMemBlocks <= foundArea->memBlocks);
+    removeFreeMemoryArea(foundArea);
+    return foundArea;
 }
     
 uint64 MemoryAllocator::getMemoryAreasCount()
@@ -184,33 +478,11 @@ uint64 MemoryAllocator::getMemoryAreasCount()
     {
         ++areasCount;
         curArea = curArea->getNextMemoryArea();
-        if (curArea->allocated) {
+        if (curArea < memEnd && curArea->allocated) {
             DEBUG_MESSAGE("[MemoryAllocator] MemoryLeak : category %s size %d address %llx (%llx)\n", LimitEngineMemoryCategoryName[curArea->category], static_cast<int>(curArea->memBlocks * MemoryBlockSize), static_cast<uint64>(intptr_t(curArea + 1) - intptr_t(mPool)), static_cast<uint64>(intptr_t(curArea + 1)));
         }
     }
         
     return areasCount;
 }
-    
-void MemoryAllocator::mergeUnusedMemoryAreaAll()
-{
-    MEMBLOCKHEADER* curArea = mMemBlocks;
-    const MEMBLOCKHEADER* memEnd = getMemoryEndAddr();
-    while ( curArea < memEnd )
-    {
-        if ( memEnd <= curArea->getNextMemoryArea() ) break;
-            
-        const bool canMergeNext = (!curArea->allocated) && curArea->canMergeNextMemoryArea();
-            
-        if ( canMergeNext )
-        {
-            LEASSERT( !curArea->allocated );
-            curArea->mergeNextMemoryArea();
-        }
-        else
-        {
-            curArea = curArea->getNextMemoryArea();
-        }
-    }
 }
-}
\ No newline at end of file
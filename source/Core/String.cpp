@@ -15,47 +15,44 @@
 
 namespace LimitEngine {
     template<> Archive& Archive::operator << (String &InString) {
-        uint32 length = InString.mBuffer?static_cast<uint32>(strlen(InString.mBuffer)):0u;
+        uint32 length = static_cast<uint32>(InString.GetLength());
         *this << length;
         if (length) {
             if (IsLoading()) {
-                InString.mBuffer = (char*)malloc(length + 1);
-                ::memcpy(InString.mBuffer, GetData(length + 1), length + 1);
+                InString.Assign(static_cast<const char*>(GetData(length + 1)), length);
             }
             else {
-                ::memcpy(AddSize(length + 1), InString.mBuffer, length + 1);
+                ::memcpy(AddSize(length + 1), InString.GetCharPtr(), length + 1);
             }
         }
         return *this;
     }
 	String::String(const char *str)
-		: mBuffer(NULL)
 	{
+        initEmpty();
 		if (str)
-		{
-			size_t strlen = ::strlen(str);
-			mBuffer = (char *)malloc(strlen+1);
-			memcpy(mBuffer, str, strlen+1);
-		}
+            Assign(str, ::strlen(str));
 	}
 	String::String(const String &str)
-		: mBuffer(NULL)
 	{
-		size_t length = str.GetLength();
-		if (length)
-		{
-			mBuffer = (char *)malloc(length+1);
-			memcpy(mBuffer, str.GetCharPtr(), length+1);
-		}
+        initEmpty();
+        Assign(str.GetCharPtr(), str.GetLength());
 	}
+    String::String(String &&str)
+    {
+        moveFrom(str);
+    }
+    String::String(const char *str, size_t length)
+    {
+        initEmpty();
+        Assign(str, length);
+    }
     String::String(const float &f)
-		: mBuffer(NULL)
     {
         char buf[256];
         sprintf_s<256>(buf, "%f", f);
-        char *buffer = (char *)malloc(strlen(buf) + 1);
-        ::memcpy(buffer, buf, strlen(buf)+1);
-        mBuffer = buffer;
+        initEmpty();
+        Assign(buf, ::strlen(buf));
     }
 	String::~String()
 	{
@@ -63,18 +60,91 @@ namespace LimitEngine {
 	}
 	void String::Release()
 	{
-		if (mBuffer) free(mBuffer);
-		mBuffer = NULL;
+		if (!isInline()) free(mHeap.buffer);
+        initEmpty();
 	}
+    void String::Reserve(size_t capacity)
+    {
+        if (capacity <= GetCapacity())
+            return;
+        const size_t length = GetLength();
+        char *buffer = (char *)malloc(capacity + 1);
+        ::memcpy(buffer, GetCharPtr(), length + 1);
+        if (!isInline()) free(mHeap.buffer);
+        mHeap.buffer = buffer;
+        mHeap.length = static_cast<uint32>(length);
+        mHeap.capacity = static_cast<uint32>(capacity);
+        mInline[InlineCapacity + 1] = static_cast<char>(HeapMarker);
+    }
+    void String::Assign(const char *str, size_t length)
+    {
+        if (length > GetCapacity()) {
+            // Old contents are not needed
+            Release();
+            Reserve(length);
+        }
+        // memmove : str can be a part of this string
+        if (length)
+            ::memmove(GetCharPtr(), str, length);
+        setLength(length);
+    }
+    void String::Append(const char *str, size_t length)
+    {
+        if (length == 0)
+            return;
+        const size_t oldLength = GetLength();
+        const size_t newLength = oldLength + length;
+        if (newLength > GetCapacity()) {
+            const char *oldBuffer = GetCharPtr();
+            const bool isOwnData = str >= oldBuffer && str < oldBuffer + oldLength;
+            const size_t strOffset = str - oldBuffer;
+            const size_t grownCapacity = GetCapacity() * 2;
+            Reserve(newLength > grownCapacity ? newLength : grownCapacity);
+            if (isOwnData)
+                str = GetCharPtr() + strOffset;
+        }
+        ::memmove(GetCharPtr() + oldLength, str, length);
+        setLength(newLength);
+    }
+    void String::Truncate(size_t length)
+    {
+        if (length < GetLength())
+            setLength(length);
+    }
+    void String::initEmpty()
+    {
+        mInline[0] = 0;
+        mInline[InlineCapacity + 1] = 0;
+    }
+    void String::setLength(size_t length)
+    {
+        if (isInline()) {
+            LEASSERT(length <= InlineCapacity);
+            mInline[length] = 0;
+            mInline[InlineCapacity + 1] = static_cast<char>(length);
+        }
+        else {
+            LEASSERT(length <= mHeap.capacity);
+            mHeap.buffer[length] = 0;
+            mHeap.length = static_cast<uint32>(length);
+        }
+    }
+    void String::moveFrom(String &str)
+    {
+        // Inline characters and heap pointer are both just bytes of union
+        ::memcpy(mInline, str.mInline, sizeof(mInline));
+        str.initEmpty();
+    }
 	uint32	String::FindWord(const String &str) const
 	{
 		size_t length = GetLength();
 		size_t targetLength = str.GetLength();
 		if(length == 0 || targetLength == 0 || length < targetLength) return -1;
 
+        const char *buffer = GetCharPtr();
 		for(uint32 cur=0;cur<=length-targetLength;cur++) {
-			if(mBuffer[cur] == str.GetCharPtr()[0]) {
-				if(strncmp(mBuffer + cur, str.GetCharPtr(), targetLength)==0) {
+			if(buffer[cur] == str.GetCharPtr()[0]) {
+				if(memcmp(buffer + cur, str.GetCharPtr(), targetLength)==0) {
 					return cur;
 				}
 			}
@@ -87,41 +157,30 @@ namespace LimitEngine {
 	}
 	String String::Replace(const String &str, const String &tar) 
 	{
-		String output(*this);
 		uint32 foundPos = FindWord(str);
-		uint32 srcLength = static_cast<uint32>(GetLength());
-		uint32 strLength = static_cast<uint32>(str.GetLength());
-		uint32 tarLength = static_cast<uint32>(tar.GetLength());
-		if(foundPos < GetLength()) {
-			output.GetCharPtr()[foundPos] = 0; // Cut tail
+		if(foundPos >= GetLength())
+            return *this;
 
-			if(tarLength) {
-				if(foundPos + strLength >= srcLength) {
-					output += tar;
-				}
-				else {
-					output += tar;
-					output += GetCharPtr()[foundPos + strLength];
-				}
-			} else {
-				if(foundPos + strLength < srcLength)
-					output += &(GetCharPtr()[foundPos + strLength]);
-			}
-		}
+		size_t srcLength = GetLength();
+		size_t strLength = str.GetLength();
+		String output;
+        output.Reserve(srcLength - strLength + tar.GetLength());
+        output.Append(GetCharPtr(), foundPos);
+        output.Append(tar.GetCharPtr(), tar.GetLength());
+        output.Append(GetCharPtr() + foundPos + strLength, srcLength - foundPos - strLength);
 		return output;
 	}
     void String::Split(const String &SplitWord, String &A, String &B) const
     {
-        int32 splitWordPosition = FindWord(SplitWord);
-        if (splitWordPosition >= 0) {
-            char *TempBuffer = GetCopiedCharPtr();
-            TempBuffer[splitWordPosition] = 0;
-            A = TempBuffer;
-            B =&TempBuffer[splitWordPosition + 1];
+        uint32 splitWordPosition = FindWord(SplitWord);
+        if (splitWordPosition < GetLength()) {
+            const String source(*this);   // A or B can be this
+            A.Assign(source.GetCharPtr(), splitWordPosition);
+            B.Assign(source.GetCharPtr() + splitWordPosition + 1, source.GetLength() - splitWordPosition - 1);
         }
         else {
             A = *this;
             B = "";
         }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,40 @@
+/*****************************************************************************
+ LIMITEngine Source File
+ Copyright (C), LIMITGAME, 2020
+ -----------------------------------------------------------
+ * @file	StringID.cpp
+ * @brief	Table of interned names
+ * @author	minseob
+ *****************************************************************************/
+
+#include "Core/StringID.h"
+
+#include "Core/Mutex.h"
+#include "Containers/MapArray.h"
+
+namespace LimitEngine {
+    static Mutex gMutexForStringIDTable;
+    static MapArray<StringID, String> gStringIDTable;
+
+    String StringID::GetName() const
+    {
+        Mutex::ScopedLock scopedLock(gMutexForStringIDTable);
+        if (const String *name = gStringIDTable.Find(*this))
+            return *name;
+        return String();
+    }
+    void StringID::TerminateTable()
+    {
+        Mutex::ScopedLock scopedLock(gMutexForStringIDTable);
+        gStringIDTable.Clear();
+    }
+    void StringID::registerName(const char *Name, size_t Length) const
+    {
+        Mutex::ScopedLock scopedLock(gMutexForStringIDTable);
+        String &name = gStringIDTable.FindOrCreate(*this, String());
+        if (name.GetLength() == 0u)
+            name.Assign(Name, Length);
+        else // Different names with same hash
+            LEASSERT(name.GetLength() == Length && ::memcmp(name.GetCharPtr(), Name, Length) == 0);
+    }
+}
@@ -160,12 +160,11 @@ void TextParser::NODE::Save(FILE *fp, int indent)
     }
 }
 
-TextParser::NODE* TextParser::GetNode(const char *name)
+TextParser::NODE* TextParser::GetNode(const StringID &id)
 {
     for(uint32 n=0;n<mNodes.count();n++)
     {
-        if (mNodes[n]->name == name) return mNodes[n];
-        mNodes[n]->FindChild(name);
+        if (mNodes[n]->nameID == id) return mNodes[n];
     }
     return NULL;
 }
@@ -173,7 +172,8 @@ TextParser::NODE* TextParser::GetNode(const char *name)
 void TextParser::addNewNode(NODE *Parent, const char *NodeName, NODE **OutNode)
 {
     *OutNode = new NODE();
-    (*OutNode)->name = NodeName;
+    if (NodeName)
+        (*OutNode)->SetName(NodeName, static_cast<uint32>(::strlen(NodeName)));
     (*OutNode)->parent = Parent;
     if (Parent) Parent->children.Add(*OutNode);
     else mNodes.Add(*OutNode);
@@ -184,12 +184,12 @@ void TextParser::inputData(NODE *parent, NODE **node, char *buf, uint32 length,
     if (length)
     {
         if (*node) {
-            (*node)->values.Add(buf);
+            (*node)->values.EmplaceBack(buf, length);
             if (!sequenceIn) *node = NULL;
         }
         else {
             *node = new NODE();
-            (*node)->name = buf;
+            (*node)->SetName(buf, length);
             (*node)->parent = parent;
             if (parent) parent->children.Add(*node);
             else mNodes.Add(*node);
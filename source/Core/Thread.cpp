@@ -8,6 +8,8 @@ Copyright (C), LIMITGAME, 2020
 ***********************************************************/
 #ifdef WINDOWS
 #include "../Platform/Windows/ThreadImpl_Windows.inl"
+#elif defined(LINUX)
+#include "../Platform/Linux/ThreadImpl_Linux.inl"
 #else
-#error No implementation for Event
+#error No implementation for Thread
 #endif
\ No newline at end of file
@@ -11,6 +11,10 @@
 
 #include "Core/Timer.h"
 
+#if defined(LINUX)
+#include <time.h>
+#endif
+
 namespace LimitEngine {
 #if defined(WINDOWS)
     uint64 Timer::GetTimeUSec()
@@ -32,6 +36,19 @@ namespace LimitEngine {
 
         return static_cast<double>(cycles.QuadPart) / static_cast<double>(frequency.QuadPart);
     }
+#elif defined(LINUX)
+    uint64 Timer::GetTimeUSec()
+    {
+        struct timespec counter;
+        clock_gettime(CLOCK_MONOTONIC, &counter);
+        return static_cast<uint64>(counter.tv_sec) * 1000000 + counter.tv_nsec / 1000;
+    }
+    double Timer::GetTimeDoubleSecond()
+    {
+        struct timespec counter;
+        clock_gettime(CLOCK_MONOTONIC, &counter);
+        return static_cast<double>(counter.tv_sec) + static_cast<double>(counter.tv_nsec) * 1e-9;
+    }
 #elif defined(IOS) || defined(ANDROID)
     uint64 Timer::GetTimeUSec()
     {
@@ -31,6 +31,7 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "Core/AutoPointer.h"
 #include "Core/Common.h"
 #include "Core/Debug.h"
+#include "Core/StringID.h"
 #include "Core/TaskPriority.h"
 #include "Factories/ArchiveFactory.h"
 #include "Factories/TextureFactory.h"
@@ -44,11 +45,12 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "Renderer/Font.h"
 #include "Renderer/SamplerState.h"
 #include "Renderer/PipelineState.h"
+#include "Renderer/PipelineStateCache.h"
 
 namespace LimitEngine {
 // =============================================================
 // Main
-LimitEngine* LimitEngine::mInstance = NULL;
+template<> LimitEngine* Singleton<LimitEngine>::mInstance = NULL;
 void LimitEngine::Init(WINDOW_HANDLE handle, const InitializeOptions &Options)
 {
 	mSceneManager->Init(Options);
@@ -111,7 +113,9 @@ void LimitEngine::Term()
 	mTaskManager->Term();
 	mShaderManager->Term();
 
+    PipelineStateCache::Terminate();
     SamplerState::TerminateCache();
+    StringID::TerminateTable();
 }
 void LimitEngine::SetResourceRootPath(const char *RootPath)
 {
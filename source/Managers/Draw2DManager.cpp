@@ -22,7 +22,7 @@
 #include "Shaders/Draw2D.ps.h"
 
 namespace LimitEngine {
-    Draw2DManager* Draw2DManager::mInstance = nullptr;
+    template<> Draw2DManager* SingletonDraw2DManager::mInstance = nullptr;
     Draw2DManager::Draw2DManager()
         : SingletonDraw2DManager()
         , mVertex_draw2d_used(0u)
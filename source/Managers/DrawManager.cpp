@@ -36,6 +36,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "../Platform/DirectX11/DrawManagerImpl_DirectX11.inl"
 #elif defined(USE_DX12)
 #include "../Platform/DirectX12/DrawManagerImpl_DirectX12.inl"
+#elif defined(USE_NULL)
+#include "../Platform/Null/DrawManagerImpl_Null.inl"
 #elif defined(USE_OPENGLES)
 #include "Platform/OpenGLES/DrawManagerImpl_OpenGLES.h"
 #else
@@ -51,7 +53,9 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 namespace LimitEngine
 {
-    DrawManager* SingletonDrawManager::mInstance = NULL;
+    static_assert(FrameAllocator::FrameCount > DrawManager::MaxFrameLatency, "Frame area is reused while drawing thread flushes its frame");
+
+    template<> DrawManager* SingletonDrawManager::mInstance = NULL;
 
     DrawManager::DrawManager()
         : SingletonDrawManager()
@@ -64,8 +68,13 @@ namespace LimitEngine
         , mDrawThread(nullptr)
         , mDrawThreadExitCode(false)
         , mDrawEvent("DrawEvent")
-        , mReadyCommandBufferEvent("ReadyCommandBuffer")
-        , mCommandFlushMutex()
+        , mFrameCompletedEvent("FrameCompleted")
+        , mFrameLatency(1u)
+        , mSubmittedFrameFence(0u)
+        , mCompletedFrameFence(0u)
+        , mFrameStatistics()
+        , mFrameFenceMutex()
+        , mFramePacer(FramePacer::Mode::FixedRate, 60.0)
         , mInitialized(false)
         , mSceneBegan(false)
         , mModelDrawingBegan(false)
@@ -83,9 +92,11 @@ namespace LimitEngine
     DrawManager::~DrawManager()
     {
         if (mDrawThread) {
-            mDrawThreadExitCode = true;
-            FlushCommand();
-            WaitForFlushing();
+            {   // Drawing thread exits after flushing submitted frames
+                Mutex::ScopedLock scopedLock(mFrameFenceMutex);
+                mDrawThreadExitCode = true;
+            }
+            mDrawEvent.Signal();
             if(mDrawThread->Join()) {
                 delete mDrawThread;
             }
@@ -112,6 +123,8 @@ namespace LimitEngine
             mDraw2DManager->Term();
             delete mDraw2DManager;
         }
+
+        FrameAllocator::Term();
     }
 
     void DrawManager::Init(WINDOW_HANDLE handle, const InitializeOptions &Options)
@@ -122,6 +135,8 @@ namespace LimitEngine
         mImpl = new DrawManagerImpl_DirectX11();
 #elif defined(USE_DX12)
         mImpl = new DrawManagerImpl_DirectX12();
+#elif defined(USE_NULL)
+        mImpl = new DrawManagerImpl_Null();
 #elif defined(USE_OPENGLES)
         mImpl = new DrawManagerImpl_OpenGLES();
 #else
@@ -129,11 +144,16 @@ namespace LimitEngine
 #endif
         mRenderContext = new RenderContext();
 
+        FrameAllocator::Init();
+
         mImpl->Init(handle, Options);
         mDraw2DManager->Init();
 
         mCommandBuffer->Init(mImpl->MakeInitParameter());
 
+        SetFrameLatency(Options.FrameLatency);
+        mFramePacer.SetMode(Options.FramePacing, Options.FrameRate);
+
         ThreadParam threadParameter;
         threadParameter.func = ThreadFunction(this, &DrawManager::FlushCommandThread);
         threadParameter.name = "DrawCommand";
@@ -157,13 +177,17 @@ namespace LimitEngine
         // Ready to render
         mImpl->ReadyToRender();
 
-        // Wait for frame
-        WaitForFlushing();
-
+        // Resources used by commands of this frame are made before drawing thread gets them
         runRendererTasks();
 
         // Run drawing commands
         FlushCommand();
+
+        // Wait for frame
+        WaitForFlushing();
+
+        // Previous frames have retired, recycle their transient memory
+        FrameAllocator::BeginFrame(mFrameCounter);
     }
 
     void DrawManager::DrawEnd()
@@ -186,66 +210,132 @@ namespace LimitEngine
     }
     void DrawManager::FlushCommandThread()
     {
-        static constexpr double frameLimitTime = 1.0/60.0; // 16ms (60fps)
-
-        double lastTime = Timer::GetTimeDoubleSecond();
         while (1)
         {
-            if (mDrawThreadExitCode) {
-                mReadyCommandBufferEvent.Signal();
-                break;
+            // Wait for submitted frame
+            const uint64 waitBeginTime = Timer::GetTimeUSec();
+            bool exitThread = false;
+            while (1) {
+                {
+                    Mutex::ScopedLock scopedLock(mFrameFenceMutex);
+                    if (mCompletedFrameFence < mSubmittedFrameFence)
+                        break;
+                    if (mDrawThreadExitCode) {
+                        exitThread = true;
+                        break;
+                    }
+                }
+                mDrawEvent.Wait();
             }
-            mDrawEvent.Wait();
-            mReadyCommandBufferEvent.Signal();
+            if (exitThread)
+                break;
+            const uint64 flushBeginTime = Timer::GetTimeUSec();
 
-            mCommandBuffer->LockWriteCommandBuffer();
-            Mutex::ScopedLock scopedLock(mCommandFlushMutex);
-            if (mCommandBuffer) {
-                mCommandBuffer->Flush(mRenderState);
+            if (mImpl) {
+                mImpl->ProcessBeforeFlushingCommands();
             }
-            double time = Timer::GetTimeDoubleSecond();
-            double elapsedTime = time - lastTime;
-#ifdef WINDOWS
-            DWORD sleepTime = 0u;
-            if (elapsedTime < frameLimitTime)
-                sleepTime = static_cast<DWORD>((frameLimitTime - elapsedTime) * 1000);
-            if (sleepTime)
-                Sleep(sleepTime);
-#endif
-            lastTime = time;
+            mCommandBuffer->FlushFrame(mRenderState);
+            mCommandBuffer->RetireRendererResources();
+
+            const uint64 flushEndTime = Timer::GetTimeUSec();
+            {
+                Mutex::ScopedLock scopedLock(mFrameFenceMutex);
+                mCompletedFrameFence++;
+                mFrameStatistics.CompletedFrames = mCompletedFrameFence;
+                mFrameStatistics.LastDrawThreadWaitUSec = flushBeginTime - waitBeginTime;
+                mFrameStatistics.TotalDrawThreadWaitUSec += mFrameStatistics.LastDrawThreadWaitUSec;
+                mFrameStatistics.LastFlushUSec = flushEndTime - flushBeginTime;
+                mFrameStatistics.TotalFlushUSec += mFrameStatistics.LastFlushUSec;
+            }
+            mFrameCompletedEvent.Signal();
+
+            mFramePacer.WaitForNextFrame();
         }
     }
     void DrawManager::runRendererTasks()
     {
-        Mutex::ScopedLock lock(mRendererTaskMutex);
-        for (uint32 rtidx = 0; rtidx < mRendererTasks.size(); rtidx++) {
-            if (mRendererTasks[rtidx]) {
-                mRendererTasks[rtidx]->Run();
-                delete mRendererTasks[rtidx];
-            }
+        // Tasks added while running go to next frame
+        RendererTask *task = mRendererTasks.PopAll();
+        while (task) {
+            RendererTask *nextTask = task->mNextTask;
+            task->Run();
+            delete task;
+            task = nextTask;
         }
-        mRendererTasks.Clear();
 
         mCommandBuffer->ReleaseRendererResources();
     }
     // Run all of drawing commands
-    void DrawManager::FlushCommand()
+    uint64 DrawManager::FlushCommand()
     {
+        uint64 frameFence = 0u;
+        {
+            Mutex::ScopedLock scopedLock(mFrameFenceMutex);
+            mCommandBuffer->MarkFrameEnd();
+            frameFence = ++mSubmittedFrameFence;
+            mFrameStatistics.SubmittedFrames = mSubmittedFrameFence;
+            mFrameStatistics.PeakFramesInFlight = MAX(mFrameStatistics.PeakFramesInFlight, static_cast<uint32>(mSubmittedFrameFence - mCompletedFrameFence));
+        }
         // Run commandbuffer
         mDrawEvent.Signal();
 
         mDraw2DManager->EndOfFrame();
 
-        // Sync flushcommandthread
-        mReadyCommandBufferEvent.Wait();
+        return frameFence;
     }
     void DrawManager::WaitForFlushing()
     {
-        Mutex::ScopedLock scopedLock(mCommandFlushMutex);
-        if (mImpl) {
-            mImpl->ProcessBeforeFlushingCommands();
+        uint64 frameFence = 0u;
+        {
+            Mutex::ScopedLock scopedLock(mFrameFenceMutex);
+            if (mSubmittedFrameFence > mFrameLatency)
+                frameFence = mSubmittedFrameFence - mFrameLatency;
+        }
+        const uint64 waitBeginTime = Timer::GetTimeUSec();
+        WaitForFrameFence(frameFence);
+        const uint64 waitTime = Timer::GetTimeUSec() - waitBeginTime;
+
+        Mutex::ScopedLock scopedLock(mFrameFenceMutex);
+        mFrameStatistics.LastGameThreadWaitUSec = waitTime;
+        mFrameStatistics.TotalGameThreadWaitUSec += waitTime;
+        mFrameStatistics.MaxGameThreadWaitUSec = MAX(mFrameStatistics.MaxGameThreadWaitUSec, waitTime);
+    }
+    void DrawManager::WaitForFrameFence(uint64 FrameFence)
+    {
+        while (GetCompletedFrameFence() < FrameFence) {
+            mFrameCompletedEvent.Wait();
         }
     }
+    uint64 DrawManager::GetCompletedFrameFence()
+    {
+        Mutex::ScopedLock scopedLock(mFrameFenceMutex);
+        return mCompletedFrameFence;
+    }
+    void DrawManager::SetFrameLatency(uint32 Latency)
+    {
+        Mutex::ScopedLock scopedLock(mFrameFenceMutex);
+        mFrameLatency = Latency;
+        if (mFrameLatency < 1u)
+            mFrameLatency = 1u;
+        if (mFrameLatency > MaxFrameLatency)
+            mFrameLatency = MaxFrameLatency;
+        mFrameStatistics.FrameLatency = mFrameLatency;
+    }
+    DrawManager::FrameStatistics DrawManager::GetFrameStatistics()
+    {
+        Mutex::ScopedLock scopedLock(mFrameFenceMutex);
+        return mFrameStatistics;
+    }
+    void DrawManager::ResetFrameStatistics()
+    {
+        Mutex::ScopedLock scopedLock(mFrameFenceMutex);
+        FrameStatistics statistics;
+        statistics.SubmittedFrames = mSubmittedFrameFence;
+        statistics.CompletedFrames = mCompletedFrameFence;
+        statistics.FrameLatency = mFrameLatency;
+        statistics.PeakFramesInFlight = static_cast<uint32>(mSubmittedFrameFence - mCompletedFrameFence);
+        mFrameStatistics = statistics;
+    }
     LEMath::FloatPoint DrawManager::getJitterPosition(uint32 Index, uint32 NumOfSamples)
     {
         switch (NumOfSamples)
@@ -20,7 +20,7 @@
 #include "PostProcessors/PostProcessResolveFinalColor.h"
 
 namespace LimitEngine {
-PostProcessManager* PostProcessManager::mInstance = nullptr;
+template<> PostProcessManager* SingletonPostProcessManager::mInstance = nullptr;
 PostProcessManager::PostProcessManager()
     : SingletonPostProcessManager()
 {
@@ -12,7 +12,7 @@
 #include "Renderer/Texture.h"
 
 namespace LimitEngine {
-RenderTargetPoolManager* RenderTargetPoolManager::mInstance = nullptr;
+template<> RenderTargetPoolManager* SingletonRenderTargetPoolManager::mInstance = nullptr;
 PooledRenderTarget::PooledRenderTarget(const PooledRenderTarget &RenderTarget)
 : mTexture(RenderTarget.mTexture), mDesc(RenderTarget.mDesc)
 {
@@ -28,14 +28,16 @@
 #include "IOS/LE_ResourceLoader_IOS.h"
 #elif defined(WINDOWS)
 #include "../Platform/Windows/ResourceLoader_Windows.inl"
+#elif defined(LINUX)
+#include "../Platform/Linux/ResourceLoader_Linux.inl"
 #else
 #error no implemented ResourceLoader for this platform.
 #endif
 
 namespace LimitEngine {
 	String ResourceManager::mRootPath;
-#ifdef WIN32
-	ResourceManager* SingletonResourceManager::mInstance = NULL;
+#if defined(WIN32) || defined(LINUX)
+	template<> ResourceManager* SingletonResourceManager::mInstance = NULL;
 #endif
 	MapArray<String, String> ResourceManager::mPathTable;
 
@@ -65,6 +67,8 @@ namespace LimitEngine {
         m_Loader = new ResourceLoader_IOS();
 #elif defined(WINDOWS)
         mLoader = new ResourceLoader_Windows();
+#elif defined(LINUX)
+        mLoader = new ResourceLoader_Linux();
 #else
 #error no implemented ResourceLoader for this platform.
 #endif
@@ -126,7 +130,7 @@ namespace LimitEngine {
         size_t length = ::strlen(filename);
         String convertWord;
         bool inTag = false;
-        if (!mRootPath.IsEmpty()) convertedPath += "\\";
+        if (!mRootPath.IsEmpty()) convertedPath += "/";
         for (size_t i=0;i<length;i++)
         {
             if (filename[i] == '<')
@@ -141,7 +145,7 @@ namespace LimitEngine {
                 if ((tagIndex = mPathTable.FindIndex(convertWord)) >= 0)
                 {
                     convertedPath += mPathTable.GetAt(tagIndex).value;
-					convertedPath += "\\";
+					convertedPath += "/";
                 }
                 convertWord = "";
                 continue;
@@ -76,10 +76,7 @@ public:
     {}
     void Run(SceneManager *Manager) override
     {
-        ModelInstRefPtr FoundModel = Manager->findModelInstance(mInstanceID);
-        if (FoundModel.IsValid()) {
-            FoundModel->SetTransform(mTransform);
-        }
+        Manager->UpdateModelTransform_UpdateTask(mInstanceID, mTransform);
     }
 };
 
@@ -107,11 +104,13 @@ public:
     }
 };
 
-#ifdef WIN32
-SceneManager* SingletonSceneManager::mInstance = NULL;
+#if defined(WIN32) || defined(LINUX)
+template<> SceneManager* SingletonSceneManager::mInstance = NULL;
 #endif
 SceneManager::SceneManager()
     : mCamera(new Camera())
+    , mFrustumCullingEnabled(true)
+    , mModelBVHDirty(false)
     , mEnvironmentLight(nullptr)
     , mCurrentInstanceID(1u)
     , mBackgroundType(BackgroundImageType::None)
@@ -189,7 +188,24 @@ void SceneManager::SetBackgroundImage(const TextureRefPtr &BackgroundImage, Back
 
 void SceneManager::AddModel_UpdateTask(Model *InModel, uint32 InID)
 {
+    Mutex::ScopedLock lock(mModelBVHMutex);
     mModels.push_back(new ModelInstance(InID, InModel));
+    mModelBVHDirty = true;
+}
+
+void SceneManager::UpdateModelTransform_UpdateTask(uint32 InstanceID, const Transform &InTransform)
+{
+    const uint32 modelIndex = findModelIndex(InstanceID);
+    if (modelIndex == BoundingVolumeHierarchy::InvalidIndex)
+        return;
+    ModelInstance *modelInstance = mModels[modelIndex].Get();
+    modelInstance->SetTransform(InTransform);
+    const AABB &worldBox = modelInstance->GetWorldBoundingBox();
+    if (mModelBVHDirty == false && worldBox.IsValid()) {
+        Mutex::ScopedLock lock(mModelBVHMutex);
+        // Not in tree yet
+        mModelBVHDirty = !mModelBVH.Update(modelIndex, worldBox);
+    }
 }
 
 uint32 SceneManager::AddModel(const ModelRefPtr &model)
@@ -266,6 +282,91 @@ void SceneManager::Update()
         LE_DrawManager.SetEnvironmentIrradianceMap(((LightIBL*)mEnvironmentLight.Get())->GetIBLIrradianceTexture());
     }
     LE_DrawManager.UpdateMatrices();
+
+    updateModelBVH();
+    buildVisibleModels();
+}
+
+void SceneManager::updateModelBVH()
+{
+    // Models that were loading may have bounds now
+    for (uint32 index = 0; index < mUnboundedModels.count() && mModelBVHDirty == false; index++) {
+        mModelBVHDirty = mModels[mUnboundedModels[index]]->GetWorldBoundingBox().IsValid();
+    }
+    if (mModelBVHDirty == false && mModelBVH.NeedsRebuild() == false)
+        return;
+
+    const uint32 modelCount = mModels.count();
+    VectorArray<AABB> worldBoxes;
+    worldBoxes.Resize(modelCount);
+    mUnboundedModels.Clear(false);
+    for (uint32 mdlidx = 0; mdlidx < modelCount; mdlidx++) {
+        worldBoxes[mdlidx] = mModels[mdlidx]->GetWorldBoundingBox();
+        if (worldBoxes[mdlidx].IsValid() == false)
+            mUnboundedModels.Add(mdlidx);
+    }
+    Mutex::ScopedLock lock(mModelBVHMutex);
+    mModelBVH.Build(worldBoxes.GetData(), modelCount);
+    mModelBVHDirty = false;
+}
+
+void SceneManager::buildVisibleModels()
+{
+    const uint32 modelCount = mModels.count();
+    mVisibleModels.Clear(false);
+    mVisibleModels.Reserve(modelCount);
+
+    Frustum *frustum = mCamera->GetFrustum();
+    if (mFrustumCullingEnabled == false || frustum == nullptr) {
+        for (uint32 mdlidx = 0; mdlidx < modelCount; mdlidx++) {
+            mVisibleModels.Add(mModels[mdlidx].Get());
+        }
+        return;
+    }
+
+    // Same matrices as rendering (without jitter of temporal AA)
+    frustum->UpdatePlanes(mCamera->GetViewMatrix() * mCamera->GetProjectionMatrix());
+
+    mModelQueryResult.Clear(false);
+    mModelBVH.QueryFrustum(*frustum, mModelQueryResult);
+    for (uint32 index = 0; index < mModelQueryResult.count(); index++) {
+        mVisibleModels.Add(mModels[mModelQueryResult[index]].Get());
+    }
+    // Not loaded yet
+    for (uint32 index = 0; index < mUnboundedModels.count(); index++) {
+        mVisibleModels.Add(mModels[mUnboundedModels[index]].Get());
+    }
+}
+
+ModelInstRefPtr SceneManager::RayCastModels(const fRay &Ray, float *OutDistance) const
+{
+    Mutex::ScopedLock lock(mModelBVHMutex);
+    BoundingVolumeHierarchy::RayHit hit;
+    if (mModelBVH.RayCast(Ray, hit) == false)
+        return ModelInstRefPtr();
+    if (OutDistance)
+        *OutDistance = hit.Distance;
+    return mModels[hit.Item];
+}
+
+void SceneManager::FindModelsInSphere(const LEMath::FloatVector3 &Center, float Radius, VectorArray<ModelInstRefPtr> &OutModels) const
+{
+    Mutex::ScopedLock lock(mModelBVHMutex);
+    VectorArray<uint32> modelIndices;
+    mModelBVH.QuerySphere(Center, Radius, modelIndices);
+    for (uint32 index = 0; index < modelIndices.count(); index++) {
+        OutModels.Add(mModels[modelIndices[index]]);
+    }
+}
+
+void SceneManager::FindModelsInBox(const AABB &Box, VectorArray<ModelInstRefPtr> &OutModels) const
+{
+    Mutex::ScopedLock lock(mModelBVHMutex);
+    VectorArray<uint32> modelIndices;
+    mModelBVH.QueryBox(Box, modelIndices);
+    for (uint32 index = 0; index < modelIndices.count(); index++) {
+        OutModels.Add(mModels[modelIndices[index]]);
+    }
 }
 
 void SceneManager::updateSceneTasks()
@@ -347,6 +448,16 @@ void SceneManager::drawBackground()
     DrawCommand::EndEvent();
 }
 
+void SceneManager::drawModels(const RenderState &rs)
+{
+    mDrawList.Clear();
+    for (uint32 mdlidx = 0; mdlidx < mVisibleModels.count(); mdlidx++) {
+        mVisibleModels[mdlidx]->AddToDrawList(mDrawList, rs);
+    }
+    mDrawList.Sort();
+    mDrawList.Submit(rs);
+}
+
 void SceneManager::drawPrePass()
 {
     DrawCommand::BeginEvent("Prepass");
@@ -357,9 +468,7 @@ void SceneManager::drawPrePass()
     PrePassRenderState.SetDepthEnabled(true);
     PrePassRenderState.SetDepthWriteMask(RendererFlag::DepthWriteMask::All);
     PrePassRenderState.SetDepthFunc(RendererFlag::TestFlags::LEqual);
-    for (uint32 mdlidx = 0; mdlidx < mModels.count(); mdlidx++) {
-        mModels[mdlidx]->Draw(PrePassRenderState);
-    }
+    drawModels(PrePassRenderState);
     DrawCommand::EndEvent();
 }
 
@@ -395,9 +504,7 @@ void SceneManager::drawBasePass()
     BasePassRenderState.SetDepthWriteMask(RendererFlag::DepthWriteMask::Zero);
     BasePassRenderState.SetDepthFunc(RendererFlag::TestFlags::Equal);
     //DrawCommand::SetBlendFunc(0, RendererFlag::BlendFlags::ALPHABLEND);
-    for (uint32 mdlidx = 0; mdlidx < mModels.count(); mdlidx++) {
-        mModels[mdlidx]->Draw(BasePassRenderState);
-    }
+    drawModels(BasePassRenderState);
     DrawCommand::EndEvent();
 }
 
@@ -410,23 +517,21 @@ void SceneManager::drawTranslucencyPass()
     //DrawCommand::SetEnable((uint32)RendererFlag::EnabledFlags::DEPTH_WRITE);
     //DrawCommand::SetDepthFunc(RendererFlag::TestFlags::LEQUAL);
     //DrawCommand::SetBlendFunc(0, RendererFlag::BlendFlags::ALPHABLEND);
-    for (uint32 mdlidx = 0; mdlidx < mModels.count(); mdlidx++) {
-        mModels[mdlidx]->Draw(TranslucencyRenderState);
-    }
+    drawModels(TranslucencyRenderState);
     DrawCommand::EndEvent();
 }
 
-ModelInstRefPtr SceneManager::findModelInstance(uint32 InstanceID)
+uint32 SceneManager::findModelIndex(uint32 InstanceID) const
 {
-    ModelInstRefPtr Output;
+    // Instances are added in order of ID (from 1)
+    if (InstanceID > 0u && InstanceID <= mModels.count() && mModels[InstanceID - 1u]->GetInstanceID() == InstanceID)
+        return InstanceID - 1u;
     for (uint32 ModelIndex = 0; ModelIndex < mModels.count(); ModelIndex++)
     {
-        if (mModels[ModelIndex]->GetInstanceID() == InstanceID) {
-            Output = mModels[ModelIndex];
-            break;
-        }
+        if (mModels[ModelIndex]->GetInstanceID() == InstanceID)
+            return ModelIndex;
     }
-    return Output;
+    return BoundingVolumeHierarchy::InvalidIndex;
 }
 
 void SceneManager::Draw()
@@ -444,6 +549,8 @@ void SceneManager::Draw()
     }
     LEASSERT(PendingDeleteRenderTargetSlot != 0xffff);
 
+    mDrawList.ResetStatistics();
+
     DrawCommand::BeginEvent("Scene");
     DrawCommand::BeginScene();
     DrawCommand::ResourceBarrier(mSceneNormal.Get(), ResourceState::RenderTarget);
@@ -39,10 +39,12 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "Shaders/Standard_prepass.ps.h"
 #include "Shaders/Standard_basepass.vs.h"
 #include "Shaders/Standard_basepass.ps.h"
+#include "Shaders/Standard_prepass_instanced.vs.h"
+#include "Shaders/Standard_basepass_instanced.vs.h"
 
 namespace LimitEngine {
-#ifdef WINDOWS
-    ShaderManager* SingletonShaderManager::mInstance = nullptr;
+#if defined(WINDOWS) || defined(LINUX)
+    template<> ShaderManager* SingletonShaderManager::mInstance = nullptr;
 #endif
 
     ShaderManager::ShaderManager()
@@ -55,16 +57,18 @@ namespace LimitEngine {
     }
     void ShaderManager::Init()
     {
-        mShaders.Add(new Draw2D_VS());
-        mShaders.Add(new Draw2D_PS());
-        mShaders.Add(new DrawFullscreen_PS());
-        mShaders.Add(new ResolveSceneColorSRGB_PS());
-        mShaders.Add(new TemporalAA_PS());
+        addshader(new Draw2D_VS());
+        addshader(new Draw2D_PS());
+        addshader(new DrawFullscreen_PS());
+        addshader(new ResolveSceneColorSRGB_PS());
+        addshader(new TemporalAA_PS());
 
-        mShaders.Add(new Standard_prepass_VS());
-        mShaders.Add(new Standard_prepass_PS());
-        mShaders.Add(new Standard_basepass_VS());
-        mShaders.Add(new Standard_basepass_PS());
+        addshader(new Standard_prepass_VS());
+        addshader(new Standard_prepass_PS());
+        addshader(new Standard_basepass_VS());
+        addshader(new Standard_basepass_PS());
+        addshader(new Standard_prepass_instanced_VS());
+        addshader(new Standard_basepass_instanced_VS());
     }
     void ShaderManager::Term()
     {
@@ -73,6 +77,7 @@ namespace LimitEngine {
             mShaders[i] = nullptr;
         }
         mShaders.Clear();
+        mShaderNames.Clear();
     }
     
     Shader* ShaderManager::findshader(const ShaderHash& hash) const
@@ -85,40 +90,45 @@ namespace LimitEngine {
         return nullptr;
     }
 
-    void ShaderManager::AddShader(Shader *sh)
+    int32 ShaderManager::findshader(const StringID &name) const
     {
-        for(uint32 shidx=0;shidx<mShaders.GetSize();shidx++)
-        {
-            if (mShaders[shidx]->GetName() == sh->GetName()) {
-                mShaders[shidx] = nullptr;
-                mShaders.Delete(shidx);
-                break;
+        for (uint32 shidx = 0; shidx < mShaderNames.count(); shidx++) {
+            if (mShaderNames[shidx] == name) {
+                return static_cast<int32>(shidx);
             }
         }
+        return -1;
+    }
+    void ShaderManager::addshader(Shader *sh)
+    {
+        mShaders.Add(sh);
+        mShaderNames.Add(StringID(sh->GetName()));
+    }
+
+    void ShaderManager::AddShader(Shader *sh)
+    {
+        const int32 shidx = findshader(StringID(sh->GetName()));
+        if (shidx >= 0) {
+            mShaders[shidx] = nullptr;
+            mShaders.Delete(shidx);
+            mShaderNames.Delete(shidx);
+        }
 
         sh->SetID(mShaderID++);
-        mShaders.push_back(sh);
+        addshader(sh);
     }
-    uint32 ShaderManager::GetShaderID(const char *shaderName)
+    uint32 ShaderManager::GetShaderID(const StringID &shaderName)
     {
-        for(uint32 i=0;i<mShaders.GetSize();i++)
-        {
-            if (mShaders[i]->GetName() == shaderName)
-            {
-                return mShaders[i]->GetID();
-            }
-        }
-        return -1;
+        const int32 shidx = findshader(shaderName);
+        if (shidx < 0)
+            return -1;
+        return mShaders[shidx]->GetID();
     }
-    ShaderRefPtr ShaderManager::GetShader(const char *name)
+    ShaderRefPtr ShaderManager::GetShader(const StringID &name)
     {
-        for(uint32 i=0;i<mShaders.GetSize();i++)
-        {
-            if (mShaders[i]->GetName() == name)
-            {
-                return mShaders[i];
-            }
-        }
-        return nullptr;
+        const int32 shidx = findshader(name);
+        if (shidx < 0)
+            return nullptr;
+        return mShaders[shidx];
     }
-}
\ No newline at end of file
+}
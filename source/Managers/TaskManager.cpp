@@ -7,10 +7,14 @@
  @author minseob (https://github.com/rasidin)
  ***********************************************************/
 
+#include <thread>
+
 #include "Core/Common.h"
 #include "Core/Debug.h"
+#include "Core/Thread.h"
 #include "Core/Timer.h"
 #include "Core/Util.h"
+#include "Containers/SmallVectorArray.h"
 #include "Managers/TaskManager.h"
 
 namespace LimitEngine {
@@ -18,9 +22,10 @@ namespace LimitEngine {
 // =================================================
 // Static Functions
 // =================================================
-#ifdef WIN32
-TaskManager* SingletonTaskManager::mInstance = NULL;
+#if defined(WIN32) || defined(LINUX)
+template<> TaskManager* SingletonTaskManager::mInstance = NULL;
 #endif
+thread_local int32 TaskManager::sWorkerIndex = -1;
 TaskManager::TaskID TaskManager::GetIDfromName(const char *name)
 {
     return mInstance->getIDfromName(name);
@@ -63,44 +68,68 @@ void TaskManager::Run()
     }
 }
 
-void TaskManager::ParallelTask::Init(const String &ThreadName)
+void TaskManager::JobQueue::grow()
+{
+    const uint32 oldCapacity = mRing.count();
+    const uint32 newCapacity = oldCapacity ? oldCapacity * 2u : 64u;
+    VectorArray<JOB*> newRing;
+    newRing.Resize(newCapacity);
+    const uint32 count = mCount.load(std::memory_order_relaxed);
+    for (uint32 Index = 0; Index < count; Index++) {
+        newRing[Index] = mRing[(mHead + Index) % oldCapacity];
+    }
+    mRing = Move(newRing);
+    mHead = 0u;
+}
+
+void TaskManager::JobQueue::PushBack(JOB *job)
+{
+    Mutex::ScopedLock scopedLock(mMutex);
+    const uint32 count = mCount.load(std::memory_order_relaxed);
+    if (count == mRing.count())
+        grow();
+    mRing[(mHead + count) % mRing.count()] = job;
+    mCount.store(count + 1u, std::memory_order_relaxed);
+}
+
+TaskManager::JOB* TaskManager::JobQueue::PopBack()
+{
+    Mutex::ScopedLock scopedLock(mMutex);
+    const uint32 count = mCount.load(std::memory_order_relaxed);
+    if (count == 0u)
+        return nullptr;
+    mCount.store(count - 1u, std::memory_order_relaxed);
+    return mRing[(mHead + count - 1u) % mRing.count()];
+}
+
+TaskManager::JOB* TaskManager::JobQueue::StealFront()
+{
+    Mutex::ScopedLock scopedLock(mMutex);
+    const uint32 count = mCount.load(std::memory_order_relaxed);
+    if (count == 0u)
+        return nullptr;
+    JOB *job = mRing[mHead];
+    mHead = (mHead + 1u) % mRing.count();
+    mCount.store(count - 1u, std::memory_order_relaxed);
+    return job;
+}
+
+void TaskManager::WorkerThread::Init(const String &ThreadName)
 {
     ThreadParam param;
-    param.func = ThreadFunction(this, &TaskManager::ParallelTask::Run);
+    param.func = ThreadFunction(this, &TaskManager::WorkerThread::Run);
     param.name = ThreadName;
     mThread.Create(param);
 }
 
-void TaskManager::ParallelTask::Join()
+void TaskManager::WorkerThread::Join()
 {
     mThread.Join();
 }
 
-void TaskManager::ParallelTask::Exit()
+void TaskManager::WorkerThread::Run()
 {
-    mExitCode = true;
-    Join();
-}
-
-void TaskManager::ParallelTask::Run()
-{
-    while (!mExitCode)
-    {
-        VectorArray<uint32> removeTasks;
-        for (uint32 taskIndex = 0; taskIndex < mTasks.count(); taskIndex++) {
-            mTasks[taskIndex]->func();
-            if (mTasks[taskIndex]->transient) {
-                removeTasks.Add(taskIndex);
-            }
-        }
-        if (removeTasks.count())
-        for (uint32 removeIdx = 0; removeIdx < removeTasks.count(); removeIdx++) {
-            const uint32 removeTarget = removeTasks[removeIdx];
-            delete mTasks[removeTarget];
-            mTasks.erase(removeTarget);
-        }
-        Sleep(1);
-    }
+    mOwner->workerLoop(mIndex);
 }
 
 TaskManager::TaskManager()
@@ -109,10 +138,19 @@ TaskManager::TaskManager()
     , mWorkThreadExitCode(false)
 	, mTasks()
     , mId_counter(0)
+    , mWorkerWakeEvent(NULL, false, true)
+    , mPendingJobCount(0u)
+    , mSleepingWorkerCount(0u)
+    , mSubmitQueueIndex(0u)
+    , mWorkerExitCode(false)
 {
     mWorkThread = new Thread();
-    for (uint32 ThreadIndex = 0; ThreadIndex < ParallelTaskCount; ThreadIndex++) {
-        mParallelThreads[ThreadIndex] = new ParallelTask();
+
+    const uint32 hardwareThreadCount = static_cast<uint32>(std::thread::hardware_concurrency());
+    const uint32 workerCount = (hardwareThreadCount > ReservedThreadCount + 1u) ? (hardwareThreadCount - ReservedThreadCount) : 1u;
+    mWorkers.Reserve(workerCount);
+    for (uint32 ThreadIndex = 0; ThreadIndex < workerCount; ThreadIndex++) {
+        mWorkers.Add(new WorkerThread(this, ThreadIndex));
     }
 }
 
@@ -121,11 +159,12 @@ TaskManager::~TaskManager()
     delete mWorkThread;
     mWorkThread = NULL;
 
-    for (uint32 ThreadIndex = 0; ThreadIndex < ParallelTaskCount; ThreadIndex++)
+    for (uint32 ThreadIndex = 0; ThreadIndex < mWorkers.count(); ThreadIndex++)
     {
-        delete mParallelThreads[ThreadIndex];
-        mParallelThreads[ThreadIndex] = nullptr;
+        delete mWorkers[ThreadIndex];
+        mWorkers[ThreadIndex] = nullptr;
     }
+    mWorkers.Clear();
 }
 
 void TaskManager::Init()
@@ -136,12 +175,13 @@ void TaskManager::Init()
         param.name = "MainTask";
         mWorkThread->Create(param);
     }
-    for (uint32 ThreadIndex = 0; ThreadIndex < ParallelTaskCount; ThreadIndex++) {
-        if (mParallelThreads[ThreadIndex]->IsRunning() == false) {
+    mWorkerExitCode = false;
+    for (uint32 ThreadIndex = 0; ThreadIndex < mWorkers.count(); ThreadIndex++) {
+        if (mWorkers[ThreadIndex]->IsRunning() == false) {
             String threadName = "SubTask";
             char numBuf[8];
-            sprintf_s<8>(numBuf, "%1d", ThreadIndex);
-            mParallelThreads[ThreadIndex]->Init(threadName + numBuf);
+            sprintf_s<8>(numBuf, "%d", ThreadIndex);
+            mWorkers[ThreadIndex]->Init(threadName + numBuf);
         }
     }
 }
@@ -156,39 +196,125 @@ void TaskManager::Term()
         }
         mTasks.Clear();
     }
-    for (uint32 ThreadIndex = 0; ThreadIndex < ParallelTaskCount; ThreadIndex++)
+    mWorkerExitCode = true;
+    mWorkerWakeEvent.Signal();
+    for (uint32 ThreadIndex = 0; ThreadIndex < mWorkers.count(); ThreadIndex++)
     {
-        if (mParallelThreads[ThreadIndex]->IsRunning()) {
-            mParallelThreads[ThreadIndex]->Exit();
+        if (mWorkers[ThreadIndex]->IsRunning()) {
+            mWorkers[ThreadIndex]->Join();
         }
     }
+    // Run jobs left in queues (callers may be waiting for their counters)
+    while (runOneJob(-1)) {}
+}
+
+void TaskManager::submitJob(TaskManager::JOB *job)
+{
+    LEASSERT(mWorkers.count());
+    uint32 queueIndex = 0u;
+    if (sWorkerIndex >= 0)
+        queueIndex = static_cast<uint32>(sWorkerIndex);
+    else
+        queueIndex = mSubmitQueueIndex.fetch_add(1u) % mWorkers.count();
+    mWorkers[queueIndex]->GetQueue().PushBack(job);
+
+    mPendingJobCount.fetch_add(1u);
+    if (mSleepingWorkerCount.load() > 0u)
+        mWorkerWakeEvent.Signal();
+}
+
+TaskManager::JOB* TaskManager::findJob(int32 workerIndex)
+{
+    const uint32 workerCount = mWorkers.count();
+    if (workerIndex >= 0) {
+        if (JOB *job = mWorkers[workerIndex]->GetQueue().PopBack())
+            return job;
+    }
+    // Steal from others
+    const uint32 startIndex = (workerIndex >= 0) ? static_cast<uint32>(workerIndex) + 1u : 0u;
+    for (uint32 Index = 0; Index < workerCount; Index++) {
+        JobQueue &victim = mWorkers[(startIndex + Index) % workerCount]->GetQueue();
+        if (victim.IsEmpty())
+            continue;
+        if (JOB *job = victim.StealFront())
+            return job;
+    }
+    return nullptr;
+}
+
+bool TaskManager::runOneJob(int32 workerIndex)
+{
+    JOB *job = findJob(workerIndex);
+    if (job == nullptr)
+        return false;
+
+    // Wake another worker if there are more jobs
+    if (mPendingJobCount.fetch_sub(1u) > 1u && mSleepingWorkerCount.load() > 0u)
+        mWorkerWakeEvent.Signal();
+
+    job->func();
+
+    TaskCounter *counter = job->counter;
+    delete job;
+    if (counter)
+        counter->Done();
+    return true;
+}
+
+void TaskManager::workerLoop(uint32 workerIndex)
+{
+    sWorkerIndex = static_cast<int32>(workerIndex);
+    while (!mWorkerExitCode)
+    {
+        if (runOneJob(sWorkerIndex))
+            continue;
+
+        // Park until new job is submitted
+        mSleepingWorkerCount.fetch_add(1u);
+        if (mPendingJobCount.load() == 0u && !mWorkerExitCode)
+            mWorkerWakeEvent.Wait();
+        mSleepingWorkerCount.fetch_sub(1u);
+    }
+    // Wake next worker for exiting
+    mWorkerWakeEvent.Signal();
+    sWorkerIndex = -1;
+}
+
+void TaskManager::WaitForCounter(TaskCounter &Counter)
+{
+    while (!Counter.IsDone())
+    {
+        if (runOneJob(sWorkerIndex))
+            continue;
+        Counter.mCompletedEvent.Wait();
+    }
 }
 
 void TaskManager::runTasks()
 {
     while (!mWorkThreadExitCode) {
-        VectorArray<uint32> removeTasks;
+        // Indices of transient tasks, kept on stack (this loop is not tied to frames of FrameAllocator)
+        SmallVectorArray<uint32, TransientTaskInlineCount> removeTasks;
         mMutex.Lock();
         for (uint32 taskidx = 0; taskidx < mTasks.size(); taskidx++) {
             mTasks[taskidx]->elapsedFromLast = static_cast<float>(Timer::GetTimeDoubleSecond()) - mTasks[0]->startTime;
             mTasks[taskidx]->startTime = static_cast<float>(Timer::GetTimeDoubleSecond());
             mTasks[taskidx]->func();
-            if (mTasks[taskidx]->transient) {
+            if (mTasks[taskidx]->transient)
                 removeTasks.Add(taskidx);
-            }
             if (mWorkThreadExitCode)
                 break;
         }
         mMutex.Unlock();
         if (removeTasks.count()) {
             Mutex::ScopedLock scopedLock(mMutex);
-            for (uint32 removeIdx = removeTasks.count() - 1; removeIdx > 0; removeIdx--) {
-                const uint32 removeTarget = removeTasks[removeIdx];
+            for (uint32 removeIdx = removeTasks.count(); removeIdx > 0; removeIdx--) {
+                const uint32 removeTarget = removeTasks[removeIdx - 1];
                 delete mTasks[removeTarget];
                 mTasks.erase(removeTarget);
             }
         }
-        Sleep(1);
+        Thread::Sleep(1);
     }
 }
 
@@ -213,8 +339,8 @@ uint32 TaskManager::addTask(TaskManager::TASK *task)
     task->id = mId_counter;
     mTasks.push_back(task);
 
-	mTasks.Sort([](const TASK *t1, const TASK *t2){
-		return t1->priority <= t2->priority;
+	mTasks.StableSort([](const TASK *t1, const TASK *t2){
+		return t1->priority < t2->priority;
 	});
 
     return mId_counter;
@@ -100,6 +100,99 @@ namespace LimitEngine {
             VectorArray<ID3D12DescriptorHeap*> mUsedHeapPool[PoolTypeCount];
             VectorArray<DescriptorHeapSet> mFreeHeapPool[PoolTypeCount];
         } mDescriptorHeapPool;
+        // Upload buffers for instance data of DrawIndexedInstanced (mapped while they live, reused after GPU finished them)
+        class InstanceBufferPool {
+        public:
+            static constexpr uint32 BufferSize = 256u * (1u << 10);      // 256KB
+        private:
+            struct InstanceBufferSet {
+                uint64 Fence = 0u;
+                ID3D12Resource* Buffer = nullptr;
+                uint8* Mapped = nullptr;
+            };
+        public:
+            ~InstanceBufferPool() {
+                for (const InstanceBufferSet& bufferset : mUsedBufferPool) {
+                    bufferset.Buffer->Release();
+                }
+                mUsedBufferPool.Clear();
+                for (const InstanceBufferSet& bufferset : mFreeBufferPool) {
+                    bufferset.Buffer->Release();
+                }
+                mFreeBufferPool.Clear();
+            }
+        public:
+            // Copy Data to upload buffer, returns its GPU address (0 if failed)
+            D3D12_GPU_VIRTUAL_ADDRESS Upload(const void* Data, uint32 Size) {
+                Size = GetSizeAlign<uint32>(Size, 16u);
+                if (Size > BufferSize) return 0u;
+                if (mUsedBufferPool.count() == 0u || mCurrentOffset + Size > BufferSize) {
+                    if (!getNewBuffer()) return 0u;
+                }
+                const InstanceBufferSet& current = mUsedBufferPool[mUsedBufferPool.count() - 1u];
+                ::memcpy(current.Mapped + mCurrentOffset, Data, Size);
+                const D3D12_GPU_VIRTUAL_ADDRESS address = current.Buffer->GetGPUVirtualAddress() + mCurrentOffset;
+                mCurrentOffset += Size;
+                return address;
+            }
+            void Finalize(uint64 fence) {
+                mCurrentFenceIndex = fence;
+                for (InstanceBufferSet& bufferset : mUsedBufferPool) {
+                    bufferset.Fence = fence;
+                    mFreeBufferPool.Add(bufferset);
+                }
+                mUsedBufferPool.Clear();
+                mCurrentOffset = 0u;
+            }
+        private:
+            bool getNewBuffer() {
+                InstanceBufferSet newbuffer;
+                for (uint32 bufidx = 0; bufidx < mFreeBufferPool.count(); bufidx++) {
+                    if (mFreeBufferPool[bufidx].Fence < mCurrentFenceIndex) {
+                        newbuffer = mFreeBufferPool[bufidx];
+                        mFreeBufferPool.Delete(bufidx);
+                        break;
+                    }
+                }
+                if (!newbuffer.Buffer) {
+                    D3D12_HEAP_PROPERTIES heapprop = {};
+                    heapprop.Type = D3D12_HEAP_TYPE_UPLOAD;
+                    heapprop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+                    heapprop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+                    heapprop.CreationNodeMask = 1;
+                    heapprop.VisibleNodeMask = 1;
+                    D3D12_RESOURCE_DESC desc = {};
+                    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+                    desc.Width = BufferSize;
+                    desc.Height = 1;
+                    desc.DepthOrArraySize = 1;
+                    desc.MipLevels = 1;
+                    desc.Format = DXGI_FORMAT_UNKNOWN;
+                    desc.SampleDesc.Count = 1;
+                    desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+                    desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+                    ID3D12Device* device = (ID3D12Device*)LE_DrawManagerRendererAccessor.GetDeviceHandle();
+                    if (FAILED(device->CreateCommittedResource(&heapprop, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&newbuffer.Buffer)))) {
+                        Debug::Error("[CommandImpl_Direct12] Failed to create instance buffer");
+                        return false;
+                    }
+                    D3D12_RANGE readrange = { 0, 0 };
+                    if (FAILED(newbuffer.Buffer->Map(0, &readrange, (void**)&newbuffer.Mapped))) {
+                        Debug::Error("[CommandImpl_Direct12] Failed to map instance buffer");
+                        newbuffer.Buffer->Release();
+                        return false;
+                    }
+                }
+                mUsedBufferPool.Add(newbuffer);
+                mCurrentOffset = 0u;
+                return true;
+            }
+        private:
+            uint64 mCurrentFenceIndex = 0u;
+            uint32 mCurrentOffset = 0u;
+            VectorArray<InstanceBufferSet> mUsedBufferPool;
+            VectorArray<InstanceBufferSet> mFreeBufferPool;
+        } mInstanceBufferPool;
         struct Cache
         {
             static constexpr uint32 CachedConstantBufferMaxNum = 16u;
@@ -265,6 +358,7 @@ namespace LimitEngine {
         void Finalize(uint64 CompletedFenceValue) override
         {
             mDescriptorHeapPool.Finalize(CompletedFenceValue);
+            mInstanceBufferPool.Finalize(CompletedFenceValue);
         }
         void ProcessAfterPresent() override
         {
@@ -278,6 +372,7 @@ namespace LimitEngine {
                 mD3DGraphicsCommandList->Reset(mD3DCommandAllocator, nullptr);
             }
             mFirstFinish = false;
+            ClearCaches();
 
             for (ID3D12Resource* resource : mPendingReleaseResources) {
                 resource->Release();
@@ -285,8 +380,8 @@ namespace LimitEngine {
             mPendingReleaseResources.Clear();
         }
 
-        void BeginScene() override {}
-        void EndScene() override {}
+        void BeginScene() override { ClearCaches(); }
+        void EndScene() override { ClearCaches(); }
         void SetViewport(const LEMath::IntRect& rect) override 
         {  
             D3D12_VIEWPORT viewport{(FLOAT)rect.X(), (FLOAT)rect.Y(), (FLOAT)rect.Width(), (FLOAT)rect.Height(), 0.0f, 1.0f};
@@ -362,6 +457,8 @@ namespace LimitEngine {
         }
         void SetPipelineState(PipelineState *pso) override
         {
+            // Bindings are kept for following draws until root signature is changed (same as shadow state of CommandBuffer)
+            ClearCaches();
             if (pso->IsValid()) {
                 if (ID3D12RootSignature* handle = static_cast<ID3D12RootSignature*>(PipelineStateRendererAccessor(pso).GetRootSignatureHandle())) {
                     mD3DGraphicsCommandList->SetGraphicsRootSignature(handle);
@@ -411,7 +508,6 @@ namespace LimitEngine {
 
             mD3DGraphicsCommandList->IASetPrimitiveTopology(PrimitiveTopologyTypeToD3DPrimitiveTopology[Primitive]);
             mD3DGraphicsCommandList->DrawInstanced(Count, 1, Offset, 0);
-            ClearCaches();
         }
         void DrawIndexedPrimitive(uint32 Primitive, uint32 VertexCount, uint32 Count) override
         {
@@ -420,7 +516,23 @@ namespace LimitEngine {
 
             mD3DGraphicsCommandList->IASetPrimitiveTopology(PrimitiveTopologyTypeToD3DPrimitiveTopology[Primitive]);
             mD3DGraphicsCommandList->DrawIndexedInstanced(Count, 1, 0, 0, 0);
-            ClearCaches();
+        }
+        void DrawIndexedInstanced(uint32 Primitive, uint32 IndexCount, uint32 InstanceCount, const void *InstanceData, uint32 InstanceStride) override
+        {
+            const D3D12_GPU_VIRTUAL_ADDRESS instanceaddress = mInstanceBufferPool.Upload(InstanceData, InstanceCount * InstanceStride);
+            if (instanceaddress == 0u) return;
+
+            D3D12_VERTEX_BUFFER_VIEW InstanceBufferView;
+            InstanceBufferView.BufferLocation = instanceaddress;
+            InstanceBufferView.StrideInBytes = InstanceStride;
+            InstanceBufferView.SizeInBytes = InstanceCount * InstanceStride;
+            mD3DGraphicsCommandList->IASetVertexBuffers(1, 1, &InstanceBufferView);
+
+            float blendfactor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+            mD3DGraphicsCommandList->OMSetBlendFactor(blendfactor);
+
+            mD3DGraphicsCommandList->IASetPrimitiveTopology(PrimitiveTopologyTypeToD3DPrimitiveTopology[Primitive]);
+            mD3DGraphicsCommandList->DrawIndexedInstanced(IndexCount, InstanceCount, 0, 0, 0);
         }
         void SetRenderTarget(uint32 Index, const TextureRendererAccessor& Color, const TextureRendererAccessor& Depth, uint32 SurfaceIndex) override
         {
@@ -0,0 +1,31 @@
+/***********************************************************
+ LIMITEngine Source File
+ Copyright (C), LIMITGAME, 2020
+ -----------------------------------------------------------
+ @file  DebugImpl_Linux.inl
+ @brief for Debug (Linux)
+ @author minseob (https://github.com/rasidin)
+ ***********************************************************/
+
+#include "Core/Debug.h"
+
+#include <stdio.h>
+
+#ifdef LINUX
+namespace LimitEngine {
+    class DebugImpl_Linux : public DebugImpl
+    {
+    public:
+        void PrintLog(const char *s)
+        {
+            fputs(s, stderr);
+        }
+        void PrintGUI(const char * /*s*/)
+        {
+        }
+        void Clear()
+        {
+        }
+    };
+}
+#endif
@@ -0,0 +1,90 @@
+/***********************************************************
+LIMITEngine Source File
+Copyright (C), LIMITGAME, 2020
+-----------------------------------------------------------
+@file  EventImpl_Linux.inl
+@brief Implementation for Event (Linux, pthread)
+@author minseob (https://github.com/rasidin)
+***********************************************************/
+#ifdef LINUX
+#include <pthread.h>
+#include <time.h>
+
+// Same behavior as event object of Windows (auto reset event releases one waiter per signal)
+struct EventHandle_Linux
+{
+    pthread_mutex_t Mutex;
+    pthread_cond_t  Condition;
+    bool            Signaled;
+    bool            AutoReset;
+};
+
+namespace LimitEngine {
+Event::Event(const char * /*name*/, bool initState, bool autoReset)
+{
+    mHandle = new EventHandle_Linux();
+    pthread_mutex_init(&mHandle->Mutex, NULL);
+    pthread_condattr_t conditionAttribute;
+    pthread_condattr_init(&conditionAttribute);
+    pthread_condattr_setclock(&conditionAttribute, CLOCK_MONOTONIC);
+    pthread_cond_init(&mHandle->Condition, &conditionAttribute);
+    pthread_condattr_destroy(&conditionAttribute);
+    mHandle->Signaled = initState;
+    mHandle->AutoReset = autoReset;
+}
+Event::~Event()
+{
+    if (mHandle) {
+        pthread_cond_destroy(&mHandle->Condition);
+        pthread_mutex_destroy(&mHandle->Mutex);
+        delete mHandle;
+        mHandle = nullptr;
+    }
+}
+
+void Event::Wait(uint32 milliSecond)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += milliSecond / 1000u;
+    deadline.tv_nsec += static_cast<long>(milliSecond % 1000u) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+    pthread_mutex_lock(&mHandle->Mutex);
+    while (!mHandle->Signaled) {
+        if (pthread_cond_timedwait(&mHandle->Condition, &mHandle->Mutex, &deadline) == ETIMEDOUT)
+            break;
+    }
+    if (mHandle->Signaled && mHandle->AutoReset)
+        mHandle->Signaled = false;
+    pthread_mutex_unlock(&mHandle->Mutex);
+}
+bool Event::TryWait()
+{
+    pthread_mutex_lock(&mHandle->Mutex);
+    const bool signaled = mHandle->Signaled;
+    if (signaled && mHandle->AutoReset)
+        mHandle->Signaled = false;
+    pthread_mutex_unlock(&mHandle->Mutex);
+    return signaled;
+}
+void Event::Signal()
+{
+    pthread_mutex_lock(&mHandle->Mutex);
+    mHandle->Signaled = true;
+    if (mHandle->AutoReset)
+        pthread_cond_signal(&mHandle->Condition);
+    else
+        pthread_cond_broadcast(&mHandle->Condition);
+    pthread_mutex_unlock(&mHandle->Mutex);
+}
+void Event::Reset()
+{
+    pthread_mutex_lock(&mHandle->Mutex);
+    mHandle->Signaled = false;
+    pthread_mutex_unlock(&mHandle->Mutex);
+}
+}
+#endif
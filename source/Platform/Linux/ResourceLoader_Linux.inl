@@ -0,0 +1,62 @@
+/***********************************************************
+ LIMITEngine Header File
+ Copyright (C), LIMITGAME, 2020
+ -----------------------------------------------------------
+ @file  ResourceLoader_Linux.inl
+ @brief Resource Loader (Linux)
+ @author minseob (https://github.com/rasidin)
+ ***********************************************************/
+
+#ifdef LINUX
+#include <stdio.h>		// for FILE
+#include <sys/stat.h>
+
+#include "Core/Util.h"
+
+namespace LimitEngine {
+    class ResourceLoader_Linux : public ResourceLoader
+    {
+    public:
+        ResourceLoader_Linux() {}
+        virtual ~ResourceLoader_Linux() {}
+
+        bool IsExist(const char *filename)
+        {
+            struct stat fileStatus;
+            return ::stat(filename, &fileStatus) == 0 && S_ISREG(fileStatus.st_mode);
+        }
+        void* GetResource(const char *filename, size_t *size)
+        {
+            void *output = NULL;
+            FILE *fp = fopen(filename, "rb");
+
+            if (fp)
+            {
+                fseek(fp, 0, SEEK_END);
+                const long fileSize = ftell(fp);
+                fseek(fp, 0, SEEK_SET);
+                // Terminated by zero (same as Windows)
+                *size = static_cast<size_t>(fileSize) + 1;
+                output = malloc(*size);
+                ::memset(output, 0, *size);
+                fread(output, static_cast<size_t>(fileSize), 1, fp);
+                fclose(fp);
+            }
+
+            return output;
+        }
+        bool WriteToResource(const char *Filename, uint32 FileType, uint32 FileVersion, void *Data, size_t Size)
+        {
+            FILE *fp = fopen(Filename, "wb");
+            if (fp) {
+                fwrite(&FileType, sizeof(uint32), 1, fp);
+                fwrite(&FileVersion, sizeof(uint32), 1, fp);
+                fwrite(Data, Size, 1, fp);
+                fclose(fp);
+                return true;
+            }
+            return false;
+        }
+    };
+}
+#endif
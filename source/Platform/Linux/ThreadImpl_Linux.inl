@@ -0,0 +1,63 @@
+/***********************************************************
+LIMITEngine Source File
+Copyright (C), LIMITGAME, 2020
+-----------------------------------------------------------
+@file  ThreadImpl_Linux.inl
+@brief Thread implementation (Linux, pthread)
+@author minseob (https://github.com/rasidin)
+***********************************************************/
+#ifdef LINUX
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "Core/Common.h"
+#include "Core/Thread.h"
+namespace LimitEngine {
+    static void* ThreadRun(void* arg)
+    {
+        Thread* thread = reinterpret_cast<Thread*>(arg);
+        thread->Run();
+        return nullptr;
+    }
+    THREADHANDLE ThreadImpl::CreateThread(Thread *thread, const ThreadParam &param)
+    {
+        THREADHANDLE threadHandle = 0;
+        if (pthread_create(&threadHandle, NULL, ThreadRun, thread) != 0)
+            return 0;
+        // Priority needs privileges on Linux, so it is left to scheduler
+        if (param.affinityMask != 0) {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            for (uint32 cpuIndex = 0; cpuIndex < 32u; cpuIndex++) {
+                if (param.affinityMask & (1u << cpuIndex))
+                    CPU_SET(cpuIndex, &cpuSet);
+            }
+            pthread_setaffinity_np(threadHandle, sizeof(cpu_set_t), &cpuSet);
+        }
+        if (param.name.GetLength()) {
+            static constexpr uint32 MaxThreadNameCount = 16u; // Including terminator
+            char threadName[MaxThreadNameCount];
+            ::strncpy(threadName, param.name.GetCharPtr(), MaxThreadNameCount - 1);
+            threadName[MaxThreadNameCount - 1] = 0;
+            pthread_setname_np(threadHandle, threadName);
+        }
+        return threadHandle;
+    }
+    void ThreadImpl::Join(THREADHANDLE threadhandle)
+    {
+        pthread_join(threadhandle, NULL);
+    }
+    void ThreadImpl::Sleep(uint32 milliSecond)
+    {
+        struct timespec duration;
+        duration.tv_sec = milliSecond / 1000u;
+        duration.tv_nsec = static_cast<long>(milliSecond % 1000u) * 1000000;
+        while (nanosleep(&duration, &duration) != 0 && errno == EINTR) {}
+    }
+    void ThreadImpl::YieldThread()
+    {
+        sched_yield();
+    }
+} // LimitEngine
+#endif
@@ -0,0 +1,166 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  CommandImpl_Null.inl
+@brief CommandBuffer for rendering (Null, nothing is drawn)
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#include "Renderer/NullBackend.h"
+
+namespace LimitEngine {
+    class CommandImpl_Null : public CommandImpl
+    {
+        // Bound objects (same role as caches of GPU backends, for counting state changes)
+        struct BindingState
+        {
+            static constexpr uint32 MaxSlotNum = 16u;
+
+            PipelineState       *CurrentPipelineState;
+            VertexBufferGeneric *CurrentVertexBuffer;
+            IndexBuffer         *CurrentIndexBuffer;
+            ConstantBuffer      *CurrentConstantBuffers[MaxSlotNum];
+            TextureInterface    *CurrentTextures[MaxSlotNum];
+            SamplerState        *CurrentSamplers[MaxSlotNum];
+            void                *CurrentRenderTarget;
+
+            BindingState() { Clear(); }
+            void Clear() { ::memset(this, 0, sizeof(BindingState)); }
+        };
+    public:
+        CommandImpl_Null()
+            : CommandImpl()
+        {}
+        virtual ~CommandImpl_Null() {}
+
+        void Init(void* Parameter) override {}
+        void Term() override {}
+
+        void* GetCommandListHandle() override { return nullptr; }
+        void ReadyToExecute() override {}
+        void Finalize(uint64 CompletedFenceValue) override {}
+        void ProcessAfterPresent() override
+        {
+            // Command list is reset for next frame
+            mBinding.Clear();
+        }
+
+        void BeginScene() override { countCommand(); }
+        void EndScene() override { countCommand(); }
+        void SetViewport(const LEMath::IntRect& rect) override { countCommand(); }
+        void SetScissorRect(const LEMath::IntRect& rect) override { countCommand(); }
+        bool PrepareForDrawing() override { return true; }
+        bool PrepareForDrawingModel() override { return true; }
+        void ClearCaches() override {}
+        void ClearScreen(const LEMath::FloatColorRGBA& Color) override { countCommand(); }
+        void BindVertexBuffer(VertexBufferGeneric *vb) override
+        {
+            countCommand();
+            if (vb) countBinding(mBinding.CurrentVertexBuffer, vb);
+        }
+        void BindIndexBuffer(IndexBuffer *ib) override
+        {
+            countCommand();
+            if (ib) countBinding(mBinding.CurrentIndexBuffer, ib);
+        }
+        void SetConstantBuffer(uint32 Index, ConstantBuffer *InConstantBuffer) override
+        {
+            countCommand();
+            if (InConstantBuffer && Index < BindingState::MaxSlotNum) countBinding(mBinding.CurrentConstantBuffers[Index], InConstantBuffer);
+        }
+        void SetPipelineState(PipelineState *pso) override
+        {
+            countCommand();
+            if (pso) countBinding(mBinding.CurrentPipelineState, pso);
+        }
+        void UpdateConstantBuffer(ConstantBuffer* cb, void* data, size_t size) override
+        {
+            countCommand();
+            if (cb) {
+                ConstantBufferRendererAccessor(cb).Update(data);
+                NullBackend::Count(NullBackend::Counter::ConstantBufferUpdates);
+                NullBackend::Count(NullBackend::Counter::UploadedBytes, size);
+            }
+        }
+        void BindTargetTexture(uint32 Index, Texture* InTexture) override { countCommand(); }
+        void BindSampler(uint32 Index, SamplerState *Sampler) override
+        {
+            countCommand();
+            if (Index < BindingState::MaxSlotNum) countBinding(mBinding.CurrentSamplers[Index], Sampler);
+        }
+        void BindTexture(uint32 Index, TextureInterface *InTexture) override
+        {
+            countCommand();
+            if (Index < BindingState::MaxSlotNum) countBinding(mBinding.CurrentTextures[Index], InTexture);
+        }
+        void Dispatch(int X, int Y, int Z) override
+        {
+            countCommand();
+            NullBackend::Count(NullBackend::Counter::Dispatches);
+        }
+        void DrawPrimitive(uint32 Primitive, uint32 Offset, uint32 Count) override
+        {
+            countCommand();
+            NullBackend::Count(NullBackend::Counter::DrawCalls);
+            NullBackend::Count(NullBackend::Counter::DrawnInstances);
+        }
+        void DrawIndexedPrimitive(uint32 Primitive, uint32 VertexCount, uint32 Count) override
+        {
+            countCommand();
+            NullBackend::Count(NullBackend::Counter::DrawCalls);
+            NullBackend::Count(NullBackend::Counter::DrawnInstances);
+        }
+        void DrawIndexedInstanced(uint32 Primitive, uint32 IndexCount, uint32 InstanceCount, const void *InstanceData, uint32 InstanceStride) override
+        {
+            countCommand();
+            NullBackend::Count(NullBackend::Counter::DrawCalls);
+            NullBackend::Count(NullBackend::Counter::DrawnInstances, InstanceCount);
+            NullBackend::Count(NullBackend::Counter::UploadedBytes, static_cast<uint64>(InstanceCount) * InstanceStride);
+        }
+        void SetRenderTarget(uint32 Index, const TextureRendererAccessor& Color, const TextureRendererAccessor& Depth, uint32 SurfaceIndex) override
+        {
+            countCommand();
+            countBinding(mBinding.CurrentRenderTarget, Color.GetRenderTargetView());
+        }
+        void CopyResource(void* Dst, uint32 DstOffset, void* Org, uint32 OrgOffset, uint32 Size) override { countCommand(); }
+        void ResourceBarrier(void* Resource, const ResourceState& Before, const ResourceState& After) override { countCommand(); }
+        void SetMarker(const char *InMarkerName) override { countCommand(); }
+        void BeginEvent(const char *InEventName) override { countCommand(); }
+        void EndEvent() override { countCommand(); }
+    private:
+        static void countCommand()
+        {
+            NullBackend::Count(NullBackend::Counter::Commands);
+        }
+        template<typename T>
+        static void countBinding(T *&Bound, T *Object)
+        {
+            NullBackend::Count(NullBackend::Counter::StateBinds);
+            if (Bound != Object) {
+                NullBackend::Count(NullBackend::Counter::StateChanges);
+                Bound = Object;
+            }
+        }
+    private:
+        BindingState mBinding;
+    };
+}
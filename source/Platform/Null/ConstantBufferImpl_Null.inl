@@ -0,0 +1,65 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  ConstantBufferImpl_Null.inl
+@brief ConstantBuffer Implement (Null)
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#include "Renderer/NullBackend.h"
+
+namespace LimitEngine {
+class ConstantBufferImpl_Null : public ConstantBufferImpl
+{
+public:
+    ConstantBufferImpl_Null() {}
+    virtual ~ConstantBufferImpl_Null() {
+        if (mData) {
+            free(mData);
+            mData = nullptr;
+        }
+    }
+
+    void Create(size_t size, void *initdata) override
+    {
+        mSize = size;
+        // Memory in place of upload heap, so updates cost copy same as GPU backends
+        mData = malloc(size);
+        if (initdata)
+            ::memcpy(mData, initdata, size);
+        NullBackend::Count(NullBackend::Counter::CreatedResources);
+        NullBackend::Count(NullBackend::Counter::ResourceBytes, size);
+    }
+
+    void Update(void* data) override
+    {
+        if (mData && data)
+            ::memcpy(mData, data, mSize);
+    }
+
+    void* GetResource() const override { return mData; }
+    void* GetConstantBufferView() const override { return mData; }
+private:
+    void* mData = nullptr;
+    size_t mSize = 0u;
+};
+} // namespace LimitEngine
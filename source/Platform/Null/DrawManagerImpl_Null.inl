@@ -0,0 +1,111 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  DrawManagerImpl_Null.inl
+@brief DrawManager Implement (Null)
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#include "Renderer/CommandBuffer.h"
+#include "Renderer/NullBackend.h"
+
+namespace LimitEngine {
+    // Headless device : nothing is submitted, presents and fences are only counted
+    class DrawManagerImpl_Null : public DrawManagerImpl
+    {
+        enum {
+            SWAP_CHAIN_BUFFER_COUNT = 2,
+        };
+    public:
+        DrawManagerImpl_Null()
+        {
+            for (uint32 swapChainIndex = 0; swapChainIndex < SWAP_CHAIN_BUFFER_COUNT; swapChainIndex++) {
+                mDisplayBufferResourceStates[swapChainIndex] = ResourceState::Present;
+            }
+        }
+        virtual ~DrawManagerImpl_Null()
+        {}
+
+        virtual void* AllocateDescriptor(uint32 type) override { return nullptr; }
+
+        void* MakeInitParameter() override { return nullptr; }
+
+        void ReadyToRender() override {}
+
+        virtual LEMath::IntSize GetScreenSize() override
+        {
+            return mDisplayBufferSize;
+        }
+
+        void PreRenderFinished() override {}
+
+        void Init(WINDOW_HANDLE handle, const InitializeOptions& Options) override
+        {
+            mDisplayBufferSize = { Options.Resolution.Width(), Options.Resolution.Height() };
+        }
+
+        void* AllocateGPUBuffer(size_t size) override { return nullptr; }
+        void* GetImmediateCommandList() override { return nullptr; }
+
+        void ResizeScreen(const LEMath::IntSize& size) override { mDisplayBufferSize = size; }
+
+        void ProcessBeforeFlushingCommands() override {}
+
+        uint64 ExecuteImmediateCommandList(void* cmdlist, bool waitcompletion) override
+        {
+            return mFenceValue++;
+        }
+
+        void Finalize(CommandBuffer* commandBuffer) override
+        {
+            // Completes immediately
+            commandBuffer->ReadyToExecute();
+            commandBuffer->Finalize(mFenceValue++);
+        }
+
+        void Present() override
+        {
+            NullBackend::Count(NullBackend::Counter::Presents);
+            mCurrentFrameBufferIndex = (mCurrentFrameBufferIndex + 1) % SWAP_CHAIN_BUFFER_COUNT;
+        }
+
+        void Term() override {}
+
+        uint32 GetCurrentFrameBufferIndex() const override { return mCurrentFrameBufferIndex; }
+        const RendererFlag::BufferFormat& GetCurrentFrameBufferFormat() const override { return mDisplayBufferFormat; }
+        const ResourceState GetCurrentFrameBufferResourceState() const override { return mDisplayBufferResourceStates[mCurrentFrameBufferIndex]; }
+        void SetCurrentFrameBufferResourceState(ResourceState state) override { mDisplayBufferResourceStates[mCurrentFrameBufferIndex] = state; }
+        // Frame buffers are not null, so render target can be bound
+        void* GetCurrentFrameBuffer() const override { return (void*)&mDisplayBufferResourceStates[mCurrentFrameBufferIndex]; }
+        void* GetCurrentFrameBufferView() const override { return (void*)&mDisplayBufferResourceStates[mCurrentFrameBufferIndex]; }
+        void* GetDeviceHandle() const override { return nullptr; }
+        void* GetDeviceContext() const override { return nullptr; }
+
+    private:
+        uint32                                      mCurrentFrameBufferIndex = 0u;
+        uint64                                      mFenceValue = 1u;
+
+        LEMath::IntSize                             mDisplayBufferSize = LEMath::IntSize::Zero;
+        RendererFlag::BufferFormat                  mDisplayBufferFormat = RendererFlag::BufferFormat::R8G8B8A8_UNorm;
+        ResourceState                               mDisplayBufferResourceStates[SWAP_CHAIN_BUFFER_COUNT];
+    };
+}
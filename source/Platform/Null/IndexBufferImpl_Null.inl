@@ -0,0 +1,59 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  IndexBufferImpl_Null.inl
+@brief IndexBuffer for rendering (Null)
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#pragma once
+#include "Renderer/NullBackend.h"
+
+namespace LimitEngine {
+class IndexBufferImpl_Null : public IndexBufferImpl
+{
+public:
+    IndexBufferImpl_Null(IndexBuffer *InOwner)
+        : IndexBufferImpl(InOwner)
+    {}
+    virtual ~IndexBufferImpl_Null()
+    {}
+
+    virtual void Create(size_t Count, void* Buffer) override
+    {
+        // Contents are not kept (nothing reads them)
+        mSize = Count * sizeof(uint32);
+        NullBackend::Count(NullBackend::Counter::CreatedResources);
+        NullBackend::Count(NullBackend::Counter::ResourceBytes, mSize);
+    }
+    virtual void Dispose() override
+    {
+        mSize = 0u;
+    }
+    virtual void* GetHandle() override { return mSize ? this : nullptr; }
+    virtual void* GetResource() const override { return mSize ? (void*)this : nullptr; }
+    virtual void* GetBuffer() override { return nullptr; }
+
+private:
+    size_t mSize = 0u;
+};
+}
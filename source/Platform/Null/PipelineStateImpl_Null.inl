@@ -0,0 +1,52 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  PipelineStateImpl_Null.inl
+@brief PipelineState (Null)
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#include "Renderer/NullBackend.h"
+
+namespace LimitEngine {
+class PipelineStateImpl_Null : public PipelineStateImpl
+{
+public:
+    PipelineStateImpl_Null() {}
+    virtual ~PipelineStateImpl_Null() {}
+    virtual bool IsValid() const override { return mInitialized; }
+
+    virtual bool Init(const PipelineStateDescriptor& desc) override
+    {
+        mInitialized = true;
+        NullBackend::Count(NullBackend::Counter::CreatedResources);
+        return true;
+    }
+
+    // Not null, so pipeline state is treated as ready
+    virtual void* GetRootSignatureHandle() const override { return mInitialized ? (void*)this : nullptr; }
+    virtual void* GetHandle() const override { return mInitialized ? (void*)this : nullptr; }
+
+private:
+    bool mInitialized = false;
+};
+} // namespace LimitEngine
@@ -0,0 +1,110 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  TextureImpl_Null.inl
+@brief Texture (Null)
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#include "Renderer/NullBackend.h"
+
+namespace LimitEngine {
+    class TextureImpl_Null : public TextureImpl
+    {
+    public:
+        TextureImpl_Null(Texture *InOwner)
+            : TextureImpl(InOwner)
+        {}
+        virtual ~TextureImpl_Null()
+        {}
+        const LEMath::IntSize& GetSize() const override { return mSize; }
+        const RendererFlag::BufferFormat& GetFormat() const override { return mFormat; }
+        void* GetHandle() const override { return nullptr; }
+        void* GetDepthSurfaceHandle() const override { return nullptr; }
+
+        void LoadFromMemory(const void* data, size_t size) override
+        {
+            countCreation(size);
+        }
+        bool Create(const LEMath::IntSize &size, const RendererFlag::BufferFormat &format, uint32 usage, uint32 mipLevels, void *initData, size_t initDataSize) override
+        {
+            mSize = size;
+            mFormat = format;
+            countCreation(initData ? initDataSize : 0u);
+            return true;
+        }
+        bool Create3D(const LEMath::IntVector3& size, const RendererFlag::BufferFormat &format, uint32 usage, uint32 mipLevels, void* initData, size_t initDataSize) override
+        {
+            mSize = LEMath::IntSize(size.X(), size.Y());
+            mFormat = format;
+            countCreation(initData ? initDataSize : 0u);
+            return true;
+        }
+        void CreateScreenColor(const LEMath::IntSize& size) override
+        {
+            mSize = size;
+            mFormat = LE_DrawManagerRendererAccessor.GetCurrentFrameBufferFormat();
+            countCreation(0u);
+        }
+        void CreateColor(const LEMath::IntSize& size, const ByteColorRGBA& color) override
+        {
+            mSize = size;
+            mFormat = RendererFlag::BufferFormat::R8G8B8A8_UNorm;
+            countCreation(0u);
+        }
+        void CreateDepthStencil(const LEMath::IntSize& size, const RendererFlag::BufferFormat &format) override
+        {
+            mSize = size;
+            mFormat = format;
+            countCreation(0u);
+        }
+        void CreateRenderTarget(const LEMath::IntSize& size, const RendererFlag::BufferFormat& format, uint32 usage) override
+        {
+            mSize = size;
+            mFormat = format;
+            countCreation(0u);
+        }
+        void GenerateMipmap() override {}
+
+        // Views are not null, so texture is treated as created
+        void* GetResource() const override { return (void*)this; }
+        void* GetShaderResourceView() const override { return (void*)this; }
+        void* GetUnorderedAccessView() const override { return (void*)this; }
+        void* GetRenderTargetView() const override { return (void*)this; }
+        void* GetDepthStencilView() const override { return (void*)this; }
+
+        // No memory to map
+        void* Lock(const LEMath::IntRect& rect, int mipLevel) override { return nullptr; }
+        void Unlock(int mipLevel) override {}
+
+    private:
+        static void countCreation(size_t DataSize)
+        {
+            NullBackend::Count(NullBackend::Counter::CreatedResources);
+            NullBackend::Count(NullBackend::Counter::ResourceBytes, DataSize);
+        }
+
+    private:
+        LEMath::IntSize mSize = LEMath::IntSize::Zero;
+        RendererFlag::BufferFormat mFormat = RendererFlag::BufferFormat::Unknown;
+    };
+}
@@ -0,0 +1,56 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  VertexBufferImpl_Null.inl
+@brief VertexBuffer (Null)
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#include "Renderer/NullBackend.h"
+
+namespace LimitEngine {
+    class VertexBufferImpl_Null : public VertexBufferImpl
+    {
+    public:
+        VertexBufferImpl_Null() {}
+        virtual ~VertexBufferImpl_Null() {}
+
+        void Create(uint32 fvf, size_t stride, size_t size, uint32 flag, void* buffer) override
+        {
+            // Contents are not kept (nothing reads them)
+            mSize = stride * size;
+            NullBackend::Count(NullBackend::Counter::CreatedResources);
+            NullBackend::Count(NullBackend::Counter::ResourceBytes, mSize);
+        }
+        void Dispose() override
+        {
+            mSize = 0u;
+        }
+        void* GetHandle() override
+        {
+            return mSize ? this : nullptr;
+        }
+        void* GetResource() const override { return mSize ? (void*)this : nullptr; }
+    private:
+        size_t               mSize = 0u;
+    };
+}
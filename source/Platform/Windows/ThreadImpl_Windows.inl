@@ -47,5 +47,13 @@ namespace LimitEngine {
         WaitForSingleObject(threadhandle, INFINITE);
         CloseHandle(threadhandle);
     }
+    void ThreadImpl::Sleep(uint32 milliSecond)
+    {
+        ::Sleep(milliSecond);
+    }
+    void ThreadImpl::YieldThread()
+    {
+        ::SwitchToThread();
+    }
 } // LimitEngine
 #endif
\ No newline at end of file
@@ -9,6 +9,7 @@
 
 #include "Renderer/AABB.h"
 
+#include <math.h>
 #include <LEFloatVector3.h>
 
 #include "Core/Archive.h"
@@ -71,4 +72,22 @@ namespace LimitEngine {
 			}
 			return LEMath::FloatVector3();
 	}
+	AABB AABB::TransformBounds(const LEMath::FloatMatrix4x4 &m) const
+	{
+		// Center and half extent (Arvo) : extent of output axis j is sum of |m[i][j]| * extent[i]
+		const float *mat = reinterpret_cast<const float*>(&m);
+		const float center[3] = { (minimum.X() + maximum.X()) * 0.5f, (minimum.Y() + maximum.Y()) * 0.5f, (minimum.Z() + maximum.Z()) * 0.5f };
+		const float extent[3] = { (maximum.X() - minimum.X()) * 0.5f, (maximum.Y() - minimum.Y()) * 0.5f, (maximum.Z() - minimum.Z()) * 0.5f };
+		float outCenter[3], outExtent[3];
+		for (int j = 0; j < 3; j++) {
+			outCenter[j] = mat[12 + j];
+			outExtent[j] = 0.0f;
+			for (int i = 0; i < 3; i++) {
+				outCenter[j] += center[i] * mat[i * 4 + j];
+				outExtent[j] += extent[i] * fabsf(mat[i * 4 + j]);
+			}
+		}
+		return AABB(LEMath::FloatVector3(outCenter[0] - outExtent[0], outCenter[1] - outExtent[1], outCenter[2] - outExtent[2]),
+		            LEMath::FloatVector3(outCenter[0] + outExtent[0], outCenter[1] + outExtent[1], outCenter[2] + outExtent[2]));
+	}
 }
\ No newline at end of file
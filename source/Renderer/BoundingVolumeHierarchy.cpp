@@ -0,0 +1,463 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  BoundingVolumeHierarchy.cpp
+@brief Bounding volume hierarchy over boxes (culling / ray / overlap queries)
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#include "Renderer/BoundingVolumeHierarchy.h"
+
+#include <math.h>
+
+#include "Renderer/Frustum.h"
+
+namespace LimitEngine {
+// Bins of SAH on each axis
+static constexpr uint32 BVHBinCount = 16u;
+// Rebuild if refits make tree this much worse
+static constexpr float BVHRebuildCostRatio = 1.5f;
+
+// Traversal stack. Depth of SAH tree is small, deep trees spill to heap.
+typedef SmallVectorArray<uint32, 64> BVHStack;
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy()
+    : mAreaSum(0.0f)
+    , mBuiltCost(0.0f)
+    , mUpdateCount(0u)
+{}
+
+void BoundingVolumeHierarchy::Clear()
+{
+    mNodes.Clear();
+    mItems.Clear();
+    mItemBounds.Clear();
+    mItemSlots.Clear();
+    mItemLeaves.Clear();
+    mAreaSum = 0.0f;
+    mBuiltCost = 0.0f;
+    mUpdateCount = 0u;
+}
+
+void BoundingVolumeHierarchy::Build(const AABB *Boxes, uint32 Count)
+{
+    mNodes.Clear(false);
+    mBuildItems.Clear(false);
+    mItemSlots.Resize(Count);
+    mItemLeaves.Resize(Count);
+    for (uint32 item = 0; item < Count; item++) {
+        mItemSlots[item] = InvalidIndex;
+        mItemLeaves[item] = InvalidIndex;
+        if (Boxes[item].IsValid() == false)
+            continue;
+        BuildItem &buildItem = mBuildItems.Add();
+        buildItem.Box.Min[0] = Boxes[item].minimum.X(); buildItem.Box.Max[0] = Boxes[item].maximum.X();
+        buildItem.Box.Min[1] = Boxes[item].minimum.Y(); buildItem.Box.Max[1] = Boxes[item].maximum.Y();
+        buildItem.Box.Min[2] = Boxes[item].minimum.Z(); buildItem.Box.Max[2] = Boxes[item].maximum.Z();
+        for (int axis = 0; axis < 3; axis++)
+            buildItem.Centroid[axis] = (buildItem.Box.Min[axis] + buildItem.Box.Max[axis]) * 0.5f;
+        buildItem.Item = item;
+    }
+    mAreaSum = 0.0f;
+    mBuiltCost = 0.0f;
+    mUpdateCount = 0u;
+    const uint32 itemCount = mBuildItems.count();
+    mItems.Resize(itemCount);
+    mItemBounds.Resize(itemCount);
+    if (itemCount == 0u) {
+        mBuildItems.Clear();
+        return;
+    }
+
+    // Nodes are made top down, children of node are built after it
+    mNodes.Reserve(itemCount * 2u);
+    Node &root = mNodes.Add();
+    root.Parent = InvalidIndex;
+    root.ItemBegin = 0u;
+    root.ItemCount = itemCount;
+    BVHStack stack;
+    stack.Add(0u);
+    while (stack.count()) {
+        const uint32 nodeIndex = stack.PopBack();
+
+        const uint32 begin = mNodes[nodeIndex].ItemBegin;
+        const uint32 end = begin + mNodes[nodeIndex].ItemCount;
+        Bounds nodeBounds, centroidBounds;
+        nodeBounds.SetEmpty();
+        centroidBounds.SetEmpty();
+        for (uint32 itemIndex = begin; itemIndex < end; itemIndex++) {
+            const BuildItem &buildItem = mBuildItems[itemIndex];
+            nodeBounds.Merge(buildItem.Box);
+            for (int axis = 0; axis < 3; axis++) {
+                centroidBounds.Min[axis] = (centroidBounds.Min[axis] < buildItem.Centroid[axis]) ? centroidBounds.Min[axis] : buildItem.Centroid[axis];
+                centroidBounds.Max[axis] = (centroidBounds.Max[axis] > buildItem.Centroid[axis]) ? centroidBounds.Max[axis] : buildItem.Centroid[axis];
+            }
+        }
+        mNodes[nodeIndex].Box = nodeBounds;
+
+        if (end - begin <= MaxLeafItemCount) {
+            mNodes[nodeIndex].Child = InvalidIndex;
+            for (uint32 itemIndex = begin; itemIndex < end; itemIndex++) {
+                const BuildItem &buildItem = mBuildItems[itemIndex];
+                mItems[itemIndex] = buildItem.Item;
+                mItemBounds[itemIndex] = buildItem.Box;
+                mItemSlots[buildItem.Item] = itemIndex;
+                mItemLeaves[buildItem.Item] = nodeIndex;
+            }
+            continue;
+        }
+
+        const uint32 middle = splitItems(begin, end, centroidBounds);
+        const uint32 childIndex = mNodes.count();
+        mNodes[nodeIndex].Child = childIndex;
+        Node &left = mNodes.Add();
+        left.Parent = nodeIndex;
+        left.ItemBegin = begin;
+        left.ItemCount = middle - begin;
+        Node &right = mNodes.Add();
+        right.Parent = nodeIndex;
+        right.ItemBegin = middle;
+        right.ItemCount = end - middle;
+        stack.Add(childIndex + 1u);
+        stack.Add(childIndex);
+    }
+    mBuildItems.Clear();
+    // Node index is packed with plane mask in QueryFrustum
+    LEASSERT(mNodes.count() < (1u << 24));
+    for (uint32 nodeIndex = 0; nodeIndex < mNodes.count(); nodeIndex++)
+        mAreaSum += getNodeCost(mNodes[nodeIndex]);
+    mBuiltCost = GetCost();
+}
+
+uint32 BoundingVolumeHierarchy::splitItems(uint32 Begin, uint32 End, const Bounds &CentroidBounds)
+{
+    struct Bin
+    {
+        Bounds Box;
+        uint32 Count;
+    };
+    Bin bins[3][BVHBinCount];
+    float binScales[3];
+    for (int axis = 0; axis < 3; axis++) {
+        const float extent = CentroidBounds.Max[axis] - CentroidBounds.Min[axis];
+        binScales[axis] = (extent > 0.0f) ? BVHBinCount / extent : 0.0f;
+        for (uint32 binIndex = 0; binIndex < BVHBinCount; binIndex++) {
+            bins[axis][binIndex].Box.SetEmpty();
+            bins[axis][binIndex].Count = 0u;
+        }
+    }
+    for (uint32 itemIndex = Begin; itemIndex < End; itemIndex++) {
+        const BuildItem &buildItem = mBuildItems[itemIndex];
+        for (int axis = 0; axis < 3; axis++) {
+            const uint32 binIndex = MIN(static_cast<uint32>((buildItem.Centroid[axis] - CentroidBounds.Min[axis]) * binScales[axis]), BVHBinCount - 1u);
+            bins[axis][binIndex].Box.Merge(buildItem.Box);
+            bins[axis][binIndex].Count++;
+        }
+    }
+
+    float bestCost = FLT_MAX;
+    int bestAxis = -1;
+    uint32 bestBin = 0u;
+    for (int axis = 0; axis < 3; axis++) {
+        if (binScales[axis] == 0.0f)
+            continue;
+        // Cost of split before bin n : area(left) * count(left) + area(right) * count(right)
+        float leftCosts[BVHBinCount];
+        Bounds sweepBounds;
+        sweepBounds.SetEmpty();
+        uint32 sweepCount = 0u;
+        for (uint32 binIndex = 0; binIndex < BVHBinCount - 1u; binIndex++) {
+            sweepBounds.Merge(bins[axis][binIndex].Box);
+            sweepCount += bins[axis][binIndex].Count;
+            leftCosts[binIndex] = sweepCount ? sweepBounds.GetHalfArea() * sweepCount : 0.0f;
+        }
+        sweepBounds.SetEmpty();
+        sweepCount = 0u;
+        for (uint32 binIndex = BVHBinCount - 1u; binIndex > 0u; binIndex--) {
+            sweepBounds.Merge(bins[axis][binIndex].Box);
+            sweepCount += bins[axis][binIndex].Count;
+            const float cost = leftCosts[binIndex - 1u] + (sweepCount ? sweepBounds.GetHalfArea() * sweepCount : 0.0f);
+            if (sweepCount > 0u && sweepCount < End - Begin && cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = binIndex;
+            }
+        }
+    }
+    // All centroids are same : split in order
+    if (bestAxis < 0)
+        return (Begin + End) / 2u;
+
+    uint32 left = Begin, right = End;
+    while (left < right) {
+        const BuildItem &buildItem = mBuildItems[left];
+        const uint32 binIndex = MIN(static_cast<uint32>((buildItem.Centroid[bestAxis] - CentroidBounds.Min[bestAxis]) * binScales[bestAxis]), BVHBinCount - 1u);
+        if (binIndex < bestBin) {
+            left++;
+        }
+        else {
+            right--;
+            const BuildItem swapItem = mBuildItems[left];
+            mBuildItems[left] = mBuildItems[right];
+            mBuildItems[right] = swapItem;
+        }
+    }
+    return left;
+}
+
+void BoundingVolumeHierarchy::refitNode(uint32 NodeIndex)
+{
+    Node &node = mNodes[NodeIndex];
+    if (node.IsLeaf()) {
+        node.Box = mItemBounds[node.ItemBegin];
+        for (uint32 itemIndex = node.ItemBegin + 1u; itemIndex < node.ItemBegin + node.ItemCount; itemIndex++)
+            node.Box.Merge(mItemBounds[itemIndex]);
+    }
+    else {
+        node.Box = mNodes[node.Child].Box;
+        node.Box.Merge(mNodes[node.Child + 1u].Box);
+    }
+}
+
+bool BoundingVolumeHierarchy::Update(uint32 Item, const AABB &Box)
+{
+    if (Item >= mItemSlots.count() || mItemSlots[Item] == InvalidIndex || Box.IsValid() == false)
+        return false;
+    Bounds &itemBounds = mItemBounds[mItemSlots[Item]];
+    itemBounds.Min[0] = Box.minimum.X(); itemBounds.Max[0] = Box.maximum.X();
+    itemBounds.Min[1] = Box.minimum.Y(); itemBounds.Max[1] = Box.maximum.Y();
+    itemBounds.Min[2] = Box.minimum.Z(); itemBounds.Max[2] = Box.maximum.Z();
+    mUpdateCount++;
+    // Refit to root, stop at node not changed
+    for (uint32 nodeIndex = mItemLeaves[Item]; nodeIndex != InvalidIndex; nodeIndex = mNodes[nodeIndex].Parent) {
+        const Bounds oldBounds = mNodes[nodeIndex].Box;
+        const float oldCost = getNodeCost(mNodes[nodeIndex]);
+        refitNode(nodeIndex);
+        if (mNodes[nodeIndex].Box == oldBounds)
+            break;
+        mAreaSum += getNodeCost(mNodes[nodeIndex]) - oldCost;
+    }
+    return true;
+}
+
+float BoundingVolumeHierarchy::GetCost() const
+{
+    if (mNodes.count() == 0u)
+        return 0.0f;
+    const float rootArea = mNodes[0].Box.GetHalfArea();
+    return (rootArea > 0.0f) ? mAreaSum / rootArea : mAreaSum;
+}
+
+float BoundingVolumeHierarchy::getNodeCost(const Node &InNode)
+{
+    return InNode.Box.GetHalfArea() * (InNode.IsLeaf() ? static_cast<float>(InNode.ItemCount) : 1.0f);
+}
+
+bool BoundingVolumeHierarchy::NeedsRebuild() const
+{
+    if (mUpdateCount == 0u)
+        return false;
+    return GetCost() > mBuiltCost * BVHRebuildCostRatio;
+}
+
+void BoundingVolumeHierarchy::addItems(const Node &InNode, VectorArray<uint32> &OutItems) const
+{
+    OutItems.Append(&mItems[InNode.ItemBegin], InNode.ItemCount);
+}
+
+void BoundingVolumeHierarchy::QueryFrustum(const Frustum &InFrustum, VectorArray<uint32> &OutItems) const
+{
+    if (mNodes.count() == 0u)
+        return;
+    float planes[Frustum::PlaneCount][4], absPlanes[Frustum::PlaneCount][3];
+    for (int planeIndex = 0; planeIndex < Frustum::PlaneCount; planeIndex++) {
+        const LEMath::FloatVector4 plane = InFrustum.GetPlane(static_cast<Frustum::Plane>(planeIndex));
+        planes[planeIndex][0] = plane.X(); planes[planeIndex][1] = plane.Y(); planes[planeIndex][2] = plane.Z(); planes[planeIndex][3] = plane.W();
+        for (int axis = 0; axis < 3; axis++)
+            absPlanes[planeIndex][axis] = fabsf(planes[planeIndex][axis]);
+    }
+    // Returns planes that box still crosses, or 0xff if box is outside
+    auto testBox = [&](const Bounds &Box, uint32 PlaneMask) -> uint32 {
+        float center[3], extent[3];
+        for (int axis = 0; axis < 3; axis++) {
+            center[axis] = (Box.Min[axis] + Box.Max[axis]) * 0.5f;
+            extent[axis] = (Box.Max[axis] - Box.Min[axis]) * 0.5f;
+        }
+        for (int planeIndex = 0; planeIndex < Frustum::PlaneCount; planeIndex++) {
+            if ((PlaneMask & (1u << planeIndex)) == 0u)
+                continue;
+            const float distance = planes[planeIndex][0] * center[0] + planes[planeIndex][1] * center[1] + planes[planeIndex][2] * center[2] + planes[planeIndex][3];
+            const float radius = absPlanes[planeIndex][0] * extent[0] + absPlanes[planeIndex][1] * extent[1] + absPlanes[planeIndex][2] * extent[2];
+            if (distance + radius < 0.0f)
+                return 0xffu;
+            if (distance - radius >= 0.0f)  // Inside of this plane, children too
+                PlaneMask &= ~(1u << planeIndex);
+        }
+        return PlaneMask;
+    };
+
+    const uint32 allPlanes = (1u << Frustum::PlaneCount) - 1u;
+    // Entry : node index << 8 | planes to test
+    BVHStack stack;
+    stack.Add(allPlanes);
+    while (stack.count()) {
+        const uint32 entry = stack.PopBack();
+        const Node &node = mNodes[entry >> 8];
+        const uint32 planeMask = testBox(node.Box, entry & 0xffu);
+        if (planeMask == 0xffu)
+            continue;
+        if (planeMask == 0u) {
+            addItems(node, OutItems);
+        }
+        else if (node.IsLeaf()) {
+            for (uint32 itemIndex = node.ItemBegin; itemIndex < node.ItemBegin + node.ItemCount; itemIndex++) {
+                if (testBox(mItemBounds[itemIndex], planeMask) != 0xffu)
+                    OutItems.Add(mItems[itemIndex]);
+            }
+        }
+        else {
+            stack.Add(((node.Child + 1u) << 8) | planeMask);
+            stack.Add((node.Child << 8) | planeMask);
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::QueryBox(const AABB &Box, VectorArray<uint32> &OutItems) const
+{
+    if (mNodes.count() == 0u)
+        return;
+    const float queryMin[3] = { Box.minimum.X(), Box.minimum.Y(), Box.minimum.Z() };
+    const float queryMax[3] = { Box.maximum.X(), Box.maximum.Y(), Box.maximum.Z() };
+    auto overlaps = [&](const Bounds &b) {
+        return b.Min[0] <= queryMax[0] && b.Max[0] >= queryMin[0]
+            && b.Min[1] <= queryMax[1] && b.Max[1] >= queryMin[1]
+            && b.Min[2] <= queryMax[2] && b.Max[2] >= queryMin[2];
+    };
+    BVHStack stack;
+    stack.Add(0u);
+    while (stack.count()) {
+        const Node &node = mNodes[stack.PopBack()];
+        if (overlaps(node.Box) == false)
+            continue;
+        if (node.IsLeaf()) {
+            for (uint32 itemIndex = node.ItemBegin; itemIndex < node.ItemBegin + node.ItemCount; itemIndex++) {
+                if (overlaps(mItemBounds[itemIndex]))
+                    OutItems.Add(mItems[itemIndex]);
+            }
+        }
+        else {
+            stack.Add(node.Child + 1u);
+            stack.Add(node.Child);
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::QuerySphere(const LEMath::FloatVector3 &Center, float Radius, VectorArray<uint32> &OutItems) const
+{
+    if (mNodes.count() == 0u)
+        return;
+    const float center[3] = { Center.X(), Center.Y(), Center.Z() };
+    const float radiusSq = Radius * Radius;
+    auto overlaps = [&](const Bounds &b) {
+        float distanceSq = 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            const float d = (center[axis] < b.Min[axis]) ? b.Min[axis] - center[axis] : ((center[axis] > b.Max[axis]) ? center[axis] - b.Max[axis] : 0.0f);
+            distanceSq += d * d;
+        }
+        return distanceSq <= radiusSq;
+    };
+    BVHStack stack;
+    stack.Add(0u);
+    while (stack.count()) {
+        const Node &node = mNodes[stack.PopBack()];
+        if (overlaps(node.Box) == false)
+            continue;
+        if (node.IsLeaf()) {
+            for (uint32 itemIndex = node.ItemBegin; itemIndex < node.ItemBegin + node.ItemCount; itemIndex++) {
+                if (overlaps(mItemBounds[itemIndex]))
+                    OutItems.Add(mItems[itemIndex]);
+            }
+        }
+        else {
+            stack.Add(node.Child + 1u);
+            stack.Add(node.Child);
+        }
+    }
+}
+
+bool BoundingVolumeHierarchy::RayCast(const fRay &Ray, RayHit &OutHit) const
+{
+    if (mNodes.count() == 0u)
+        return false;
+    const float length = Ray.GetLength();
+    if (length <= 0.0f)
+        return false;
+    const float origin[3] = { Ray.org.X(), Ray.org.Y(), Ray.org.Z() };
+    const float invDirection[3] = { length / (Ray.tar.X() - Ray.org.X()), length / (Ray.tar.Y() - Ray.org.Y()), length / (Ray.tar.Z() - Ray.org.Z()) };
+    float nearest = length;
+    // Distance of entry, FLT_MAX if ray misses box before nearest
+    auto intersect = [&](const Bounds &b) {
+        float tmin = 0.0f, tmax = nearest;
+        for (int axis = 0; axis < 3; axis++) {
+            float t0 = (b.Min[axis] - origin[axis]) * invDirection[axis];
+            float t1 = (b.Max[axis] - origin[axis]) * invDirection[axis];
+            if (t0 > t1) { const float t = t0; t0 = t1; t1 = t; }
+            // NaN (origin on slab of parallel ray) keeps range
+            tmin = (t0 > tmin) ? t0 : tmin;
+            tmax = (t1 < tmax) ? t1 : tmax;
+        }
+        return (tmin <= tmax) ? tmin : FLT_MAX;
+    };
+
+    OutHit = RayHit();
+    BVHStack stack;
+    if (intersect(mNodes[0].Box) == FLT_MAX)
+        return false;
+    stack.Add(0u);
+    while (stack.count()) {
+        const Node &node = mNodes[stack.PopBack()];
+        if (node.IsLeaf()) {
+            for (uint32 itemIndex = node.ItemBegin; itemIndex < node.ItemBegin + node.ItemCount; itemIndex++) {
+                const float distance = intersect(mItemBounds[itemIndex]);
+                if (distance < nearest || (distance == nearest && OutHit.Item == InvalidIndex)) {
+                    nearest = distance;
+                    OutHit.Item = mItems[itemIndex];
+                    OutHit.Distance = distance;
+                }
+            }
+            continue;
+        }
+        // Nearer child first, skip children farther than nearest hit
+        const float leftDistance = intersect(mNodes[node.Child].Box);
+        const float rightDistance = intersect(mNodes[node.Child + 1u].Box);
+        const uint32 nearChild = (leftDistance <= rightDistance) ? node.Child : node.Child + 1u;
+        const uint32 farChild = (leftDistance <= rightDistance) ? node.Child + 1u : node.Child;
+        const float nearDistance = MIN(leftDistance, rightDistance);
+        const float farDistance = MAX(leftDistance, rightDistance);
+        if (farDistance != FLT_MAX)
+            stack.Add(farChild);
+        if (nearDistance != FLT_MAX)
+            stack.Add(nearChild);
+    }
+    return OutHit.Item != InvalidIndex;
+}
+} // namespace LimitEngine
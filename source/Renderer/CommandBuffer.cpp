@@ -43,545 +43,887 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "../Platform/DirectX11/CommandImpl_DirectX11.inl"
 #elif USE_DX12
 #include "../Platform/DirectX12/CommandImpl_DirectX12.inl"
+#elif USE_NULL
+#include "../Platform/Null/CommandImpl_Null.inl"
 #else
 #error No implementation for CommandBuffer
 #endif
 
 namespace LimitEngine {
+thread_local CommandSegment* CommandBuffer::sRecordingSegment = nullptr;
+
 CommandBuffer::CommandBuffer(size_t bufferSize)
-    : mCommandBuffer(NULL)
-    , mImpl(nullptr)
+    : mImpl(nullptr)
+    , mPushPage(nullptr)
     , mPushCommandBufferPointer(NULL)
+    , mPullPage(nullptr)
     , mPullCommandBufferPointer(NULL)
+    , mFreePages()
+    , mMemoryStatistics()
+    , mFrameMarks()
+    , mRecording()
     , mMutex()
 {
+    mRecording.Reset(true);
 #ifdef USE_DX11
     mImpl = new CommandImpl_DirectX11();
 #elif USE_DX12
     mImpl = new CommandImpl_DirectX12();
+#elif USE_NULL
+    mImpl = new CommandImpl_Null();
 #endif
-    mCommandBuffer = malloc(bufferSize);
-    mPushCommandBufferPointer = mCommandBuffer;
-    mPullCommandBufferPointer = mCommandBuffer;
+    const uint32 pageCount = MAX(static_cast<uint32>(bufferSize / CommandPageSize), 1u);
+    mFreePages.Reserve(pageCount);
+    for (uint32 pageIndex = 0; pageIndex < pageCount; pageIndex++)
+        mFreePages.Add(createPage(CommandPageSize));
+    mPushPage = acquirePage(CommandPageSize);
+    mPullPage = mPushPage;
+    mPushCommandBufferPointer = mPushPage->GetMemory();
+    mPullCommandBufferPointer = mPushCommandBufferPointer;
 }
 CommandBuffer::~CommandBuffer()
 {
+    for (CommandSegment *segment : mSegments)
+        delete segment;
+    mSegments.Clear();
+    mFreeSegments.Clear();
     if (mImpl) {
         delete mImpl;
         mImpl = nullptr;
     }
-    if (mCommandBuffer) {
-        free(mCommandBuffer);
-        mCommandBuffer = NULL;
+    while (mPullPage) {
+        CommandPage *nextPage = mPullPage->Next;
+        free(mPullPage);
+        mPullPage = nextPage;
     }
+    mPushPage = nullptr;
+    for (CommandPage *page : mFreePages)
+        free(page);
+    mFreePages.Clear();
 }
 
 void CommandBuffer::ReleaseRendererResources()
 {
-    if (ReservedRendererResources.Textures.count())
-    for (TextureInterface* texture : ReservedRendererResources.Textures)
+    Mutex::ScopedLock scopedLock(mRetiredRendererResourceMutex);
+    if (mRetiredRendererResources.Textures.count())
+    for (TextureInterface* texture : mRetiredRendererResources.Textures)
         delete texture;
-    if (ReservedRendererResources.IndexBuffers.count())
-    for (IndexBuffer* indexbuffer : ReservedRendererResources.IndexBuffers)
+    if (mRetiredRendererResources.IndexBuffers.count())
+    for (IndexBuffer* indexbuffer : mRetiredRendererResources.IndexBuffers)
         delete indexbuffer;
-    if (ReservedRendererResources.VertexBuffers.count())
-    for (VertexBufferGeneric* vertexbuffer : ReservedRendererResources.VertexBuffers)
+    if (mRetiredRendererResources.VertexBuffers.count())
+    for (VertexBufferGeneric* vertexbuffer : mRetiredRendererResources.VertexBuffers)
         delete vertexbuffer;
-    if (ReservedRendererResources.ConstantBuffers.count())
-    for (ConstantBuffer* buffer : ReservedRendererResources.ConstantBuffers)
+    if (mRetiredRendererResources.ConstantBuffers.count())
+    for (ConstantBuffer* buffer : mRetiredRendererResources.ConstantBuffers)
         delete buffer;
-    if (ReservedRendererResources.SamplerStates.count())
-    for (SamplerState* samplerstate : ReservedRendererResources.SamplerStates)
+    if (mRetiredRendererResources.SamplerStates.count())
+    for (SamplerState* samplerstate : mRetiredRendererResources.SamplerStates)
         delete samplerstate;
-    if (ReservedRendererResources.PipelineStates.count())
-    for (PipelineState* pipelinestate : ReservedRendererResources.PipelineStates)
+    if (mRetiredRendererResources.PipelineStates.count())
+    for (PipelineState* pipelinestate : mRetiredRendererResources.PipelineStates)
         delete pipelinestate;
+    mRetiredRendererResources.Clear();
+}
+
+void CommandBuffer::RetireRendererResources()
+{
+    Mutex::ScopedLock scopedLock(mRetiredRendererResourceMutex);
+    mRetiredRendererResources.Append(ReservedRendererResources);
     ReservedRendererResources.Clear();
 }
 
-CommandBuffer::COMMAND* CommandBuffer::popPushCommandBuffer()
+void* CommandBuffer::allocateCommand(size_t Size)
 {
+    // Commands over page size get own page, but Size still has to fit in commandSize (and keep alignment)
+    LEASSERT(Size < CommandSizeLimit && (Size % CommandAlignment) == 0);
+    if (sRecordingSegment)
+        return sRecordingSegment->allocateCommand(Size);
+
     Mutex::ScopedLock scopedLock(mMutex);
-    COMMAND *currentCommandBufferPointer = (COMMAND*)mPushCommandBufferPointer;
-    mPushCommandBufferPointer = (COMMAND*)mPushCommandBufferPointer + 1;
-    if ((uintptr_t)mPushCommandBufferPointer >= (uintptr_t)mCommandBuffer + CommandReservedMemorySize)
-        mPushCommandBufferPointer = mCommandBuffer;
-    return (COMMAND*)currentCommandBufferPointer;
+    mRecording.Statistics.RecordedCommands++;
+    mRecording.Statistics.RecordedBytes += static_cast<uint32>(Size);
+    const size_t leftSize = mPushPage->GetEnd() - mPushCommandBufferPointer;
+    if (leftSize < Size) {
+        if (leftSize) { // Skip rest of page (commands are aligned, so it always has room for this)
+            COMMAND_NEXTPAGE *nextPageCommand = new(mPushCommandBufferPointer) COMMAND_NEXTPAGE();
+            nextPageCommand->commandSize = static_cast<uint32>(leftSize);
+        }
+        CommandPage *nextPage = acquirePage(MAX(Size, static_cast<size_t>(CommandPageSize)));
+        mPushPage->Next = nextPage;
+        mPushPage = nextPage;
+        mPushCommandBufferPointer = nextPage->GetMemory();
+        mMemoryStatistics.PageSwitches++;
+    }
+    uint8 *output = mPushCommandBufferPointer;
+    mPushCommandBufferPointer += Size;
+    return output;
 }
 
-CommandBuffer::COMMAND* CommandBuffer::nextPushCommandBuffer(int count)
+CommandBuffer::CommandPage* CommandBuffer::createPage(size_t Size)
 {
-    Mutex::ScopedLock scopedLock(mMutex);
-    void *LastPushCommand = mPushCommandBufferPointer;
-    mPushCommandBufferPointer = (COMMAND*)mPushCommandBufferPointer + count;
-    if (((intptr_t)mPushCommandBufferPointer) - ((intptr_t)mCommandBuffer) >= CommandReservedMemorySize) {
-        intptr_t overMemoryOffset = GetSizeAlign<intptr_t>((intptr_t)mPushCommandBufferPointer - ((intptr_t)mCommandBuffer + CommandReservedMemorySize), static_cast<intptr_t>(sizeof(COMMAND)));
-        mPushCommandBufferPointer = (uint8*)mCommandBuffer + overMemoryOffset;
+    CommandPage *page = static_cast<CommandPage*>(malloc(GetSizeAlign<size_t>(sizeof(CommandPage), CommandAlignment) + Size));
+    page->Next = nullptr;
+    page->Size = Size;
+    if (Size == CommandPageSize)
+        mMemoryStatistics.PageCount++;
+    return page;
+}
+
+CommandBuffer::CommandPage* CommandBuffer::acquirePage(size_t Size)
+{
+    CommandPage *page = nullptr;
+    if (Size > CommandPageSize) { // Own page for large command (not pooled)
+        page = createPage(Size);
+        mMemoryStatistics.OversizedCommands++;
+    }
+    else if (mFreePages.count()) {
+        page = mFreePages.PopBack();
+        page->Next = nullptr;
+    }
+    else { // Every page is waiting for flush
+        page = createPage(CommandPageSize);
+        mMemoryStatistics.PageGrowths++;
     }
-    return (COMMAND*)mPushCommandBufferPointer;
+    if (page->Size == CommandPageSize) {
+        mMemoryStatistics.PagesInUse++;
+        mMemoryStatistics.PeakPagesInUse = MAX(mMemoryStatistics.PeakPagesInUse, mMemoryStatistics.PagesInUse);
+    }
+    mMemoryStatistics.BytesInUse += page->Size;
+    mMemoryStatistics.FrameHighWaterBytes = MAX(mMemoryStatistics.FrameHighWaterBytes, mMemoryStatistics.BytesInUse);
+    return page;
 }
 
-CommandBuffer::COMMAND* CommandBuffer::nextPullCommandBuffer()
+void CommandBuffer::releasePage(CommandPage *Page)
 {
-    COMMAND *currentCommand = (COMMAND*)mPullCommandBufferPointer;
-    COMMAND *nextCommand = currentCommand + currentCommand->nextOffset;
-    if ((uintptr_t)mCommandBuffer + CommandReservedMemorySize <= (uintptr_t)nextCommand) {
-        intptr_t leftCountCB = ((intptr_t)mCommandBuffer + CommandReservedMemorySize - (intptr_t)currentCommand) / sizeof(COMMAND);
-        nextCommand = (COMMAND*)mCommandBuffer + currentCommand->nextOffset - leftCountCB;
+    mMemoryStatistics.BytesInUse -= Page->Size;
+    if (Page->Size == CommandPageSize) {
+        mMemoryStatistics.PagesInUse--;
+        mFreePages.Add(Page);
+    }
+    else {
+        free(Page);
     }
-    mPullCommandBufferPointer = nextCommand;
-    return (COMMAND*)mPullCommandBufferPointer;
 }
 
-void CommandBuffer::SetCommand(COMMAND_COMMON *cmd)
+CommandBuffer::MemoryStatistics CommandBuffer::GetMemoryStatistics()
 {
-    ::memcpy(mPushCommandBufferPointer, cmd, sizeof(COMMAND));
+    Mutex::ScopedLock scopedLock(mMutex);
+    return mMemoryStatistics;
+}
+
+void CommandBuffer::ResetMemoryStatistics()
+{
+    Mutex::ScopedLock scopedLock(mMutex);
+    MemoryStatistics statistics;
+    statistics.PageCount = mMemoryStatistics.PageCount;
+    statistics.PagesInUse = mMemoryStatistics.PagesInUse;
+    statistics.PeakPagesInUse = mMemoryStatistics.PagesInUse;
+    statistics.BytesInUse = mMemoryStatistics.BytesInUse;
+    statistics.FrameHighWaterBytes = mMemoryStatistics.BytesInUse;
+    mMemoryStatistics = statistics;
 }
 
-void CommandBuffer::AddCommand(CommandBuffer::COMMAND_COMMON *cmd)
+void CommandBuffer::closeFrameMemoryStatistics()
 {
     Mutex::ScopedLock scopedLock(mMutex);
-    ::memcpy(mPushCommandBufferPointer, cmd, sizeof(COMMAND));
-    nextPushCommandBuffer();
+    mMemoryStatistics.LastFrameHighWaterBytes = mMemoryStatistics.FrameHighWaterBytes;
+    mMemoryStatistics.FrameHighWaterBytes = mMemoryStatistics.BytesInUse;
 }
 
-void* CommandBuffer::allocateFromCommandBuffer(size_t size)
+void CommandBuffer::SetRedundantStateElimination(bool Enabled)
 {
     Mutex::ScopedLock scopedLock(mMutex);
-    size_t alignedSize = GetSizeAlign(size, sizeof(COMMAND));
-    size_t countCB = alignedSize / sizeof(COMMAND);
-    void *outputPointer = mPushCommandBufferPointer;
-    // Allocate from ring buffer
-    if (uintptr_t(mPushCommandBufferPointer) + alignedSize > uintptr_t(mCommandBuffer) + CommandReservedMemorySize) {
-        size_t leftCountCB = (intptr_t(mCommandBuffer) + CommandReservedMemorySize - intptr_t(mPushCommandBufferPointer)) / sizeof(COMMAND);
-        outputPointer = mCommandBuffer;
-        nextPushCommandBuffer(static_cast<int>(countCB + leftCountCB));
+    mRecording.RedundantStateElimination = Enabled;
+}
+
+CommandBuffer::RecordingStatistics CommandBuffer::GetRecordingStatistics()
+{
+    Mutex::ScopedLock scopedLock(mMutex);
+    return mRecording.Statistics;
+}
+
+void CommandBuffer::ResetRecordingStatistics()
+{
+    Mutex::ScopedLock scopedLock(mMutex);
+    mRecording.Statistics = RecordingStatistics();
+}
+
+struct CommandBuffer::RecordingTarget
+{
+    RecordingTarget(CommandBuffer *Owner)
+        : LockedMutex(sRecordingSegment ? nullptr : &Owner->mMutex)
+        , Context(sRecordingSegment ? sRecordingSegment->mRecording : Owner->mRecording)
+    {
+        if (LockedMutex)
+            LockedMutex->Lock();
     }
-    else
+    ~RecordingTarget()
     {
-        nextPushCommandBuffer(static_cast<int>(countCB));
+        if (LockedMutex)
+            LockedMutex->Unlock();
     }
-    
-    return outputPointer;
+    Mutex               *LockedMutex;
+    RecordingContext    &Context;
+};
+
+bool CommandBuffer::shadowPipelineState(PipelineState *pso)
+{
+    RecordingTarget target(this);
+    if (!shadowBinding(target.Context, target.Context.Shadow.PipelineState, pso, target.Context.Statistics.ElidedPipelineStates))
+        return false;
+    // New root signature drops bindings of slots in backend
+    target.Context.Shadow.ClearSlots();
+    return true;
 }
 
-void* CommandBuffer::duplicateBuffer(void* data, size_t size)
+bool CommandBuffer::shadowVertexBuffer(VertexBufferGeneric *vb)
 {
-    void* output = allocateFromCommandBuffer(size);
-    ::memcpy(output, data, size);
-    return output;
+    RecordingTarget target(this);
+    return shadowBinding(target.Context, target.Context.Shadow.VertexBuffer, vb, target.Context.Statistics.ElidedVertexBuffers);
 }
 
-float* CommandBuffer::copyMatrixToBuffer(float *ptr)
+bool CommandBuffer::shadowIndexBuffer(IndexBuffer *ib)
 {
-    float *output = static_cast<float*>(allocateFromCommandBuffer(sizeof(LEMath::FloatMatrix4x4)));
-    ::memcpy(output, ptr, sizeof(LEMath::FloatMatrix4x4));
-    return output;
+    RecordingTarget target(this);
+    return shadowBinding(target.Context, target.Context.Shadow.IndexBuffer, ib, target.Context.Statistics.ElidedIndexBuffers);
 }
 
-char* CommandBuffer::duplicateString(const char *src)
+bool CommandBuffer::shadowConstantBuffer(uint32 Index, ConstantBuffer *cb)
 {
-    size_t srclength = strlen(src) + 1;
-    char *output = static_cast<char*>(allocateFromCommandBuffer(srclength));
-    ::memcpy(output, src, srclength);
-    return output;
+    RecordingTarget target(this);
+    return shadowBinding(target.Context, target.Context.Shadow.ConstantBuffers, Index, cb, target.Context.Statistics.ElidedConstantBuffers);
+}
+
+bool CommandBuffer::shadowTexture(uint32 Index, TextureInterface *tex)
+{
+    RecordingTarget target(this);
+    return shadowBinding(target.Context, target.Context.Shadow.Textures, Index, tex, target.Context.Statistics.ElidedTextures);
+}
+
+bool CommandBuffer::shadowSampler(uint32 Index, SamplerState *sampler)
+{
+    RecordingTarget target(this);
+    return shadowBinding(target.Context, target.Context.Shadow.Samplers, Index, sampler, target.Context.Statistics.ElidedSamplers);
+}
+
+void CommandBuffer::invalidateShadowTexture(uint32 Index)
+{
+    RecordingTarget target(this);
+    if (Index < ShadowSlotCount)
+        target.Context.Shadow.Textures.ValidMask &= ~(1u << Index);
 }
 
-uint32 CommandBuffer::CalculateCommandOffset(COMMAND *cmd)
+void CommandBuffer::resetShadowState()
 {
-    if ((intptr_t)mPushCommandBufferPointer < (intptr_t)cmd) { // Back to origin
-        size_t leftCountCB = (intptr_t(mCommandBuffer) + CommandReservedMemorySize - intptr_t(cmd)) / sizeof(COMMAND);
-        size_t countFromOrigin = (intptr_t(mPushCommandBufferPointer) - intptr_t(mCommandBuffer)) / sizeof(COMMAND);
-        return static_cast<uint32>(leftCountCB + countFromOrigin);
+    RecordingTarget target(this);
+    target.Context.Shadow.Clear();
+}
+
+bool CommandBuffer::shadowBinding(RecordingContext &Context, const void *&Bound, const void *Resource, uint32 &ElidedCount)
+{
+    if (Context.RedundantStateElimination && Resource && Bound == Resource) {
+        ElidedCount++;
+        Context.Statistics.ElidedCommands++;
+        return false;
     }
-    else {
-        intptr_t nextOffset = (intptr_t(mPushCommandBufferPointer) - intptr_t(cmd)) / sizeof(COMMAND);
-        return static_cast<uint32>(nextOffset);
+    Bound = Resource;
+    return true;
+}
+
+bool CommandBuffer::shadowBinding(RecordingContext &Context, ShadowSlots &Slots, uint32 Index, const void *Resource, uint32 &ElidedCount)
+{
+    if (Index >= ShadowSlotCount) // Not tracked
+        return true;
+    const uint32 slotBit = 1u << Index;
+    if (Context.RedundantStateElimination && (Slots.ValidMask & slotBit) && Slots.Resources[Index] == Resource) {
+        ElidedCount++;
+        Context.Statistics.ElidedCommands++;
+        return false;
     }
+    Slots.Resources[Index] = Resource;
+    Slots.ValidMask |= slotBit;
+    return true;
+}
+
+CommandSegment* CommandBuffer::AcquireSegment()
+{
+    CommandSegment *segment = nullptr;
+    {
+        Mutex::ScopedLock scopedLock(mSegmentMutex);
+        if (mFreeSegments.count()) {
+            segment = mFreeSegments.PopBack();
+        }
+        else {
+            segment = new CommandSegment();
+            mSegments.Add(segment);
+        }
+    }
+    segment->reset(mRecording.RedundantStateElimination);
+    return segment;
+}
+
+void CommandBuffer::SubmitSegments(CommandSegment **Segments, uint32 Count)
+{
+    LEASSERT(sRecordingSegment == nullptr);
+    for (uint32 segmentIndex = 0; segmentIndex < Count; segmentIndex++) {
+        CommandSegment *segment = Segments[segmentIndex];
+        {
+            Mutex::ScopedLock scopedLock(mMutex);
+            const RecordingStatistics &segmentStatistics = segment->mRecording.Statistics;
+            mRecording.Statistics.RecordedCommands += segmentStatistics.RecordedCommands;
+            mRecording.Statistics.RecordedBytes += segmentStatistics.RecordedBytes;
+            mRecording.Statistics.ElidedCommands += segmentStatistics.ElidedCommands;
+            mRecording.Statistics.ElidedPipelineStates += segmentStatistics.ElidedPipelineStates;
+            mRecording.Statistics.ElidedVertexBuffers += segmentStatistics.ElidedVertexBuffers;
+            mRecording.Statistics.ElidedIndexBuffers += segmentStatistics.ElidedIndexBuffers;
+            mRecording.Statistics.ElidedConstantBuffers += segmentStatistics.ElidedConstantBuffers;
+            mRecording.Statistics.ElidedTextures += segmentStatistics.ElidedTextures;
+            mRecording.Statistics.ElidedSamplers += segmentStatistics.ElidedSamplers;
+        }
+        if (segment->IsEmpty())
+            releaseSegment(segment);
+        else
+            recordCommand<COMMAND_EXECUTESEGMENT>(segment);
+    }
+    // Segments changed bound state
+    resetShadowState();
+}
+
+void CommandBuffer::releaseSegment(CommandSegment *Segment)
+{
+    Mutex::ScopedLock scopedLock(mSegmentMutex);
+    mFreeSegments.Add(Segment);
+}
+
+CommandSegment::~CommandSegment()
+{
+    for (Chunk &chunk : mChunks)
+        free(chunk.Memory);
+}
+
+void CommandSegment::reset(bool RedundantStateElimination)
+{
+    // Chunks are kept for next recording
+    for (Chunk &chunk : mChunks)
+        chunk.Used = 0u;
+    mCommandCount = 0u;
+    mChunkIndex = 0u;
+    mRecording.Reset(RedundantStateElimination);
+}
+
+void* CommandSegment::allocateCommand(size_t Size)
+{
+    mCommandCount++;
+    mRecording.Statistics.RecordedCommands++;
+    mRecording.Statistics.RecordedBytes += static_cast<uint32>(Size);
+    for (; mChunkIndex < mChunks.count(); mChunkIndex++) {
+        Chunk &chunk = mChunks[mChunkIndex];
+        if (chunk.Used + Size <= chunk.Size) {
+            void *output = chunk.Memory + chunk.Used;
+            chunk.Used += Size;
+            return output;
+        }
+    }
+    const size_t chunkSize = MAX(Size, static_cast<size_t>(CommandBuffer::SegmentChunkSize));
+    Chunk &chunk = mChunks.Add();
+    chunk.Memory = static_cast<uint8*>(malloc(chunkSize));
+    chunk.Size = chunkSize;
+    chunk.Used = Size;
+    mChunkIndex = mChunks.count() - 1;
+    return chunk.Memory;
+}
+
+void CommandBuffer::MarkFrameEnd()
+{
+    Mutex::ScopedLock scopedLock(mMutex);
+    FrameMark &mark = mFrameMarks.Add();
+    mark.Page = mPushPage;
+    mark.Pointer = mPushCommandBufferPointer;
 }
 
-void CommandBuffer::Flush(RenderState *rs)
+bool CommandBuffer::FlushFrame(RenderState *rs)
 {
-    // Locked by drawmanager....
-    void  *flushCommandBufferPointer = mPushCommandBufferPointer;
-    mMutex.Unlock();
+    FrameMark mark;
+    {
+        Mutex::ScopedLock scopedLock(mMutex);
+        if (mFrameMarks.count() == 0)
+            return false;
+        mark = mFrameMarks.PopFront();
+    }
+    flushCommands(rs, mark.Page, mark.Pointer);
+    return true;
+}
 
-    uint32 cmdCount = 0u;
+void CommandBuffer::flushCommands(RenderState *rs, CommandPage *flushPage, uint8 *flushCommandBufferPointer)
+{
 	Texture *nullTexture = RenderContext::GetSingleton().GetDefaultTexture(RenderContext::DefaultTextureTypeWhite);
-    //gDebug.Print(">> Run command : %x to %x (%d)\n", (uintptr_t)mPullCommandBufferPointer, (uintptr_t)flushCommandBufferPointer, ((intptr_t)flushCommandBufferPointer - (intptr_t)mPullCommandBufferPointer) / sizeof(COMMAND));
-    while (flushCommandBufferPointer != mPullCommandBufferPointer)
+    while (flushPage != mPullPage || flushCommandBufferPointer != mPullCommandBufferPointer)
     {
-        COMMAND *currentCommand = static_cast<COMMAND*>(mPullCommandBufferPointer);
-        nextPullCommandBuffer();
+        if (mPullCommandBufferPointer == mPullPage->GetEnd()) { // Page is flushed, back to pool
+            Mutex::ScopedLock scopedLock(mMutex);
+            CommandPage *nextPage = mPullPage->Next;
+            releasePage(mPullPage);
+            mPullPage = nextPage;
+            mPullCommandBufferPointer = nextPage->GetMemory();
+            continue;
+        }
+        COMMAND_COMMON *currentCommand = reinterpret_cast<COMMAND_COMMON*>(mPullCommandBufferPointer);
+        mPullCommandBufferPointer += currentCommand->commandSize;
 
-        //gDebug.Print("Command[%03d] : %d\n", cmdCount++, currentCommand->commandType);
+        executeCommand(currentCommand, rs, nullTexture);
+    }
+}
 
-        switch (currentCommand->commandType)
-        {
-            case COMMAND::cBeginScene:
-            {
-                mImpl->BeginScene();
-                rs->SetSceneBegan(true);
-            } break;
-            case COMMAND::cEndScene:
-            {
-                mImpl->EndScene();
-                rs->SetSceneBegan(false);
-            } break;
-            case COMMAND::cBeginDrawing:
-            {
-                mImpl->PrepareForDrawingModel();
-                rs->SetModelDrawingBegan(true);
-            } break;
-            case COMMAND::cEndDrawing:
-            {
-                rs->SetModelDrawingBegan(false);
-            } break;
-            case COMMAND::cSetViewport:
-            {
-                COMMAND_SETVIEWPORT* command = reinterpret_cast<COMMAND_SETVIEWPORT*>(currentCommand);
-                mImpl->SetViewport(command->vprect);
-            } break;
-            case COMMAND::cSetScissorRect:
-            {
-                COMMAND_SETSCISSORRECT* command = reinterpret_cast<COMMAND_SETSCISSORRECT*>(currentCommand);
-                mImpl->SetScissorRect(command->screct);
-            } break;
-            case COMMAND::cClearScreen:
-            {
-                COMMAND_CLEARSCREEN *command = reinterpret_cast<COMMAND_CLEARSCREEN*>(currentCommand);
-                LEMath::FloatColorRGBA color = command->color;
-                mImpl->ClearScreen(color);
-            } break;
-            case COMMAND::cBindVertexBuffer:
-            {
-                COMMAND_BINDVERTEXBUFFER *command = reinterpret_cast<COMMAND_BINDVERTEXBUFFER*>(currentCommand);
-                mImpl->BindVertexBuffer(command->vertexbuffer);
-                if (command->vertexbuffer->SubReferenceCounter() == 0)
-                    ReservedRendererResources.Add(command->vertexbuffer);
-            } break;
-            case COMMAND::cBindIndexBuffer:
-            {
-                COMMAND_BINDINDEXBUFFER *command = reinterpret_cast<COMMAND_BINDINDEXBUFFER*>(currentCommand);
-                mImpl->BindIndexBuffer(command->indexbuffer);
-                if (command->indexbuffer->SubReferenceCounter() == 0)
-                    ReservedRendererResources.Add(command->indexbuffer);
-			} break;
-			case COMMAND::cDispatch:
-			{
-				COMMAND_DISPATCH *command = reinterpret_cast<COMMAND_DISPATCH*>(currentCommand);
-                mImpl->Dispatch(command->gridx, command->gridy, command->gridz);
-			} break;
-            case COMMAND::cDrawPrimitive:
-            {
-                COMMAND_DRAWPRIMITIVE *command = reinterpret_cast<COMMAND_DRAWPRIMITIVE*>(currentCommand);
-                if (mImpl->PrepareForDrawing())
-                    mImpl->DrawPrimitive(command->primitive, command->offset, command->count);
-                mImpl->ClearCaches();
-            } break;
-            case COMMAND::cDrawIndexedPrimitive:
-            {
-                COMMAND_DRAWINDEXEDPRIMITIVE *command = reinterpret_cast<COMMAND_DRAWINDEXEDPRIMITIVE*>(currentCommand);
-				if (mImpl->PrepareForDrawing())
-                    mImpl->DrawIndexedPrimitive(command->primitive, command->vtxcount, command->count);
-                mImpl->ClearCaches();
-            } break;
-            case COMMAND::cSetRenderTarget:
-            {
-                COMMAND_SETRENDERTARGET *command = reinterpret_cast<COMMAND_SETRENDERTARGET*>(currentCommand);
-                mImpl->SetRenderTarget(command->index, command->color, command->depthstencil, command->surfaceIndex);
-                if (command->color && command->color->SubReferenceCounter() == 0) {
-                    ReservedRendererResources.Add(command->color);
-                }
-                if (command->depthstencil && command->depthstencil->SubReferenceCounter() == 0) {
-                    ReservedRendererResources.Add(command->depthstencil);
-                }
-            } break;
-			case COMMAND::cBindTargetTexture:
-			{
-				COMMAND_BINDTARGETTEXTURE *command = reinterpret_cast<COMMAND_BINDTARGETTEXTURE*>(currentCommand);
-                mImpl->BindTargetTexture(command->index, command->texture);
-                if (command->texture->SubReferenceCounter() == 0)
-                    ReservedRendererResources.Add(command->texture);
-			} break;
-            case COMMAND::cBindSampler:
-            {
-                COMMAND_BINDSAMPLER *command = reinterpret_cast<COMMAND_BINDSAMPLER*>(currentCommand);
-                if (command->sampler) {
-                    mImpl->BindSampler(command->index, command->sampler);
-                    if (command->sampler->SubReferenceCounter() == 0)
-                        ReservedRendererResources.Add(command->sampler);
-                }
-            } break;
-            case COMMAND::cBindTexture:
-            {
-                COMMAND_BINDTEXTURE *command = reinterpret_cast<COMMAND_BINDTEXTURE*>(currentCommand);
-                if (command->texture) {
-                    mImpl->BindTexture(command->index, command->texture);
-                    if (command->texture->SubReferenceCounter() == 0)
-                        ReservedRendererResources.Add(command->texture);
-                } 
-                else
-                    mImpl->BindTexture(command->index, nullTexture);
-            } break;
-            case COMMAND::cBindPooledRenderTarget:
-            {
-                COMMAND_BINDPOOLEDRENDERTARGET *command = reinterpret_cast<COMMAND_BINDPOOLEDRENDERTARGET*>(currentCommand);
-                if (command->texture.Get()) {
-                    mImpl->BindTexture(command->index, command->texture.Get());
-                    command->texture.Release();
-                }
-            } break;
-            case COMMAND::cBindPooledDepthStencil:
-            {
-                COMMAND_BINDPOOLEDDEPTHSTENCIL *command = reinterpret_cast<COMMAND_BINDPOOLEDDEPTHSTENCIL*>(currentCommand);
-                if (command->texture.Get()) {
-                    mImpl->BindTexture(command->index, command->texture.Get());
-                    command->texture.Release();
-                }
-            } break;
-            case COMMAND::cSetPipelineState:
-            {
-                COMMAND_SETPIPELINESTATE* command = reinterpret_cast<COMMAND_SETPIPELINESTATE*>(currentCommand);
-                if (command->pipelinestate) {
-                    mImpl->SetPipelineState(command->pipelinestate);
-                    if (command->pipelinestate->SubReferenceCounter() == 0)
-                        ReservedRendererResources.Add(command->pipelinestate);
-                }
-            } break;
-            case COMMAND::cUpdateConstantBuffer:
-            {
-                COMMAND_UPDATECONSTANTBUFFER* command = reinterpret_cast<COMMAND_UPDATECONSTANTBUFFER*>(currentCommand);
-                if (command->buffer) {
-                    mImpl->UpdateConstantBuffer(command->buffer, command->data, command->size);
-                    if (command->buffer->SubReferenceCounter() == 0)
-                        ReservedRendererResources.Add(command->buffer);
-                }
-            } break;
-            case COMMAND::cSetConstantBuffer:
-            {
-                COMMAND_SETCONSTANTBUFFER* command = reinterpret_cast<COMMAND_SETCONSTANTBUFFER*>(currentCommand);
-                mImpl->SetConstantBuffer(command->index, command->buffer);
-                if (command->buffer->SubReferenceCounter() == 0)
-                    ReservedRendererResources.Add(command->buffer);
-            } break;
-            case COMMAND::cResourceBarrier:
-            {
-                COMMAND_RESOURCEBARRIER* command = reinterpret_cast<COMMAND_RESOURCEBARRIER*>(currentCommand);
-                void* resource = nullptr;
-                ResourceState beforeState = ResourceState::Common;
-                switch (command->type) {
-                case COMMAND_RESOURCEBARRIER::Type::Texture:
-                    resource = TextureRendererAccessor(command->texture).GetResource();
-                    beforeState = TextureRendererAccessor(command->texture).GetResourceState();
-                    break;
-                case COMMAND_RESOURCEBARRIER::Type::IndexBuffer:
-                    resource = IndexBufferRendererAccessor(command->indexBuffer).GetResource();
-                    beforeState = IndexBufferRendererAccessor(command->indexBuffer).GetResourceState();
-                    break;
-                case COMMAND_RESOURCEBARRIER::Type::VertexBuffer:
-                    resource = VertexBufferRendererAccessor(command->vertexBuffer).GetResource();
-                    beforeState = VertexBufferRendererAccessor(command->vertexBuffer).GetResourceState();
-                    break;
-                }
-                if (resource && beforeState != command->state)
-                    mImpl->ResourceBarrier(resource, beforeState, command->state);
-                switch (command->type) {
-                case COMMAND_RESOURCEBARRIER::Type::Texture:
-                    TextureRendererAccessor(command->texture).SetResourceState(command->state);
-                    if (command->texture->SubReferenceCounter() == 0) {
-                        ReservedRendererResources.Add(command->texture);
-                    }
-                    break;
-                case COMMAND_RESOURCEBARRIER::Type::IndexBuffer:
-                    IndexBufferRendererAccessor(command->indexBuffer).SetResourceState(command->state);
-                    if (command->indexBuffer->SubReferenceCounter() == 0) {
-                        ReservedRendererResources.Add(command->indexBuffer);
-                    }
-                    break;
-                case COMMAND_RESOURCEBARRIER::Type::VertexBuffer:
-                    VertexBufferRendererAccessor(command->vertexBuffer).SetResourceState(command->state);
-                    if (command->vertexBuffer->SubReferenceCounter() == 0) {
-                        ReservedRendererResources.Add(command->vertexBuffer);
-                    }
-                    break;
-                }
-            } break;
-            case COMMAND::cSetMarker:
-            {
-                COMMAND_SETMARKER *command = reinterpret_cast<COMMAND_SETMARKER*>(currentCommand);
-                if (command->MarkerName) {
-                    mImpl->SetMarker(command->MarkerName);
-                }
-            } break;
-            case COMMAND::cBeginEvent:
-            {
-                COMMAND_BEGINEVENT *command = reinterpret_cast<COMMAND_BEGINEVENT*>(currentCommand);
-                if (command->EventName) {
-                    mImpl->BeginEvent(command->EventName);
-                }
-            } break;
-            case COMMAND::cEndEvent:
-            {
-                mImpl->EndEvent();
-            } break;
-            case COMMAND::cPresent:
-            {
-                LE_DrawManagerRendererAccessor.Finalize(this);
-                LE_DrawManagerRendererAccessor.Present();
-                mImpl->ProcessAfterPresent();
-            } break;
-            default:
-                DEBUG_MESSAGE("[DrawManager] Unknown Command : %d\n", currentCommand->commandType);
-                break;
+struct CommandBuffer::CommandExecutor
+{
+    typedef void (*Function)(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture);
+    static const Function Table[COMMAND_COMMON::CommandNum];
+
+    static void BeginScene(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        Buffer.mImpl->BeginScene();
+        rs->SetSceneBegan(true);
+    }
+    static void EndScene(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        Buffer.mImpl->EndScene();
+        rs->SetSceneBegan(false);
+    }
+    static void Present(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        LE_DrawManagerRendererAccessor.Finalize(&Buffer);
+        LE_DrawManagerRendererAccessor.Present();
+        Buffer.mImpl->ProcessAfterPresent();
+    }
+    static void BeginDrawing(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        Buffer.mImpl->PrepareForDrawingModel();
+        rs->SetModelDrawingBegan(true);
+    }
+    static void EndDrawing(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        rs->SetModelDrawingBegan(false);
+    }
+    static void SetViewport(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_SETVIEWPORT* command = static_cast<COMMAND_SETVIEWPORT*>(Command);
+        Buffer.mImpl->SetViewport(command->vprect);
+    }
+    static void SetScissorRect(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_SETSCISSORRECT* command = static_cast<COMMAND_SETSCISSORRECT*>(Command);
+        Buffer.mImpl->SetScissorRect(command->screct);
+    }
+    static void ClearScreen(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_CLEARSCREEN *command = static_cast<COMMAND_CLEARSCREEN*>(Command);
+        LEMath::FloatColorRGBA color = command->color;
+        Buffer.mImpl->ClearScreen(color);
+    }
+    static void BindSampler(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_BINDSAMPLER *command = static_cast<COMMAND_BINDSAMPLER*>(Command);
+        if (command->sampler) {
+            Buffer.mImpl->BindSampler(command->index, command->sampler);
+            if (command->sampler->SubReferenceCounter() == 0)
+                Buffer.ReservedRendererResources.Add(command->sampler);
+        }
+    }
+    static void BindTexture(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_BINDTEXTURE *command = static_cast<COMMAND_BINDTEXTURE*>(Command);
+        if (command->texture) {
+            Buffer.mImpl->BindTexture(command->index, command->texture);
+            if (command->texture->SubReferenceCounter() == 0)
+                Buffer.ReservedRendererResources.Add(command->texture);
+        }
+        else
+            Buffer.mImpl->BindTexture(command->index, nullTexture);
+    }
+    static void BindTargetTexture(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_BINDTARGETTEXTURE *command = static_cast<COMMAND_BINDTARGETTEXTURE*>(Command);
+        Buffer.mImpl->BindTargetTexture(command->index, command->texture);
+        if (command->texture->SubReferenceCounter() == 0)
+            Buffer.ReservedRendererResources.Add(command->texture);
+    }
+    static void BindPooledRenderTarget(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_BINDPOOLEDRENDERTARGET *command = static_cast<COMMAND_BINDPOOLEDRENDERTARGET*>(Command);
+        if (command->texture.Get()) {
+            Buffer.mImpl->BindTexture(command->index, command->texture.Get());
+            command->texture.Release();
+        }
+    }
+    static void BindPooledDepthStencil(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_BINDPOOLEDDEPTHSTENCIL *command = static_cast<COMMAND_BINDPOOLEDDEPTHSTENCIL*>(Command);
+        if (command->texture.Get()) {
+            Buffer.mImpl->BindTexture(command->index, command->texture.Get());
+            command->texture.Release();
+        }
+    }
+    static void BindVertexBuffer(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_BINDVERTEXBUFFER *command = static_cast<COMMAND_BINDVERTEXBUFFER*>(Command);
+        Buffer.mImpl->BindVertexBuffer(command->vertexbuffer);
+        if (command->vertexbuffer->SubReferenceCounter() == 0)
+            Buffer.ReservedRendererResources.Add(command->vertexbuffer);
+    }
+    static void BindIndexBuffer(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_BINDINDEXBUFFER *command = static_cast<COMMAND_BINDINDEXBUFFER*>(Command);
+        Buffer.mImpl->BindIndexBuffer(command->indexbuffer);
+        if (command->indexbuffer->SubReferenceCounter() == 0)
+            Buffer.ReservedRendererResources.Add(command->indexbuffer);
+    }
+    static void Dispatch(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_DISPATCH *command = static_cast<COMMAND_DISPATCH*>(Command);
+        Buffer.mImpl->Dispatch(command->gridx, command->gridy, command->gridz);
+    }
+    static void DrawPrimitive(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_DRAWPRIMITIVE *command = static_cast<COMMAND_DRAWPRIMITIVE*>(Command);
+        if (Buffer.mImpl->PrepareForDrawing())
+            Buffer.mImpl->DrawPrimitive(command->primitive, command->offset, command->count);
+    }
+    static void DrawIndexedPrimitive(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_DRAWINDEXEDPRIMITIVE *command = static_cast<COMMAND_DRAWINDEXEDPRIMITIVE*>(Command);
+        if (Buffer.mImpl->PrepareForDrawing())
+            Buffer.mImpl->DrawIndexedPrimitive(command->primitive, command->vtxcount, command->count);
+    }
+    static void DrawIndexedInstanced(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_DRAWINDEXEDINSTANCED *command = static_cast<COMMAND_DRAWINDEXEDINSTANCED*>(Command);
+        if (Buffer.mImpl->PrepareForDrawing())
+            Buffer.mImpl->DrawIndexedInstanced(command->primitive, command->count, command->instancecount, getCommandData(command), command->instancestride);
+    }
+    static void SetPipelineState(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_SETPIPELINESTATE* command = static_cast<COMMAND_SETPIPELINESTATE*>(Command);
+        if (command->pipelinestate) {
+            Buffer.mImpl->SetPipelineState(command->pipelinestate);
+            if (command->pipelinestate->SubReferenceCounter() == 0)
+                Buffer.ReservedRendererResources.Add(command->pipelinestate);
+        }
+    }
+    static void UpdateConstantBuffer(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_UPDATECONSTANTBUFFER* command = static_cast<COMMAND_UPDATECONSTANTBUFFER*>(Command);
+        if (command->buffer) {
+            Buffer.mImpl->UpdateConstantBuffer(command->buffer, getCommandData(command), command->size);
+            if (command->buffer->SubReferenceCounter() == 0)
+                Buffer.ReservedRendererResources.Add(command->buffer);
         }
     }
+    static void SetConstantBuffer(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_SETCONSTANTBUFFER* command = static_cast<COMMAND_SETCONSTANTBUFFER*>(Command);
+        Buffer.mImpl->SetConstantBuffer(command->index, command->buffer);
+        if (command->buffer->SubReferenceCounter() == 0)
+            Buffer.ReservedRendererResources.Add(command->buffer);
+    }
+    static void SetRenderTarget(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_SETRENDERTARGET *command = static_cast<COMMAND_SETRENDERTARGET*>(Command);
+        Buffer.mImpl->SetRenderTarget(command->index, command->color, command->depthstencil, command->surfaceIndex);
+        if (command->color && command->color->SubReferenceCounter() == 0) {
+            Buffer.ReservedRendererResources.Add(command->color);
+        }
+        if (command->depthstencil && command->depthstencil->SubReferenceCounter() == 0) {
+            Buffer.ReservedRendererResources.Add(command->depthstencil);
+        }
+    }
+    static void ResourceBarrier(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_RESOURCEBARRIER* command = static_cast<COMMAND_RESOURCEBARRIER*>(Command);
+        void* resource = nullptr;
+        ResourceState beforeState = ResourceState::Common;
+        switch (command->type) {
+        case COMMAND_RESOURCEBARRIER::Type::Texture:
+            resource = TextureRendererAccessor(command->texture).GetResource();
+            beforeState = TextureRendererAccessor(command->texture).GetResourceState();
+            break;
+        case COMMAND_RESOURCEBARRIER::Type::IndexBuffer:
+            resource = IndexBufferRendererAccessor(command->indexBuffer).GetResource();
+            beforeState = IndexBufferRendererAccessor(command->indexBuffer).GetResourceState();
+            break;
+        case COMMAND_RESOURCEBARRIER::Type::VertexBuffer:
+            resource = VertexBufferRendererAccessor(command->vertexBuffer).GetResource();
+            beforeState = VertexBufferRendererAccessor(command->vertexBuffer).GetResourceState();
+            break;
+        }
+        if (resource && beforeState != command->state)
+            Buffer.mImpl->ResourceBarrier(resource, beforeState, command->state);
+        switch (command->type) {
+        case COMMAND_RESOURCEBARRIER::Type::Texture:
+            TextureRendererAccessor(command->texture).SetResourceState(command->state);
+            if (command->texture->SubReferenceCounter() == 0) {
+                Buffer.ReservedRendererResources.Add(command->texture);
+            }
+            break;
+        case COMMAND_RESOURCEBARRIER::Type::IndexBuffer:
+            IndexBufferRendererAccessor(command->indexBuffer).SetResourceState(command->state);
+            if (command->indexBuffer->SubReferenceCounter() == 0) {
+                Buffer.ReservedRendererResources.Add(command->indexBuffer);
+            }
+            break;
+        case COMMAND_RESOURCEBARRIER::Type::VertexBuffer:
+            VertexBufferRendererAccessor(command->vertexBuffer).SetResourceState(command->state);
+            if (command->vertexBuffer->SubReferenceCounter() == 0) {
+                Buffer.ReservedRendererResources.Add(command->vertexBuffer);
+            }
+            break;
+        }
+    }
+    static void SetMarker(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_SETMARKER *command = static_cast<COMMAND_SETMARKER*>(Command);
+        Buffer.mImpl->SetMarker(static_cast<const char*>(getCommandData(command)));
+    }
+    static void BeginEvent(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        COMMAND_BEGINEVENT *command = static_cast<COMMAND_BEGINEVENT*>(Command);
+        Buffer.mImpl->BeginEvent(static_cast<const char*>(getCommandData(command)));
+    }
+    static void EndEvent(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        Buffer.mImpl->EndEvent();
+    }
+    static void ExecuteSegment(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        CommandSegment *segment = static_cast<COMMAND_EXECUTESEGMENT*>(Command)->segment;
+        for (const CommandSegment::Chunk &chunk : segment->mChunks) {
+            for (size_t offset = 0u; offset < chunk.Used;) {
+                COMMAND_COMMON *chunkCommand = reinterpret_cast<COMMAND_COMMON*>(chunk.Memory + offset);
+                offset += chunkCommand->commandSize;
+                Buffer.executeCommand(chunkCommand, rs, nullTexture);
+            }
+        }
+        Buffer.releaseSegment(segment);
+    }
+    static void NextPage(CommandBuffer &Buffer, COMMAND_COMMON *Command, RenderState *rs, Texture *nullTexture)
+    {
+        // Only moves pull pointer to end of page by its size
+    }
+};
+
+// In order of COMMAND_COMMON::Commands
+const CommandBuffer::CommandExecutor::Function CommandBuffer::CommandExecutor::Table[COMMAND_COMMON::CommandNum] = {
+    &CommandExecutor::BeginScene,
+    &CommandExecutor::EndScene,
+    &CommandExecutor::Present,
+    &CommandExecutor::BeginDrawing,
+    &CommandExecutor::EndDrawing,
+    &CommandExecutor::SetViewport,
+    &CommandExecutor::SetScissorRect,
+    &CommandExecutor::ClearScreen,
+    &CommandExecutor::BindSampler,
+    &CommandExecutor::BindTexture,
+    &CommandExecutor::BindTargetTexture,
+    &CommandExecutor::BindPooledRenderTarget,
+    &CommandExecutor::BindPooledDepthStencil,
+    &CommandExecutor::BindVertexBuffer,
+    &CommandExecutor::BindIndexBuffer,
+    &CommandExecutor::Dispatch,
+    &CommandExecutor::DrawPrimitive,
+    &CommandExecutor::DrawIndexedPrimitive,
+    &CommandExecutor::DrawIndexedInstanced,
+    &CommandExecutor::SetPipelineState,
+    &CommandExecutor::UpdateConstantBuffer,
+    &CommandExecutor::SetConstantBuffer,
+    &CommandExecutor::SetRenderTarget,
+    &CommandExecutor::ResourceBarrier,
+    &CommandExecutor::SetMarker,
+    &CommandExecutor::BeginEvent,
+    &CommandExecutor::EndEvent,
+    &CommandExecutor::ExecuteSegment,
+    &CommandExecutor::NextPage,
+};
+
+void CommandBuffer::executeCommand(COMMAND_COMMON *cmd, RenderState *rs, Texture *nullTexture)
+{
+    LEASSERT(cmd->commandType < COMMAND_COMMON::CommandNum && cmd->commandSize > 0u);
+    CommandExecutor::Table[cmd->commandType](*this, cmd, rs, nullTexture);
 }
 
 // =============================================
 // Command interface in DrawManager
-#define COMMANDBUFFER_NEW new(LE_DrawManagerRendererAccessor.GetCommandBuffer()->popPushCommandBuffer())
+#define COMMANDBUFFER_RECORD LE_DrawManagerRendererAccessor.GetCommandBuffer()->recordCommand
+#define COMMANDBUFFER_RECORD_WITH_DATA LE_DrawManagerRendererAccessor.GetCommandBuffer()->recordCommandWithData
+// Binds are recorded only if they change state bound by commands recorded before
+#define COMMANDBUFFER_SHADOW(Bind) if (LE_DrawManagerRendererAccessor.GetCommandBuffer()->Bind)
 
 void DrawCommand::ClearScreen(const LEMath::FloatColorRGBA &color)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_CLEARSCREEN(color);
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_CLEARSCREEN>(color);
 }
 
 void DrawCommand::BeginScene()
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_BEGINSCENE();
+    LE_DrawManagerRendererAccessor.GetCommandBuffer()->resetShadowState();
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_BEGINSCENE>();
 }
 
 void DrawCommand::EndScene()
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_ENDSCENE();
+    LE_DrawManagerRendererAccessor.GetCommandBuffer()->resetShadowState();
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_ENDSCENE>();
 }
 
 void DrawCommand::BeginDrawing()
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_BEGINDRAWING();
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_BEGINDRAWING>();
 }
 
 void DrawCommand::EndDrawing()
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_ENDDRAWING();
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_ENDDRAWING>();
 }
 
 void DrawCommand::SetViewport(const LEMath::IntRect& rect)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_SETVIEWPORT(rect);
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_SETVIEWPORT>(rect);
 }
 
 void DrawCommand::SetScissorRect(const LEMath::IntRect& rect)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_SETSCISSORRECT(rect);
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_SETSCISSORRECT>(rect);
 }
 
 void DrawCommand::BindVertexBuffer(VertexBufferGeneric *VertexBuffer)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_BINDVERTEXBUFFER(VertexBuffer);
+    COMMANDBUFFER_SHADOW(shadowVertexBuffer(VertexBuffer))
+        COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_BINDVERTEXBUFFER>(VertexBuffer);
 }
 
 void DrawCommand::BindIndexBuffer(IndexBuffer *InIndexBuffer)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_BINDINDEXBUFFER(InIndexBuffer);
+    COMMANDBUFFER_SHADOW(shadowIndexBuffer(InIndexBuffer))
+        COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_BINDINDEXBUFFER>(InIndexBuffer);
 }
 
 void DrawCommand::Dispatch(int x, int y, int z)
 {
-	COMMANDBUFFER_NEW CommandBuffer::COMMAND_DISPATCH(x, y, z);
+	COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_DISPATCH>(x, y, z);
 }
 
 void DrawCommand::DrawPrimitive(RendererFlag::PrimitiveTypes type, uint32 offset, uint32 count)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_DRAWPRIMITIVE(type, offset, count);
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_DRAWPRIMITIVE>(type, offset, count);
 }
 
 void DrawCommand::DrawIndexedPrimitive(RendererFlag::PrimitiveTypes type, uint32 vtxcount, uint32 count)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_DRAWINDEXEDPRIMITIVE(type, vtxcount, count);
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_DRAWINDEXEDPRIMITIVE>(type, vtxcount, count);
+}
+
+void DrawCommand::DrawIndexedInstanced(RendererFlag::PrimitiveTypes type, uint32 count, uint32 instancecount, const void *instancedata, uint32 instancestride)
+{
+    LEASSERT(instancecount > 0u && instancedata);
+    COMMANDBUFFER_RECORD_WITH_DATA<CommandBuffer::COMMAND_DRAWINDEXEDINSTANCED>(instancedata, static_cast<size_t>(instancecount) * instancestride, type, count, instancecount, instancestride);
 }
 
 void DrawCommand::SetPipelineState(PipelineState *pso)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_SETPIPELINESTATE(pso);
+    COMMANDBUFFER_SHADOW(shadowPipelineState(pso))
+        COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_SETPIPELINESTATE>(pso);
 }
 
 void DrawCommand::UpdateConstantBuffer(ConstantBuffer* buffer, void* data, size_t size)
 {
-    CommandBuffer::COMMAND_UPDATECONSTANTBUFFER* currentCommand = COMMANDBUFFER_NEW CommandBuffer::COMMAND_UPDATECONSTANTBUFFER(buffer, LE_DrawManagerRendererAccessor.GetCommandBuffer()->duplicateBuffer(data, size), size);
-    currentCommand->nextOffset = LE_DrawManagerRendererAccessor.GetCommandBuffer()->CalculateCommandOffset((CommandBuffer::COMMAND*)currentCommand);
+    COMMANDBUFFER_RECORD_WITH_DATA<CommandBuffer::COMMAND_UPDATECONSTANTBUFFER>(data, size, buffer, static_cast<uint32>(size));
 }
 
 void DrawCommand::SetConstantBuffer(uint32 idx, ConstantBuffer* buffer)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_SETCONSTANTBUFFER(idx, buffer);
+    COMMANDBUFFER_SHADOW(shadowConstantBuffer(idx, buffer))
+        COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_SETCONSTANTBUFFER>(idx, buffer);
 }
 
 void DrawCommand::SetRenderTarget(uint32 index, TextureInterface* color, TextureInterface* depth, uint32 surfaceIndex)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_SETRENDERTARGET(index, color, depth, surfaceIndex);
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_SETRENDERTARGET>(index, color, depth, surfaceIndex);
 }
 
 void DrawCommand::ResourceBarrier(TextureInterface *InTexture, const ResourceState &InResourceState)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_RESOURCEBARRIER(InTexture, InResourceState);
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_RESOURCEBARRIER>(InTexture, InResourceState);
 }
 
 void DrawCommand::ResourceBarrier(IndexBuffer* InIndexBuffer, const ResourceState& InResourceState)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_RESOURCEBARRIER(InIndexBuffer, InResourceState);
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_RESOURCEBARRIER>(InIndexBuffer, InResourceState);
 }
 
 void DrawCommand::ResourceBarrier(VertexBufferGeneric* InVertexBuffer, const ResourceState& InResourceState)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_RESOURCEBARRIER(InVertexBuffer, InResourceState);
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_RESOURCEBARRIER>(InVertexBuffer, InResourceState);
 }
 
 void DrawCommand::BindTargetTexture(uint32 index, Texture *texture)
 {
-	COMMANDBUFFER_NEW CommandBuffer::COMMAND_BINDTARGETTEXTURE(index, texture);
+	COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_BINDTARGETTEXTURE>(index, texture);
 }
 
 void DrawCommand::BindSampler(uint32 index, SamplerState *sampler)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_BINDSAMPLER(index, sampler);
+    COMMANDBUFFER_SHADOW(shadowSampler(index, sampler))
+        COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_BINDSAMPLER>(index, sampler);
 }
 
 void DrawCommand::BindTexture(uint32 index, Texture *texture)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_BINDTEXTURE(index, texture);
+    COMMANDBUFFER_SHADOW(shadowTexture(index, texture))
+        COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_BINDTEXTURE>(index, texture);
 }
 
 void DrawCommand::BindTexture(uint32 index, const PooledRenderTarget &texture)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_BINDPOOLEDRENDERTARGET(index, texture);
+    LE_DrawManagerRendererAccessor.GetCommandBuffer()->invalidateShadowTexture(index);
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_BINDPOOLEDRENDERTARGET>(index, texture);
 }
 
 void DrawCommand::BindTexture(uint32 index, const PooledDepthStencil &texture)
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_BINDPOOLEDDEPTHSTENCIL(index, texture);
+    LE_DrawManagerRendererAccessor.GetCommandBuffer()->invalidateShadowTexture(index);
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_BINDPOOLEDDEPTHSTENCIL>(index, texture);
 }
 
 void DrawCommand::SetMarker(const char *InMarkerName)
 {
-    CommandBuffer::COMMAND_SETMARKER *currentCommand = COMMANDBUFFER_NEW CommandBuffer::COMMAND_SETMARKER(LE_DrawManagerRendererAccessor.GetCommandBuffer()->duplicateString(InMarkerName));
-    currentCommand->nextOffset = LE_DrawManagerRendererAccessor.GetCommandBuffer()->CalculateCommandOffset((CommandBuffer::COMMAND*)currentCommand);
+    COMMANDBUFFER_RECORD_WITH_DATA<CommandBuffer::COMMAND_SETMARKER>(InMarkerName, strlen(InMarkerName) + 1);
 }
 
 void DrawCommand::BeginEvent(const char *InEventName)
 {
-    CommandBuffer::COMMAND_BEGINEVENT *currentCommand = COMMANDBUFFER_NEW CommandBuffer::COMMAND_BEGINEVENT(LE_DrawManagerRendererAccessor.GetCommandBuffer()->duplicateString(InEventName));
-    currentCommand->nextOffset = LE_DrawManagerRendererAccessor.GetCommandBuffer()->CalculateCommandOffset((CommandBuffer::COMMAND*)currentCommand);
+    COMMANDBUFFER_RECORD_WITH_DATA<CommandBuffer::COMMAND_BEGINEVENT>(InEventName, strlen(InEventName) + 1);
 }
 
 void DrawCommand::EndEvent()
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_ENDEVENT();
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_ENDEVENT>();
+}
+
+CommandSegment* DrawCommand::AcquireSegment()
+{
+    return LE_DrawManagerRendererAccessor.GetCommandBuffer()->AcquireSegment();
+}
+
+void DrawCommand::SubmitSegments(CommandSegment **Segments, uint32 Count)
+{
+    LE_DrawManagerRendererAccessor.GetCommandBuffer()->SubmitSegments(Segments, Count);
 }
 
 void DrawCommand::Present()
 {
-    COMMANDBUFFER_NEW CommandBuffer::COMMAND_PRESENT();
+    // Next frame is recorded to new command list
+    CommandBuffer *commandBuffer = LE_DrawManagerRendererAccessor.GetCommandBuffer();
+    commandBuffer->resetShadowState();
+    COMMANDBUFFER_RECORD<CommandBuffer::COMMAND_PRESENT>();
+    commandBuffer->closeFrameMemoryStatistics();
 }
 }
\ No newline at end of file
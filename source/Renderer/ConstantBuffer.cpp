@@ -30,6 +30,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #if defined(USE_DX12)
 #include "../Platform/DirectX12/ConstantBufferImpl_DirectX12.inl"
+#elif defined(USE_NULL)
+#include "../Platform/Null/ConstantBufferImpl_Null.inl"
 #else
 #error No implementation of constant buffer
 #endif
@@ -59,6 +61,8 @@ ConstantBuffer::ConstantBuffer()
 {
 #if defined(USE_DX12)
     mImpl = new ConstantBufferImpl_DirectX12();
+#elif defined(USE_NULL)
+    mImpl = new ConstantBufferImpl_Null();
 #else
 #error No implementation of ConstantBuffer for this platform!
 #endif
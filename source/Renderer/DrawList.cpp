@@ -0,0 +1,261 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  DrawList.cpp
+@brief Draws of a render pass sorted by state (pipeline state, material, vertex buffer, depth)
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#include "Renderer/DrawList.h"
+
+#include <string.h>
+
+#include "Managers/TaskManager.h"
+#include "Renderer/CommandBuffer.h"
+#include "Renderer/DrawCommand.h"
+#include "Renderer/IndexBuffer.h"
+#include "Renderer/Material.h"
+#include "Renderer/PipelineState.h"
+#include "Renderer/RenderState.h"
+#include "Renderer/VertexBuffer.h"
+
+namespace LimitEngine {
+static constexpr uint32 StateBits = DrawList::PipelineStateBits + DrawList::MaterialBits + DrawList::VertexBufferBits;
+static constexpr uint32 PassShift = 64u - DrawList::PassBits;
+
+// Instances of a draw are packed here by recording thread and copied to command buffer
+alignas(16) static thread_local InstanceVertex sInstanceVertices[DrawList::MaxInstancesPerDraw];
+
+static inline uint64 MaskBits(uint32 Value, uint32 Bits)
+{
+    return static_cast<uint64>(Value) & ((1ull << Bits) - 1ull);
+}
+
+// Order of positive floats is same as order of their bits, so upper bits of float are used as quantized depth
+static inline uint32 QuantizeDepth(float Depth)
+{
+    if (!(Depth > 0.0f))        // Negative (behind of camera) or NaN
+        return 0u;
+    uint32 bits;
+    ::memcpy(&bits, &Depth, sizeof(bits));
+    return bits >> (32u - DrawList::DepthBits);
+}
+
+DrawList::DrawList()
+    : mItems()
+    , mDraws()
+    , mInstances()
+    , mStatistics()
+    , mSegments()
+    , mRangeStatistics()
+{}
+
+void DrawList::Clear()
+{
+    mItems.Clear(false);
+    mDraws.Clear(false);
+    mInstances.Clear(false);
+}
+
+uint32 DrawList::AddInstance(const LEMath::FloatMatrix4x4 &World, const LEMath::FloatMatrix4x4 &WorldViewProj)
+{
+    Instance &instance = mInstances.Add();
+    instance.World = World;
+    instance.WorldViewProj = WorldViewProj;
+    return mInstances.count() - 1u;
+}
+
+void DrawList::AddDraw(uint32 Instance, RenderPass Pass, float ViewDepth, PipelineState *InPipelineState, Material *InMaterial,
+                       VertexBufferGeneric *InVertexBuffer, IndexBuffer *InIndexBuffer, uint32 VertexCount, uint32 IndexCount,
+                       PipelineState *InInstancedPipelineState)
+{
+    LEASSERT(Instance < mInstances.count());
+    LEASSERT(InPipelineState);
+
+    Item &item = mItems.Add();
+    item.SortKey = MakeSortKey(Pass,
+                               InPipelineState->GetSortID(),
+                               InMaterial ? InMaterial->GetSortID() : 0u,
+                               InVertexBuffer ? InVertexBuffer->GetSortID() : 0u,
+                               ViewDepth);
+    item.Draw = mDraws.count();
+    item.Reserved = 0u;
+
+    Draw &draw = mDraws.Add();
+    draw.Instance = Instance;
+    draw.VertexCount = VertexCount;
+    draw.IndexCount = IndexCount;
+    draw.PSO = InPipelineState;
+    // Order of translucent draws is by depth, so instances of them are not drawn together
+    draw.InstancedPSO = (Pass == RenderPass::TranslucencyPass) ? nullptr : InInstancedPipelineState;
+    draw.DrawMaterial = InMaterial;
+    draw.Vertices = InVertexBuffer;
+    draw.Indices = InIndexBuffer;
+}
+
+uint64 DrawList::MakeSortKey(RenderPass Pass, uint32 PipelineStateID, uint32 MaterialID, uint32 VertexBufferID, float ViewDepth)
+{
+    // IDs are truncated, draws with same truncated ID only lose grouping (states are compared on Submit)
+    const uint64 passKey = MaskBits(static_cast<uint32>(Pass), PassBits) << PassShift;
+    const uint64 stateKey = (MaskBits(PipelineStateID, PipelineStateBits) << (MaterialBits + VertexBufferBits))
+                          | (MaskBits(MaterialID, MaterialBits) << VertexBufferBits)
+                          | MaskBits(VertexBufferID, VertexBufferBits);
+    const uint32 depth = QuantizeDepth(ViewDepth);
+    if (Pass == RenderPass::TranslucencyPass) {
+        // Blending needs far ones first, states only order draws at same depth
+        return passKey | (MaskBits(~depth, DepthBits) << StateBits) | stateKey;
+    }
+    return passKey | (stateKey << DepthBits) | MaskBits(depth, DepthBits);
+}
+
+void DrawList::Sort()
+{
+    LE_TaskManager.ParallelRadixSort(mItems, [](const Item &InItem) { return InItem.SortKey; });
+}
+
+void DrawList::Submit(const RenderState &rs)
+{
+    if (mItems.count() == 0u)
+        return;
+
+    DrawCommand::BeginDrawing();
+    const uint32 rangeCount = MIN(mItems.count() / ParallelSubmitMinDraws, LE_TaskManager.GetWorkerCount() + 1u);
+    if (rangeCount <= 1u) {
+        submitRange(rs, 0u, mItems.count(), mStatistics);
+    }
+    else {
+        // Ranges are recorded to their own segments, so commands are in the order of keys after submitting segments
+        const uint32 rangeSize = (mItems.count() + rangeCount - 1u) / rangeCount;
+        mSegments.Resize(rangeCount);
+        mRangeStatistics.Resize(rangeCount);
+        for (uint32 rangeIndex = 0; rangeIndex < rangeCount; rangeIndex++) {
+            mSegments[rangeIndex] = DrawCommand::AcquireSegment();
+            mRangeStatistics[rangeIndex] = Statistics();
+        }
+        LE_TaskManager.ParallelFor(rangeCount, [&](uint32 stepBegin, uint32 stepEnd) {
+            for (uint32 rangeIndex = stepBegin; rangeIndex <= stepEnd; rangeIndex++) {
+                CommandSegment::ScopedRecording recording(mSegments[rangeIndex]);
+                const uint32 rangeBegin = rangeIndex * rangeSize;
+                submitRange(rs, rangeBegin, MIN(rangeBegin + rangeSize, mItems.count()), mRangeStatistics[rangeIndex]);
+            }
+        });
+        DrawCommand::SubmitSegments(mSegments.GetData(), rangeCount);
+        for (const Statistics &rangeStatistics : mRangeStatistics) {
+            mStatistics.DrawCount += rangeStatistics.DrawCount;
+            mStatistics.InstancedDrawCount += rangeStatistics.InstancedDrawCount;
+            mStatistics.InstanceCount += rangeStatistics.InstanceCount;
+            mStatistics.PipelineStateChanges += rangeStatistics.PipelineStateChanges;
+            mStatistics.MaterialChanges += rangeStatistics.MaterialChanges;
+            mStatistics.VertexBufferChanges += rangeStatistics.VertexBufferChanges;
+            mStatistics.IndexBufferChanges += rangeStatistics.IndexBufferChanges;
+        }
+    }
+    DrawCommand::EndDrawing();
+}
+
+uint32 DrawList::findInstancedBatchEnd(uint32 Begin, uint32 End) const
+{
+    const Draw &first = mDraws[mItems[Begin].Draw];
+    if (first.InstancedPSO == nullptr)
+        return Begin + 1u;
+    const uint32 batchLimit = (End - Begin > MaxInstancesPerDraw) ? Begin + MaxInstancesPerDraw : End;
+    uint32 itemIndex = Begin + 1u;
+    for (; itemIndex < batchLimit; itemIndex++) {
+        // Draws of same drawgroup are next to each other after sort (same states), IDs in key may collide so states are compared
+        const Draw &draw = mDraws[mItems[itemIndex].Draw];
+        if (draw.InstancedPSO != first.InstancedPSO || draw.DrawMaterial != first.DrawMaterial ||
+            draw.Vertices != first.Vertices || draw.Indices != first.Indices || draw.IndexCount != first.IndexCount)
+            break;
+    }
+    return itemIndex;
+}
+
+void DrawList::submitRange(const RenderState &rs, uint32 Begin, uint32 End, Statistics &OutStatistics) const
+{
+    RenderState instanceRenderState(rs);
+    uint32 currentInstance = InvalidIndex;
+    PipelineState *currentPipelineState = nullptr;
+    Material *currentMaterial = nullptr;
+    VertexBufferGeneric *currentVertexBuffer = nullptr;
+    IndexBuffer *currentIndexBuffer = nullptr;
+    for (uint32 itemIndex = Begin; itemIndex < End;) {
+        const Draw &draw = mDraws[mItems[itemIndex].Draw];
+        const uint32 batchEnd = findInstancedBatchEnd(itemIndex, End);
+        const uint32 instanceCount = batchEnd - itemIndex;
+        const bool instanced = instanceCount >= MinInstancesPerDraw;
+        PipelineState *pipelineState = instanced ? draw.InstancedPSO : draw.PSO;
+        if (instanced) {
+            // Matrices of instances are in vertex slot 1, constants have only ones of pass
+            for (uint32 batchIndex = 0; batchIndex < instanceCount; batchIndex++)
+                sInstanceVertices[batchIndex].World = mInstances[mDraws[mItems[itemIndex + batchIndex].Draw].Instance].World;
+            if (draw.DrawMaterial)
+                draw.DrawMaterial->UpdateConstantBuffers(rs, true);
+        }
+        else {
+            if (draw.Instance != currentInstance) {
+                const Instance &instance = mInstances[draw.Instance];
+                instanceRenderState.SetWorldMatrix(instance.World);
+                instanceRenderState.SetWorldViewProjMatrix(instance.WorldViewProj);
+                currentInstance = draw.Instance;
+            }
+            // Matrices are per instance, so constants are updated for every draw
+            if (draw.DrawMaterial)
+                draw.DrawMaterial->UpdateConstantBuffers(instanceRenderState);
+        }
+
+        if (pipelineState != currentPipelineState) {
+            DrawCommand::SetPipelineState(pipelineState);
+            currentPipelineState = pipelineState;
+            OutStatistics.PipelineStateChanges++;
+        }
+        if (draw.DrawMaterial != currentMaterial || itemIndex == Begin) {
+            currentMaterial = draw.DrawMaterial;
+            OutStatistics.MaterialChanges++;
+        }
+        // Bindings of material that are already bound are elided by command buffer
+        if (draw.DrawMaterial)
+            draw.DrawMaterial->Bind(rs, instanced);
+        if (draw.Vertices != currentVertexBuffer) {
+            DrawCommand::BindVertexBuffer(draw.Vertices);
+            currentVertexBuffer = draw.Vertices;
+            OutStatistics.VertexBufferChanges++;
+        }
+        if (draw.Indices != currentIndexBuffer) {
+            DrawCommand::BindIndexBuffer(draw.Indices);
+            currentIndexBuffer = draw.Indices;
+            OutStatistics.IndexBufferChanges++;
+        }
+        if (instanced) {
+            DrawCommand::DrawIndexedInstanced(RendererFlag::PrimitiveTypes::TRIANGLELIST, draw.IndexCount, instanceCount,
+                                              sInstanceVertices, static_cast<uint32>(sizeof(InstanceVertex)));
+            OutStatistics.InstancedDrawCount++;
+            OutStatistics.InstanceCount += instanceCount;
+            itemIndex = batchEnd;
+        }
+        else {
+            DrawCommand::DrawIndexedPrimitive(RendererFlag::PrimitiveTypes::TRIANGLELIST, draw.VertexCount, draw.IndexCount);
+            itemIndex++;
+        }
+        OutStatistics.DrawCount++;
+    }
+}
+} // namespace LimitEngine
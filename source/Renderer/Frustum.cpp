@@ -0,0 +1,112 @@
+/***********************************************************
+ LIMITEngine Source File
+ Copyright (C), LIMITGAME, 2020
+ -----------------------------------------------------------
+ @file  Frustum.cpp
+ @brief Frustum Class (plane extraction, box culling)
+ @author minseob (https://github.com/rasidin)
+ ***********************************************************/
+
+#include "Renderer/Frustum.h"
+
+#include <math.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define FRUSTUM_CULLING_SSE 1
+#include <emmintrin.h>
+#else
+#define FRUSTUM_CULLING_SSE 0
+#endif
+
+namespace LimitEngine {
+    void Frustum::UpdatePlanes(const LEMath::FloatMatrix4x4 &ViewProj)
+    {
+        // Row vectors (clip = v * ViewProj), so planes are made of columns (Gribb/Hartmann)
+        const float *m = reinterpret_cast<const float*>(&ViewProj);
+        const float sign[PlaneCount]   = { 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f };
+        const int   column[PlaneCount] = { 0, 0, 1, 1, 2, 2 };
+        for (int planeIndex = 0; planeIndex < PlaneCount; planeIndex++) {
+            float plane[4];
+            for (int row = 0; row < 4; row++) {
+                plane[row] = m[row * 4 + 3] + sign[planeIndex] * m[row * 4 + column[planeIndex]];
+            }
+#if defined(USE_DX9) || defined(USE_DX11) // Depth is 0 <= z (same as GetProjectionMatrix)
+            if (planeIndex == Near) {
+                for (int row = 0; row < 4; row++) {
+                    plane[row] = m[row * 4 + 2];
+                }
+            }
+#endif
+            const float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            const float rcpLength = (length > 0.0f) ? 1.0f / length : 0.0f;
+            mPlaneX[planeIndex] = plane[0] * rcpLength;
+            mPlaneY[planeIndex] = plane[1] * rcpLength;
+            mPlaneZ[planeIndex] = plane[2] * rcpLength;
+            mPlaneW[planeIndex] = plane[3] * rcpLength;
+        }
+    }
+
+    bool Frustum::IsBoxVisible(const AABB &Box) const
+    {
+        BoxBatch batch;
+        batch.Set(0, Box);
+        for (int planeIndex = 0; planeIndex < PlaneCount; planeIndex++) {
+            const float distance = mPlaneX[planeIndex] * batch.CenterX[0] + mPlaneY[planeIndex] * batch.CenterY[0] + mPlaneZ[planeIndex] * batch.CenterZ[0] + mPlaneW[planeIndex];
+            const float radius = fabsf(mPlaneX[planeIndex]) * batch.ExtentX[0] + fabsf(mPlaneY[planeIndex]) * batch.ExtentY[0] + fabsf(mPlaneZ[planeIndex]) * batch.ExtentZ[0];
+            if (distance + radius < 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+    void Frustum::CullBoxes(const BoxBatch *Batches, uint32 BatchCount, uint8 *OutMasks) const
+    {
+        // Box is outside if it is behind any plane : dot(n, center) + w < -dot(|n|, extent)
+#if FRUSTUM_CULLING_SSE
+        __m128 planeX[PlaneCount], planeY[PlaneCount], planeZ[PlaneCount], planeW[PlaneCount];
+        __m128 absPlaneX[PlaneCount], absPlaneY[PlaneCount], absPlaneZ[PlaneCount];
+        for (int planeIndex = 0; planeIndex < PlaneCount; planeIndex++) {
+            planeX[planeIndex] = _mm_set1_ps(mPlaneX[planeIndex]);
+            planeY[planeIndex] = _mm_set1_ps(mPlaneY[planeIndex]);
+            planeZ[planeIndex] = _mm_set1_ps(mPlaneZ[planeIndex]);
+            planeW[planeIndex] = _mm_set1_ps(mPlaneW[planeIndex]);
+            absPlaneX[planeIndex] = _mm_set1_ps(fabsf(mPlaneX[planeIndex]));
+            absPlaneY[planeIndex] = _mm_set1_ps(fabsf(mPlaneY[planeIndex]));
+            absPlaneZ[planeIndex] = _mm_set1_ps(fabsf(mPlaneZ[planeIndex]));
+        }
+        for (uint32 batchIndex = 0; batchIndex < BatchCount; batchIndex++) {
+            const BoxBatch &batch = Batches[batchIndex];
+            const __m128 centerX = _mm_loadu_ps(batch.CenterX);
+            const __m128 centerY = _mm_loadu_ps(batch.CenterY);
+            const __m128 centerZ = _mm_loadu_ps(batch.CenterZ);
+            const __m128 extentX = _mm_loadu_ps(batch.ExtentX);
+            const __m128 extentY = _mm_loadu_ps(batch.ExtentY);
+            const __m128 extentZ = _mm_loadu_ps(batch.ExtentZ);
+            __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int planeIndex = 0; planeIndex < PlaneCount; planeIndex++) {
+                const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[planeIndex], centerX), _mm_mul_ps(planeY[planeIndex], centerY)),
+                                                   _mm_add_ps(_mm_mul_ps(planeZ[planeIndex], centerZ), planeW[planeIndex]));
+                const __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absPlaneX[planeIndex], extentX), _mm_mul_ps(absPlaneY[planeIndex], extentY)),
+                                                 _mm_mul_ps(absPlaneZ[planeIndex], extentZ));
+                visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+            }
+            OutMasks[batchIndex] = static_cast<uint8>(_mm_movemask_ps(visible));
+        }
+#else
+        for (uint32 batchIndex = 0; batchIndex < BatchCount; batchIndex++) {
+            const BoxBatch &batch = Batches[batchIndex];
+            uint8 mask = 0u;
+            for (uint32 lane = 0; lane < 4; lane++) {
+                bool visible = true;
+                for (int planeIndex = 0; planeIndex < PlaneCount && visible; planeIndex++) {
+                    const float distance = mPlaneX[planeIndex] * batch.CenterX[lane] + mPlaneY[planeIndex] * batch.CenterY[lane] + mPlaneZ[planeIndex] * batch.CenterZ[lane] + mPlaneW[planeIndex];
+                    const float radius = fabsf(mPlaneX[planeIndex]) * batch.ExtentX[lane] + fabsf(mPlaneY[planeIndex]) * batch.ExtentY[lane] + fabsf(mPlaneZ[planeIndex]) * batch.ExtentZ[lane];
+                    visible = distance + radius >= 0.0f;
+                }
+                mask |= visible ? (1u << lane) : 0u;
+            }
+            OutMasks[batchIndex] = mask;
+        }
+#endif
+    }
+}
@@ -19,6 +19,8 @@
 #include "../Platform/DirectX11/IndexBufferImpl_DirectX11.inl"
 #elif defined(USE_DX12)
 #include "../Platform/DirectX12/IndexBufferImpl_DirectX12.inl"
+#elif defined(USE_NULL)
+#include "../Platform/Null/IndexBufferImpl_Null.inl"
 #else
 #error No implementation for this platform
 #endif
@@ -55,6 +57,8 @@ IndexBuffer::IndexBuffer()
     mImpl = new IndexBufferImpl_DirectX11();
 #elif defined(USE_DX12)
     mImpl = new IndexBufferImpl_DirectX12(this);
+#elif defined(USE_NULL)
+    mImpl = new IndexBufferImpl_Null(this);
 #else
 #error No implementation for this platform
 #endif        
@@ -40,8 +40,25 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "Shaders/Standard_prepass.ps.h"
 #include "Shaders/Standard_basepass.vs.h"
 #include "Shaders/Standard_basepass.ps.h"
+#include "Shaders/Standard_prepass_instanced.vs.h"
+#include "Shaders/Standard_basepass_instanced.vs.h"
 
 namespace LimitEngine {
+    // Draws of a material can be recorded by several threads (DrawList), so constants of render state
+    // are written to copy of update buffer owned by this thread
+    static constexpr size_t UpdateBufferCopySize = 4096u;
+    alignas(16) static thread_local uint8 sUpdateBufferCopy[UpdateBufferCopySize];
+    static void UpdateConstantBufferFromRenderState(const RenderState &rs, ConstantBuffer *Buffer, void *UpdateBuffer, const RenderState::ShaderDriverForRenderState &Driver)
+    {
+        const size_t size = Buffer->GetSize();
+        void *updateBufferCopy = (size <= UpdateBufferCopySize) ? sUpdateBufferCopy : MemoryAllocator::Alloc(size);
+        ::memcpy(updateBufferCopy, UpdateBuffer, size);
+        rs.SetToShaderDriver(Driver.Relocate(UpdateBuffer, updateBufferCopy));
+        DrawCommand::UpdateConstantBuffer(Buffer, updateBufferCopy, size);
+        if (updateBufferCopy != sUpdateBufferCopy)
+            MemoryAllocator::Free(updateBufferCopy);
+    }
+
     class RendererTask_MaterialSetupShaderParameters : public RendererTask
     {
     public:
@@ -59,6 +76,8 @@ namespace LimitEngine {
 
     template<> Archive& Archive::operator << (Material &InMaterial) {
         *this << InMaterial.mId;
+        if (IsLoading())
+            InMaterial.mStringID = StringID(InMaterial.mId);
         *this << InMaterial.mName;
         String shaderName;
         //if (InMaterial.mVertexShader[0].IsValid()) {
@@ -78,18 +97,24 @@ namespace LimitEngine {
             for (uint32 RenderPassIndex = 0; RenderPassIndex < (uint32)RenderPass::NumOfRenderPass; RenderPassIndex++) {
                 InMaterial.mVertexShader[RenderPassIndex] = LE_ShaderManager.GetShader(shaderName + "_" + RenderPassNames[RenderPassIndex] + "_VS");
                 InMaterial.mPixelShader[RenderPassIndex] = LE_ShaderManager.GetShader(shaderName + "_" + RenderPassNames[RenderPassIndex] + "_PS");
+                InMaterial.mInstancedVertexShader[RenderPassIndex] = LE_ShaderManager.GetShader(shaderName + "_" + RenderPassNames[RenderPassIndex] + "_instanced_VS");
             }
         }
         return *this;
     }
 
+    std::atomic<uint32> Material::sSortIDCounter(0u);
+
     Material::Material()
         : mId()
+        , mStringID()
+        , mSortID(sSortIDCounter.fetch_add(1u, std::memory_order_relaxed))
         , mName()
     {
         ::memset(mIsEnabledRenderPass, 0, sizeof(mIsEnabledRenderPass));
         ::memset(mVSConstantUpdateBuffer, 0, sizeof(mVSConstantUpdateBuffer));
         ::memset(mPSConstantUpdateBuffer, 0, sizeof(mPSConstantUpdateBuffer));
+        ::memset(mInstancedVSConstantUpdateBuffer, 0, sizeof(mInstancedVSConstantUpdateBuffer));
         mIsEnabledRenderPass[(uint32)RenderPass::PrePass] = true;
         mIsEnabledRenderPass[(uint32)RenderPass::BasePass] = true;
     }
@@ -104,6 +129,8 @@ namespace LimitEngine {
             mPixelShader[Index] = nullptr;
             mVSConstantBuffer[Index] = nullptr;
             mPSConstantBuffer[Index] = nullptr;
+            mInstancedVertexShader[Index] = nullptr;
+            mInstancedVSConstantBuffer[Index] = nullptr;
             if (mVSConstantUpdateBuffer[Index]) {
                 MemoryAllocator::Free(mVSConstantUpdateBuffer[Index]);
                 mVSConstantUpdateBuffer[Index] = nullptr;
@@ -112,6 +139,10 @@ namespace LimitEngine {
                 MemoryAllocator::Free(mPSConstantUpdateBuffer[Index]);
                 mPSConstantUpdateBuffer[Index] = nullptr;
             }
+            if (mInstancedVSConstantUpdateBuffer[Index]) {
+                MemoryAllocator::Free(mInstancedVSConstantUpdateBuffer[Index]);
+                mInstancedVSConstantUpdateBuffer[Index] = nullptr;
+            }
         }
     }
     Material* Material::Load(TextParser::NODE *root)
@@ -120,6 +151,7 @@ namespace LimitEngine {
         for (uint32 Index = 0; Index < (uint32)RenderPass::NumOfRenderPass; Index++) {
             mVertexShader[Index] = nullptr;
             mPixelShader[Index] = nullptr;
+            mInstancedVertexShader[Index] = nullptr;
         }
 
         //bool CompiledShaders = false;
@@ -127,18 +159,19 @@ namespace LimitEngine {
 		bool SucceedCompilingPS = false;
 		for (uint32 chidx = 0; chidx < root->children.size(); chidx++) {
             const TextParser::NODE *node = root->children[chidx];
-            if (node->name == "ID") {
-                mId = node->values[0];
+            if (node->nameID == LE_STRINGID("ID")) {
+                SetID(node->values[0]);
             }
-            else if (node->name == "NAME") {
+            else if (node->nameID == LE_STRINGID("NAME")) {
                 mName = node->values[0];
             }
-            else if (node->name == "SHADER") {
+            else if (node->nameID == LE_STRINGID("SHADER")) {
                 String shaderName = node->values[0];
                 for (uint32 Index = 0; Index < (uint32)RenderPass::NumOfRenderPass; Index++) {
                     if (ShaderManager::IsUsable()) {
                         mVertexShader[Index] = LE_ShaderManager.GetShader(shaderName + "_" + RenderPassNames[Index] + "_VS");
                         mPixelShader[Index] = LE_ShaderManager.GetShader(shaderName + "_" + RenderPassNames[Index] + "_PS");
+                        mInstancedVertexShader[Index] = LE_ShaderManager.GetShader(shaderName + "_" + RenderPassNames[Index] + "_instanced_VS");
                     }
                 }
             }
@@ -181,10 +214,11 @@ namespace LimitEngine {
         for (uint32 Index = 0; Index < (uint32)RenderPass::NumOfRenderPass; Index++) {
             mVertexShader[Index] = nullptr;
             mPixelShader[Index] = nullptr;
+            mInstancedVertexShader[Index] = nullptr;
         }
 
         if (rapidxml::xml_node<const char> *IDNode = XMLNode->first_node("ID")) {
-            mId = IDNode->value();
+            SetID(IDNode->value());
         }
         if (rapidxml::xml_node<const char> *ShaderNode = XMLNode->first_node("SHADER")) {
             String shaderName(ShaderNode->value());
@@ -193,6 +227,7 @@ namespace LimitEngine {
                 if (ShaderManager::IsUsable()) {
                     mVertexShader[Index] = LE_ShaderManager.GetShader(shaderName + "_" + RenderPassNames[Index] + "_VS");
                     mPixelShader[Index] = LE_ShaderManager.GetShader(shaderName + "_" + RenderPassNames[Index] + "_PS");
+                    mInstancedVertexShader[Index] = LE_ShaderManager.GetShader(shaderName + "_" + RenderPassNames[Index] + "_instanced_VS");
                 }
             }
         }
@@ -203,6 +238,10 @@ namespace LimitEngine {
     {
         return mIsEnabledRenderPass[(uint32)InRenderPass] && mPixelShader[(uint32)InRenderPass].IsValid();
     }
+    bool Material::IsInstancingSupported(const RenderPass& InRenderPass) const
+    {
+        return mInstancedVertexShader[(uint32)InRenderPass].IsValid() && mVertexShader[(uint32)InRenderPass].IsValid();
+    }
     void Material::setupShaderParameters()
     {
         for (int rpidx = 0; rpidx < static_cast<int>(RenderPass::NumOfRenderPass); rpidx++) {
@@ -224,6 +263,21 @@ namespace LimitEngine {
                     mVSShaderDriver[rpidx].Setup(*(Standard_basepass_VS::ConstantBuffer0*)mVSConstantUpdateBuffer[rpidx]);
                 }
             }
+            // Textures and samplers of instanced vertex shader are same as vertex shader of pass
+            if (mInstancedVertexShader[rpidx].IsValid()) {
+                if (mInstancedVertexShader[rpidx]->GetShaderHash() == Standard_prepass_instanced_VS::GetHash()) {
+                    mInstancedVSConstantBuffer[rpidx] = new ConstantBuffer();
+                    mInstancedVSConstantBuffer[rpidx]->Create(sizeof(Standard_prepass_instanced_VS::ConstantBuffer0), nullptr);
+                    mInstancedVSConstantUpdateBuffer[rpidx] = MemoryAllocator::Alloc(sizeof(Standard_prepass_instanced_VS::ConstantBuffer0));
+                    mInstancedVSShaderDriver[rpidx].Setup(*(Standard_prepass_instanced_VS::ConstantBuffer0*)mInstancedVSConstantUpdateBuffer[rpidx]);
+                }
+                else if (mInstancedVertexShader[rpidx]->GetShaderHash() == Standard_basepass_instanced_VS::GetHash()) {
+                    mInstancedVSConstantBuffer[rpidx] = new ConstantBuffer();
+                    mInstancedVSConstantBuffer[rpidx]->Create(sizeof(Standard_basepass_instanced_VS::ConstantBuffer0), nullptr);
+                    mInstancedVSConstantUpdateBuffer[rpidx] = MemoryAllocator::Alloc(sizeof(Standard_basepass_instanced_VS::ConstantBuffer0));
+                    mInstancedVSShaderDriver[rpidx].Setup(*(Standard_basepass_instanced_VS::ConstantBuffer0*)mInstancedVSConstantUpdateBuffer[rpidx]);
+                }
+            }
             if (mPixelShader[rpidx].IsValid()) {
                 if (mPixelShader[rpidx]->GetBoundTextureCount())
                     mPSTexturePosition[rpidx].Setup(mPixelShader[rpidx]->GetBoundTextureNames(), mPixelShader[rpidx]->GetBoundTextureCount());
@@ -246,24 +300,37 @@ namespace LimitEngine {
         }
     }
     void Material::ReadyToRender(const RenderState& rs, PipelineStateDescriptor& desc)
+    {
+        SetupPipelineStateDescriptor(rs.GetRenderPass(), desc);
+        UpdateConstantBuffers(rs);
+    }
+    void Material::SetupPipelineStateDescriptor(const RenderPass &InRenderPass, PipelineStateDescriptor &desc, bool Instanced) const
+    {
+        uint32 renderPass = (uint32)InRenderPass;
+        const ShaderRefPtr &vertexShader = Instanced ? mInstancedVertexShader[renderPass] : mVertexShader[renderPass];
+        if (vertexShader.IsValid() && mPixelShader[renderPass].IsValid()) {
+            desc.Shaders[static_cast<int>(Shader::Type::Vertex)] = vertexShader.Get();
+            desc.Shaders[static_cast<int>(Shader::Type::Pixel)] = mPixelShader[renderPass].Get();
+        }
+    }
+    void Material::UpdateConstantBuffers(const RenderState &rs, bool Instanced)
     {
         uint32 renderPass = (uint32)rs.GetRenderPass();
         if (mVertexShader[renderPass].IsValid() && mPixelShader[renderPass].IsValid()) {
-            desc.Shaders[static_cast<int>(Shader::Type::Vertex)] = mVertexShader[renderPass].Get();
-            desc.Shaders[static_cast<int>(Shader::Type::Pixel)] = mPixelShader[renderPass].Get();
-
-            uint32 cbidx = 0u;
-            if (mVSConstantBuffer[renderPass].IsValid()) {
-                rs.SetToShaderDriver(mVSShaderDriver[renderPass]);
-                DrawCommand::UpdateConstantBuffer(mVSConstantBuffer[renderPass].Get(), mVSConstantUpdateBuffer[renderPass], mVSConstantBuffer[renderPass]->GetSize());
+            if (Instanced) {
+                if (mInstancedVSConstantBuffer[renderPass].IsValid()) {
+                    UpdateConstantBufferFromRenderState(rs, mInstancedVSConstantBuffer[renderPass].Get(), mInstancedVSConstantUpdateBuffer[renderPass], mInstancedVSShaderDriver[renderPass]);
+                }
+            }
+            else if (mVSConstantBuffer[renderPass].IsValid()) {
+                UpdateConstantBufferFromRenderState(rs, mVSConstantBuffer[renderPass].Get(), mVSConstantUpdateBuffer[renderPass], mVSShaderDriver[renderPass]);
             }
             if (mPSConstantBuffer[renderPass].IsValid()) {
-                rs.SetToShaderDriver(mPSShaderDriver[renderPass]);
-                DrawCommand::UpdateConstantBuffer(mPSConstantBuffer[renderPass].Get(), mPSConstantUpdateBuffer[renderPass], mPSConstantBuffer[renderPass]->GetSize());
+                UpdateConstantBufferFromRenderState(rs, mPSConstantBuffer[renderPass].Get(), mPSConstantUpdateBuffer[renderPass], mPSShaderDriver[renderPass]);
             }
         }
     }
-    void Material::Bind(const RenderState &rs)
+    void Material::Bind(const RenderState &rs, bool Instanced)
     {
         uint32 renderPass = (uint32)rs.GetRenderPass();
         uint32 cbidx = 0u;
@@ -271,8 +338,9 @@ namespace LimitEngine {
         rs.SetSamplers(mVSSamplerPosition[renderPass]);
         rs.SetTextures(mPSTexturePosition[renderPass]);
         rs.SetSamplers(mPSSamplerPosition[renderPass]);
-        if (mVSConstantBuffer[renderPass].IsValid()) {
-            DrawCommand::SetConstantBuffer(cbidx++, mVSConstantBuffer[renderPass].Get());
+        const ConstantBufferRefPtr &vsConstantBuffer = Instanced ? mInstancedVSConstantBuffer[renderPass] : mVSConstantBuffer[renderPass];
+        if (vsConstantBuffer.IsValid()) {
+            DrawCommand::SetConstantBuffer(cbidx++, vsConstantBuffer.Get());
         }
         if (mPSConstantBuffer[renderPass].IsValid()) {
             DrawCommand::SetConstantBuffer(cbidx++, mPSConstantBuffer[renderPass].Get());
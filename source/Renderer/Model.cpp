@@ -38,7 +38,9 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "Managers/ShaderManager.h"
 //#include "Managers/LightManager.h"
 #include "Managers/DrawManager.h"
+#include "Renderer/DrawList.h"
 #include "Renderer/Material.h"
+#include "Renderer/PipelineStateCache.h"
 
 namespace LimitEngine {
     template<> Archive& Archive::operator << (Model::DRAWGROUP &InDrawGroup) {
@@ -79,9 +81,6 @@ namespace LimitEngine {
     {
         indexBuffer = new IndexBuffer();
         indexBuffer->Create(indices.count() * 3, &indices[0]);
-        for (int psidx = 0; psidx < static_cast<int>(RenderPass::NumOfRenderPass); psidx++) {
-            pipelinestates[psidx] = new PipelineState();
-        }
     }
 
     void Model::_MESH::InitResource()
@@ -143,8 +142,9 @@ namespace LimitEngine {
         for (uint32 Index = 0; Index < mMeshes.count(); Index++) {
             mMeshes[Index]->InitResource();
             for (uint32 DGIdx = 0; DGIdx < mMeshes[Index]->drawgroups.count(); DGIdx++) {
+                const StringID materialID(mMeshes[Index]->drawgroups[DGIdx]->materialID);
                 for (uint32 MatIdx=0;MatIdx< mMaterials.count();MatIdx++) {
-                    if (mMaterials[MatIdx]->GetID() == mMeshes[Index]->drawgroups[DGIdx]->materialID) {
+                    if (mMaterials[MatIdx]->GetStringID() == materialID) {
                         mMeshes[Index]->drawgroups[DGIdx]->material = mMaterials[MatIdx];
                         break;
                     }
@@ -157,7 +157,7 @@ namespace LimitEngine {
     {
         if (!Parser.IsValid()) return nullptr;
         Model *output = new Model();
-        output->Load(Parser->GetNode("DATA"));
+        output->Load(Parser->GetNode(LE_STRINGID("DATA")));
         return output;
     }
     void Model::Load(const char *text)
@@ -165,18 +165,18 @@ namespace LimitEngine {
         TextParser parser;
         parser.Parse(text);
         TextParser::NODE *node = NULL;
-        if ((node = parser.GetNode("FILETYPE")) && node->values[0] == "MODEL")
+        if ((node = parser.GetNode(LE_STRINGID("FILETYPE"))) && node->values[0] == "MODEL")
         {
-            TextParser::NODE *nodemName = parser.GetNode("NAME");
+            TextParser::NODE *nodemName = parser.GetNode(LE_STRINGID("NAME"));
             if (nodemName) mName = nodemName->values[0].GetCharPtr();
-            Load(parser.GetNode("DATA"));
+            Load(parser.GetNode(LE_STRINGID("DATA")));
         }
     }
     Model* Model::Load(TextParser::NODE *root)
     {
         if (!root) return nullptr;
         TextParser::NODE *node = NULL;
-        if ((node = root->FindChild("MATERIALS")))
+        if ((node = root->FindChild(LE_STRINGID("MATERIALS"))))
         {
             for (uint32 i=0;i<node->children.count();i++) {
                 Material *material = new Material();
@@ -184,80 +184,80 @@ namespace LimitEngine {
                 mMaterials.Add(material);
             }
         }
-        if ((node = root->FindChild("TRANSFORM")))
+        if ((node = root->FindChild(LE_STRINGID("TRANSFORM"))))
         {
             for (uint32 i=0;i<node->children.size();i++) {
                 TextParser::NODE *transNode = node->children[i];
                 if (transNode) {
-                    if (transNode->name == "POSITION") {
+                    if (transNode->nameID == LE_STRINGID("POSITION")) {
                         mBasePosition = transNode->ToFloatVector3();
                     }
-                    if (transNode->name == "SCALE") {
+                    if (transNode->nameID == LE_STRINGID("SCALE")) {
                         mBaseScale = transNode->ToFloatVector3();
                     }
-                    if (transNode->name == "ROTATION") {
+                    if (transNode->nameID == LE_STRINGID("ROTATION")) {
                         mBaseRotation = transNode->ToFloatVector3();
                     }
                 }
             }
             mBaseMatrix = LEMath::FloatMatrix4x4::GenerateTransform((LEMath::FloatVector4)mBasePosition) * LEMath::FloatMatrix4x4::GenerateRotationXYZ((LEMath::FloatVector4)mBaseRotation) * LEMath::FloatMatrix4x4::GenerateScaling((LEMath::FloatVector4)mBaseScale);
         }
-        if ((node = root->FindChild("ELEMENTS")))
+        if ((node = root->FindChild(LE_STRINGID("ELEMENTS"))))
         {
             for (uint32 j=0;j<node->children.count();j++) {
                 if (TextParser::NODE *eleNode = node->children[j]) {
-                    if (eleNode->name == "MESH") {
+                    if (eleNode->nameID == LE_STRINGID("MESH")) {
                         MESH *mesh = new MESH();
                         mMeshes.push_back(mesh);
                         TextParser::NODE *tn = NULL;
-                        if ((tn = eleNode->FindChild("TRANSFORM")))
+                        if ((tn = eleNode->FindChild(LE_STRINGID("TRANSFORM"))))
                         {
                             for (uint32 i=0;i<tn->children.size();i++) {
                                 TextParser::NODE *transNode = tn->children[i];
                                 if (transNode) {
-                                    if (transNode->name == "POSITION") {
+                                    if (transNode->nameID == LE_STRINGID("POSITION")) {
                                         mesh->pos = transNode->ToFloatVector3();
                                     }
-                                    if (transNode->name == "SCALE") {
+                                    if (transNode->nameID == LE_STRINGID("SCALE")) {
                                         mesh->scl = transNode->ToFloatVector3();
                                     }
-                                    if (transNode->name == "ROTATION") {
+                                    if (transNode->nameID == LE_STRINGID("ROTATION")) {
                                         mesh->rot = transNode->ToFloatVector3();
                                     }
                                 }
                             }
                             mesh->Preprocess();
                         }
-                        TextParser::NODE *verticesNode = eleNode->FindChild("VERTICES");
+                        TextParser::NODE *verticesNode = eleNode->FindChild(LE_STRINGID("VERTICES"));
                         if (verticesNode) { // Make vertices
                             mesh->vertexbuffer = new RigidVertexBuffer();
                             RigidVertexBuffer *vtxbuf = (VertexBuffer<FVF_PNCTTB, SIZE_PNCTTB>*)mesh->vertexbuffer.Get();
                             RigidVertex *vtxptr = new RigidVertex[verticesNode->children.count()]();
                             for (uint32 i=0;i<verticesNode->children.count();i++) {
                                 TextParser::NODE *vtxNode = verticesNode->children[i];
-                                TextParser::NODE *vtxPos = vtxNode->FindChild("POSITION");
+                                TextParser::NODE *vtxPos = vtxNode->FindChild(LE_STRINGID("POSITION"));
                                 if (vtxPos) {
                                     LEMath::FloatVector3 vPos(vtxPos->ToFloatVector3());
                                     vtxptr[i].SetPosition(vPos);
                                     mBoundingbox |= vPos;
                                 }
-                                TextParser::NODE *vtxNrm = vtxNode->FindChild("NORMAL");
+                                TextParser::NODE *vtxNrm = vtxNode->FindChild(LE_STRINGID("NORMAL"));
                                 if (vtxNrm) {
                                     vtxptr[i].SetNormal(vtxNrm->ToFloatVector3());
                                 }
-                                TextParser::NODE *vtxTan = vtxNode->FindChild("TANGENT");
+                                TextParser::NODE *vtxTan = vtxNode->FindChild(LE_STRINGID("TANGENT"));
                                 if (vtxTan) {
                                     vtxptr[i].SetTangent(vtxTan->ToFloatVector3());
                                 }
-                                TextParser::NODE *vtxBN = vtxNode->FindChild("BINORMAL");
+                                TextParser::NODE *vtxBN = vtxNode->FindChild(LE_STRINGID("BINORMAL"));
                                 if (vtxBN) {
                                     vtxptr[i].SetBinormal(vtxBN->ToFloatVector3());
                                 }
-                                TextParser::NODE *vtxUV = vtxNode->FindChild("TEXCOORD");
+                                TextParser::NODE *vtxUV = vtxNode->FindChild(LE_STRINGID("TEXCOORD"));
                                 if (vtxUV) {
                                     vtxptr[i].SetTexcoord(vtxUV->ToFloatVector2());
                                 }
-                                TextParser::NODE *vtxCol = vtxNode->FindChild("COLOR");
+                                TextParser::NODE *vtxCol = vtxNode->FindChild(LE_STRINGID("COLOR"));
                                 if (vtxCol) {
                                     vtxptr[i].SetColor(vtxCol->ToByteColorRGBA());
                                 }
@@ -265,16 +265,16 @@ namespace LimitEngine {
                             vtxbuf->Create(verticesNode->children.count(), vtxptr, 0);
                             delete[] vtxptr;
                         }
-                        TextParser::NODE *indicesNode = eleNode->FindChild("INDICES");
+                        TextParser::NODE *indicesNode = eleNode->FindChild(LE_STRINGID("INDICES"));
                         if (indicesNode) { // Make indices
                             for(uint32 i=0;i<indicesNode->children.count();i++) {
                                 TextParser::NODE *idxNode = indicesNode->children[i];
                                 DRAWGROUP *drawgroup = NULL;
-                                if (TextParser::NODE *materialNode = idxNode->FindChild("MATERIAL")) {
-                                    String matname = materialNode->values[0];
+                                if (TextParser::NODE *materialNode = idxNode->FindChild(LE_STRINGID("MATERIAL"))) {
+                                    const StringID matname(materialNode->values[0]);
                                     for(uint32 l=0;l<mesh->drawgroups.count();l++)
                                     {
-                                        if (mesh->drawgroups[l]->material->GetID() == matname)
+                                        if (mesh->drawgroups[l]->material->GetStringID() == matname)
                                         {
                                             drawgroup = mesh->drawgroups[l];
                                             break;
@@ -285,7 +285,7 @@ namespace LimitEngine {
                                         Material *material = NULL;
                                         for(uint32 l=0;l<mMaterials.count();l++)
                                         {
-                                            if (mMaterials[l]->GetID() == matname)
+                                            if (mMaterials[l]->GetStringID() == matname)
                                             {
                                                 material = mMaterials[l];
                                                 break;
@@ -299,7 +299,7 @@ namespace LimitEngine {
                                     }
                                 }
                                 if (!drawgroup) continue;
-                                if (TextParser::NODE *polygonNode = idxNode->FindChild("POLYGON")) {
+                                if (TextParser::NODE *polygonNode = idxNode->FindChild(LE_STRINGID("POLYGON"))) {
                                     drawgroup->indices.push_back(polygonNode->ToIntVector3());
                                 }
                             }
@@ -421,12 +421,12 @@ namespace LimitEngine {
                     DRAWGROUP *drawgroup = NULL;
                     for (rapidxml::xml_node<const char> *indexNode = indicesNode->first_node(); indexNode; indexNode = indexNode->next_sibling()) {
                         if (rapidxml::xml_node<const char>* materialNode = indexNode->first_node("material")) {
-                            const char *materialName = materialNode->value();
-                            if (!drawgroup || !drawgroup->material || drawgroup->material->GetID() != materialName) {
+                            const StringID materialName(materialNode->value(), materialNode->value_size());
+                            if (!drawgroup || !drawgroup->material || drawgroup->material->GetStringID() != materialName) {
                                 // Find drawgroup
                                 drawgroup = nullptr;
                                 for (uint32 l = 0; l < mesh->drawgroups.count(); l++) {
-                                    if (mesh->drawgroups[l]->material->GetID() == materialName) {
+                                    if (mesh->drawgroups[l]->material->GetStringID() == materialName) {
                                         drawgroup = mesh->drawgroups[l];
                                         break;
                                     }
@@ -436,7 +436,7 @@ namespace LimitEngine {
                                 Material *material = NULL;
                                 for (uint32 l = 0; l < mMaterials.count(); l++)
                                 {
-                                    if (mMaterials[l]->GetID() == materialName)
+                                    if (mMaterials[l]->GetStringID() == materialName)
                                     {
                                         material = mMaterials[l];
                                         break;
@@ -524,40 +524,26 @@ namespace LimitEngine {
         LEMath::FloatMatrix4x4 modelTransformMatrix = Transform * getTransformMatrix();
         LEMath::FloatMatrix4x4 modelWvpMat = modelTransformMatrix * LEMath::FloatMatrix4x4(rs.GetViewProjMatrix());
 
+        // RenderState for this model (same for all drawgroups)
+        RenderState rsCopied(rs);
+        rsCopied.SetWorldMatrix(/*mesh->worldMatrix * */modelTransformMatrix);
+        rsCopied.SetWorldViewProjMatrix(/*mesh->worldMatrix * */modelWvpMat);
+
         for (uint32 i=0;i<mMeshes.size();i++)
         {
             MESH *mesh = mMeshes[i];
             for(uint32 j=0;j<mesh->drawgroups.count();j++)
             {
                 DRAWGROUP *drawGroup = mesh->drawgroups[j];
-                const bool NeedToGeneratePipelineState = drawGroup->pipelinestates[static_cast<int>(rs.GetRenderPass())]->IsValid() == false;
-                PipelineStateDescriptor desc = rs.GetPipelineStateDescriptor();
-                // Set input
-                if (NeedToGeneratePipelineState) {
-                    mesh->vertexbuffer->GenerateInputElementDescriptors(desc);
-                }
-                // Set material
-                if (Material *material = drawGroup->material)
-                {
-                    if (!material->IsEnabledRenderPass(rs.GetRenderPass())) continue;
-
-                    // Set RenderState
-                    RenderState rsCopied(rs);
-                    rsCopied.SetWorldMatrix(/*mesh->worldMatrix * */modelTransformMatrix);
-                    rsCopied.SetWorldViewProjMatrix(/*mesh->worldMatrix * */modelWvpMat);
-                    //LE_LightManager.ApplyLight(rsCopied, NULL);
+                Material *material = drawGroup->material;
+                if (material && !material->IsEnabledRenderPass(rs.GetRenderPass())) continue;
 
-                    // Bind material
-                    material->ReadyToRender(rsCopied, desc);
-                }
-                // Setup pipeline state
-                if (NeedToGeneratePipelineState) {
-                    desc.Finalize();
-                    drawGroup->pipelinestates[static_cast<int>(rs.GetRenderPass())]->Init(desc);
-                }
+                PipelineState *pipelineState = preparePipelineState(rs, mesh, drawGroup);
+                // Bind material
+                if (material) material->UpdateConstantBuffers(rsCopied);
 
-                DrawCommand::SetPipelineState(drawGroup->pipelinestates[static_cast<int>(rs.GetRenderPass())].Get());
-                if (Material* material = drawGroup->material) material->Bind(rs);
+                DrawCommand::SetPipelineState(pipelineState);
+                if (material) material->Bind(rs);
 
                 // Draw
                 DrawCommand::BindVertexBuffer(mesh->vertexbuffer.Get());
@@ -569,15 +555,69 @@ namespace LimitEngine {
         }
         DrawCommand::EndDrawing();
     }
+    void Model::AddToDrawList(DrawList &List, const RenderState &rs, const LEMath::FloatMatrix4x4 &Transform, float ViewDepth)
+    {
+        const RenderPass renderPass = rs.GetRenderPass();
+        uint32 instanceIndex = DrawList::InvalidIndex;
+        for (uint32 meshIndex = 0; meshIndex < mMeshes.size(); meshIndex++)
+        {
+            MESH *mesh = mMeshes[meshIndex];
+            for (uint32 drawGroupIndex = 0; drawGroupIndex < mesh->drawgroups.count(); drawGroupIndex++)
+            {
+                DRAWGROUP *drawGroup = mesh->drawgroups[drawGroupIndex];
+                Material *material = drawGroup->material;
+                if (material && !material->IsEnabledRenderPass(renderPass)) continue;
+
+                // Matrices are added with first draw in this pass
+                if (instanceIndex == DrawList::InvalidIndex) {
+                    LEMath::FloatMatrix4x4 modelTransformMatrix = Transform * getTransformMatrix();
+                    LEMath::FloatMatrix4x4 modelWvpMat = modelTransformMatrix * LEMath::FloatMatrix4x4(rs.GetViewProjMatrix());
+                    instanceIndex = List.AddInstance(modelTransformMatrix, modelWvpMat);
+                }
+                // Instances of this model sharing drawgroup are drawn together if material has instanced shader
+                PipelineState *instancedPipelineState = (material && material->IsInstancingSupported(renderPass)) ? preparePipelineState(rs, mesh, drawGroup, true) : nullptr;
+                List.AddDraw(instanceIndex, renderPass, ViewDepth, preparePipelineState(rs, mesh, drawGroup), material,
+                             mesh->vertexbuffer.Get(), drawGroup->indexBuffer.Get(),
+                             static_cast<uint32>(((RigidVertexBuffer *)mesh->vertexbuffer.Get())->GetSize()),
+                             static_cast<uint32>(drawGroup->indexBuffer->GetSize()),
+                             instancedPipelineState);
+            }
+        }
+    }
+    PipelineState* Model::preparePipelineState(const RenderState &rs, MESH *Mesh, DRAWGROUP *DrawGroup, bool Instanced)
+    {
+        PipelineStateRefPtr &pipelineState = Instanced ? DrawGroup->instancedpipelinestates[static_cast<int>(rs.GetRenderPass())]
+                                                       : DrawGroup->pipelinestates[static_cast<int>(rs.GetRenderPass())];
+        if (pipelineState.IsValid() && pipelineState->IsValid())
+            return pipelineState.Get();
+
+        PipelineStateDescriptor desc = rs.GetPipelineStateDescriptor();
+        // Set input
+        Mesh->vertexbuffer->GenerateInputElementDescriptors(desc);
+        if (Instanced)
+            GenerateInstanceInputElementDescriptors(desc);
+        // Set material
+        if (Material *material = DrawGroup->material)
+            material->SetupPipelineStateDescriptor(rs.GetRenderPass(), desc, Instanced);
+        desc.Finalize();
+        pipelineState = PipelineStateCache::Get(desc);
+        return pipelineState.Get();
+    }
+    AABB Model::GetWorldBoundingBox(const LEMath::FloatMatrix4x4 &Transform)
+    {
+        if (mBoundingbox.IsValid() == false)
+            return mBoundingbox;
+        return mBoundingbox.TransformBounds(Transform * getTransformMatrix());
+    }
     bool Model::IsInBoundingBox(const LEMath::FloatVector3 &v)
     {
-        AABB transformedBB = mBoundingbox.Transform(getTransformMatrix());
+        AABB transformedBB = mBoundingbox.TransformBounds(getTransformMatrix());
         return transformedBB.IsIn(v);
     }
     fPolygon::INTERSECT_RESULT
     Model::Intersect(const fRay &ray)
     {
-        AABB transformedBB = mBoundingbox.Transform(getTransformMatrix());
+        AABB transformedBB = mBoundingbox.TransformBounds(getTransformMatrix());
         AABB::INTERSECT_RESULT result = transformedBB.Intersect(ray);
         if (result.key && result.value.X() > 0) {
             if (ray.GetLength() > result.value.X()) {
@@ -589,7 +629,7 @@ namespace LimitEngine {
     fPolygon::INTERSECT_RESULT 
     Model::IntersectSphere(const fRay &ray, float radius)
     {
-        AABB transformedBB = mBoundingbox.Transform(getTransformMatrix());
+        AABB transformedBB = mBoundingbox.TransformBounds(getTransformMatrix());
         AABB::INTERSECT_RESULT result = transformedBB.Intersect(ray);
         if (result.key && result.value.X() > 0) {
             LEMath::FloatVector3 normalBB = transformedBB.GetNormal(ray.org + ray.GetDirection() * result.value.x);
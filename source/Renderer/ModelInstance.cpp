@@ -19,4 +19,34 @@ namespace LimitEngine {
 
         mModel->Draw(rs, mTransform.ToMatrix4x4());
     }
+    void ModelInstance::AddToDrawList(DrawList &List, const RenderState &rs)
+    {
+        if (mModel.IsValid() == false)
+            return;
+
+        const LEMath::FloatMatrix4x4 transformMatrix = mTransform.ToMatrix4x4();
+        // Center of bounds (origin of instance while model has no bounds)
+        const AABB &worldBounds = GetWorldBoundingBox();
+        const float *transform = reinterpret_cast<const float*>(&transformMatrix);
+        float center[3] = { transform[12], transform[13], transform[14] };
+        if (worldBounds.IsValid()) {
+            center[0] = (worldBounds.minimum.X() + worldBounds.maximum.X()) * 0.5f;
+            center[1] = (worldBounds.minimum.Y() + worldBounds.maximum.Y()) * 0.5f;
+            center[2] = (worldBounds.minimum.Z() + worldBounds.maximum.Z()) * 0.5f;
+        }
+        // w of clip space is depth along view direction
+        const float *viewProj = reinterpret_cast<const float*>(&rs.GetViewProjMatrix());
+        const float viewDepth = center[0] * viewProj[3] + center[1] * viewProj[7] + center[2] * viewProj[11] + viewProj[15];
+
+        mModel->AddToDrawList(List, rs, transformMatrix, viewDepth);
+    }
+    const AABB& ModelInstance::GetWorldBoundingBox()
+    {
+        if (mWorldBoundingBoxUpdated == false && mModel.IsValid()) {
+            mWorldBoundingBox = mModel->GetWorldBoundingBox(mTransform.ToMatrix4x4());
+            // Keep trying until model has bounds (loading)
+            mWorldBoundingBoxUpdated = mWorldBoundingBox.IsValid();
+        }
+        return mWorldBoundingBox;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  NullBackend.cpp
+@brief Counters of null rendering backend
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#include "Renderer/NullBackend.h"
+
+namespace LimitEngine {
+std::atomic<uint64> NullBackend::sCounters[static_cast<uint32>(NullBackend::Counter::Num)];
+
+NullBackend::Statistics NullBackend::GetStatistics()
+{
+    Statistics statistics;
+    statistics.Commands = sCounters[static_cast<uint32>(Counter::Commands)].load(std::memory_order_relaxed);
+    statistics.DrawCalls = sCounters[static_cast<uint32>(Counter::DrawCalls)].load(std::memory_order_relaxed);
+    statistics.DrawnInstances = sCounters[static_cast<uint32>(Counter::DrawnInstances)].load(std::memory_order_relaxed);
+    statistics.Dispatches = sCounters[static_cast<uint32>(Counter::Dispatches)].load(std::memory_order_relaxed);
+    statistics.StateBinds = sCounters[static_cast<uint32>(Counter::StateBinds)].load(std::memory_order_relaxed);
+    statistics.StateChanges = sCounters[static_cast<uint32>(Counter::StateChanges)].load(std::memory_order_relaxed);
+    statistics.ConstantBufferUpdates = sCounters[static_cast<uint32>(Counter::ConstantBufferUpdates)].load(std::memory_order_relaxed);
+    statistics.UploadedBytes = sCounters[static_cast<uint32>(Counter::UploadedBytes)].load(std::memory_order_relaxed);
+    statistics.CreatedResources = sCounters[static_cast<uint32>(Counter::CreatedResources)].load(std::memory_order_relaxed);
+    statistics.ResourceBytes = sCounters[static_cast<uint32>(Counter::ResourceBytes)].load(std::memory_order_relaxed);
+    statistics.Presents = sCounters[static_cast<uint32>(Counter::Presents)].load(std::memory_order_relaxed);
+    return statistics;
+}
+void NullBackend::ResetStatistics()
+{
+    for (std::atomic<uint64> &counter : sCounters)
+        counter.store(0u, std::memory_order_relaxed);
+}
+} // namespace LimitEngine
@@ -29,20 +29,27 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #ifdef USE_DX12
 #include "../Platform/DirectX12/PipelineStateImpl_DirectX12.inl"
+#elif defined(USE_NULL)
+#include "../Platform/Null/PipelineStateImpl_Null.inl"
 #else
 #error No implementatios of this platform!
 #endif
 
 namespace LimitEngine {
+std::atomic<uint32> PipelineState::sSortIDCounter(0u);
+
 PipelineStateRendererAccessor::PipelineStateRendererAccessor(const PipelineState* state)
     : mImpl(state->mImpl)
 {}
 
 PipelineState::PipelineState()
     : mImpl(nullptr)
+    , mSortID(sSortIDCounter.fetch_add(1u, std::memory_order_relaxed))
 {
 #ifdef USE_DX12
     mImpl = new PipelineStateImpl_DirectX12();
+#elif defined(USE_NULL)
+    mImpl = new PipelineStateImpl_Null();
 #else
 #error No implementation of this platform!
 #endif
@@ -0,0 +1,79 @@
+/*********************************************************************
+Copyright (c) 2020 LIMITGAME
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+----------------------------------------------------------------------
+@file  PipelineStateCache.cpp
+@brief Pipeline states shared by descriptor
+@author minseob (https://github.com/rasidin)
+**********************************************************************/
+#include "Renderer/PipelineStateCache.h"
+
+#include "Core/Timer.h"
+
+namespace LimitEngine {
+Mutex PipelineStateCache::sMutex;
+MapArray<PipelineStateDescriptor, PipelineStateRefPtr> PipelineStateCache::sCache;
+PipelineStateCache::Statistics PipelineStateCache::sStatistics;
+
+PipelineStateRefPtr PipelineStateCache::Get(const PipelineStateDescriptor &Desc)
+{
+    LEASSERT(Desc.Hash);
+    Mutex::ScopedLock scopedLock(sMutex);
+    PipelineStateRefPtr &cached = sCache[Desc];
+    if (cached.IsValid() && cached->IsValid()) {
+        sStatistics.HitCount++;
+        return cached;
+    }
+    // New descriptor, or initialization failed last time (e.g. shaders were not ready)
+    if (!cached.IsValid())
+        cached = new PipelineState();
+    const uint64 beginTime = Timer::GetTimeUSec();
+    cached->Init(Desc);
+    const uint64 creationTime = Timer::GetTimeUSec() - beginTime;
+    sStatistics.MissCount++;
+    sStatistics.CreationTimeUSec += creationTime;
+    sStatistics.LongestCreationTimeUSec = MAX(sStatistics.LongestCreationTimeUSec, creationTime);
+    return cached;
+}
+void PipelineStateCache::Terminate()
+{
+    Mutex::ScopedLock scopedLock(sMutex);
+    for (uint32 index = 0; index < sCache.GetSize(); index++)
+        sCache.GetAt(index).value.Release();
+    sCache.Clear();
+}
+PipelineStateCache::Statistics PipelineStateCache::GetStatistics()
+{
+    Mutex::ScopedLock scopedLock(sMutex);
+    return sStatistics;
+}
+void PipelineStateCache::ResetStatistics()
+{
+    Mutex::ScopedLock scopedLock(sMutex);
+    sStatistics = Statistics();
+}
+uint32 PipelineStateCache::GetCount()
+{
+    Mutex::ScopedLock scopedLock(sMutex);
+    return static_cast<uint32>(sCache.GetSize());
+}
+} // namespace LimitEngine
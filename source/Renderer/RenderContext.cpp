@@ -13,7 +13,7 @@
 #include "Renderer/Texture.h"
 
 namespace LimitEngine {
-	RenderContext* SingletonRenderContext::mInstance = NULL;
+	template<> RenderContext* SingletonRenderContext::mInstance = NULL;
 	RenderContext::RenderContext()
 	{
 		mDefaultTextures.Resize((int)DefaultTextureTypeMax);
@@ -27,17 +27,24 @@ OTHER DEALINGS IN THE SOFTWARE.
 **********************************************************************/
 #include "Renderer/SamplerState.h"
 
+#include "Core/Mutex.h"
+
 #if defined(USE_DX11)
 #include "../Platform/DirectX11/SamplerStateImpl_DirectX11.inl"
 #elif defined(USE_DX12)
 #include "../Platform/DirectX12/SamplerStateImpl_DirectX12.inl"
+#elif defined(USE_NULL)
+#include "../Platform/Null/SamplerStateImpl_Null.inl"
 #else
 #error No implementation for TextureSampler
 #endif
 
 namespace LimitEngine {
+// Samplers are looked up by threads recording draws in parallel
+static Mutex gMutexForSamplerCache;
 VectorArray<SamplerStateRefPtr> SamplerState::sSamplerCache;
 void SamplerState::TerminateCache() {
+    Mutex::ScopedLock scopedLock(gMutexForSamplerCache);
     for (SamplerStateRefPtr &CachedSampler : sSamplerCache) {
         CachedSampler.Release();
     }
@@ -45,6 +52,7 @@ void SamplerState::TerminateCache() {
 }
 
 SamplerState* SamplerState::Get(const SamplerStateDesc &Desc) {
+    Mutex::ScopedLock scopedLock(gMutexForSamplerCache);
     SamplerState *FoundSamplerState = nullptr;
     if (sSamplerCache.count())
     for (SamplerStateRefPtr &CachedSampler : sSamplerCache) {
@@ -69,6 +77,8 @@ SamplerState::SamplerState(const SamplerStateDesc &Desc)
     mImpl = new SamplerStateImpl_DirectX11();
 #elif defined(USE_DX12)
     mImpl = new SamplerStateImpl_DirectX12();
+#elif defined(USE_NULL)
+    mImpl = new SamplerStateImpl_Null();
 #else
 #error No implementation for TextureSampler
 #endif
@@ -36,6 +36,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "../Platform/DirectX11/ShaderImpl_DirectX11.inl"
 #elif defined(USE_DX12)
 #include "../Platform/DirectX12/ShaderImpl_DirectX12.inl"
+#elif defined(USE_NULL)
+#include "../Platform/Null/ShaderImpl_Null.inl"
 #else
 #error No implementation of shader
 #endif
@@ -53,6 +55,8 @@ namespace LimitEngine {
         mImpl = new ShaderImpl_DirectX11();
 #elif defined(USE_DX12)
         mImpl = new ShaderImpl_DirectX12();
+#elif defined(USE_NULL)
+        mImpl = new ShaderImpl_Null();
 #endif
     }
     Shader::~Shader()
@@ -38,6 +38,8 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include "../Platform/DirectX11/TextureImpl_DirectX11.inl"
 #elif defined(USE_DX12)
 #include "../Platform/DirectX12/TextureImpl_DirectX12.inl"
+#elif defined(USE_NULL)
+#include "../Platform/Null/TextureImpl_Null.inl"
 #elif defined (USE_OPENGLES)
 #include "OpenGLES/LE_TextureImpl_OpenGLES.h"
 #else
@@ -363,6 +365,8 @@ Texture::Texture()
     mImpl = new TextureImpl_OpenGLES();
 #elif defined(USE_DX12)
     mImpl = new TextureImpl_DirectX12(this);
+#elif defined(USE_NULL)
+    mImpl = new TextureImpl_Null(this);
 #else
 #error No implementation for texture
 #endif
@@ -455,7 +459,7 @@ bool Texture::Serialize(Archive &OutArchive)
 }
 void Texture::SetDebugName(const char *InDebugName)
 {
-    uint32 CopyLength = min(DebugNameLength - 1, static_cast<uint32>(strlen(InDebugName) + 1));
+    uint32 CopyLength = MIN(DebugNameLength - 1, static_cast<uint32>(strlen(InDebugName) + 1));
     ::memcpy(mDebugName, InDebugName, CopyLength);
     mDebugName[CopyLength - 1] = 0;
 }
@@ -21,6 +21,8 @@
 #include "../Platform/DirectX11/VertexBufferImpl_DirectX11.inl"
 #elif defined(USE_DX12)
 #include "../Platform/DirectX12/VertexBufferImpl_DirectX12.inl"
+#elif defined(USE_NULL)
+#include "../Platform/Null/VertexBufferImpl_Null.inl"
 #else
 #error No implementation for VertexBuffer
 #endif
@@ -46,7 +48,11 @@ const RendererFlag::BufferFormat FVF_FORMATS[FVF_INDEX_MAX] = {
     RendererFlag::BufferFormat::R32G32B32_Float,
     RendererFlag::BufferFormat::R32G32B32_Float,
 };
+const char* INSTANCE_WORLD_NAME = "INSTANCEWORLD";
+std::atomic<uint32> VertexBufferGeneric::sSortIDCounter(0u);
+
 VertexBufferGeneric::VertexBufferGeneric()
+    : mSortID(sSortIDCounter.fetch_add(1u, std::memory_order_relaxed))
 {
 #ifdef USE_OPENGLES
     mImpl = new VertexBufferImpl_OpenGLES();
@@ -56,6 +62,8 @@ VertexBufferGeneric::VertexBufferGeneric()
     mImpl = new VertexBufferImpl_DirectX11();
 #elif defined(USE_DX12)
     mImpl = new VertexBufferImpl_DirectX12();
+#elif defined(USE_NULL)
+    mImpl = new VertexBufferImpl_Null();
 #else
 #error No implementation for VertexBuffer New
 #endif
@@ -67,4 +75,23 @@ VertexBufferGeneric::~VertexBufferGeneric()
         mImpl = nullptr;
     }
 }
+
+void GenerateInstanceInputElementDescriptors(PipelineStateDescriptor& desc)
+{
+    static constexpr uint32 RowCount = 4u;
+    static constexpr uint32 RowSize = sizeof(InstanceVertex::World) / RowCount;
+    static_assert(RowSize == 16u, "Row of instance matrix has to be float4");
+    LEASSERT(desc.InputElementCount + RowCount <= PipelineStateDescriptor::MaxInputElementsNum);
+    for (uint32 rowidx = 0; rowidx < RowCount; rowidx++) {
+        auto &element = desc.InputElementDescriptors[desc.InputElementCount];
+        element.SemanticName = INSTANCE_WORLD_NAME;
+        element.SemanticIndex = rowidx;
+        element.Format = RendererFlag::BufferFormat::R32G32B32A32_Float;
+        element.InputSlot = INSTANCE_VERTEX_SLOT;
+        element.AlignedByteOffset = rowidx * RowSize;
+        element.InputSlotClass = RendererFlag::InputClassification::PerInstanceData;
+        element.InstanceDataStepRate = 1;
+        desc.InputElementCount++;
+    }
+}
 }
\ No newline at end of file
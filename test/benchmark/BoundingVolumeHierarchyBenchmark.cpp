@@ -0,0 +1,181 @@
+// Bounding volume hierarchy benchmark.
+// Builds BoundingVolumeHierarchy (SAH) over 10k and 100k world space boxes scattered around the camera,
+// moves every box a little per frame and refits the tree by Update, and queries the frustum of the camera.
+// Frustum::IsBoxVisible over every box is how visibility was found before the hierarchy and is measured
+// on the same boxes as baseline. Items found by the hierarchy have to match the linear scan, after build
+// and after refits, before anything is timed.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <Core/MemoryAllocator.h>
+#include <Renderer/AABB.h>
+#include <Renderer/BoundingVolumeHierarchy.h>
+#include <Renderer/Frustum.h>
+
+using namespace LimitEngine;
+
+static const uint32 RepeatCount = 20u;
+static const uint32 MoveFrameCount = 60u;
+static const float MoveMeters = 0.5f;           // Per frame
+
+struct Random
+{
+    uint64 state = 0x2545f4914f6cdd1dull;
+    // [0, 1)
+    float operator () ()
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<float>(state >> 40) / static_cast<float>(1u << 24);
+    }
+};
+
+static std::vector<AABB> makeBoxes(Random &InRandom, uint32 Count, float Range)
+{
+    std::vector<AABB> boxes;
+    boxes.reserve(Count);
+    for (uint32 index = 0; index < Count; index++) {
+        const LEMath::FloatVector3 center((InRandom() * 2.0f - 1.0f) * Range, (InRandom() * 2.0f - 1.0f) * Range, (InRandom() * 2.0f - 1.0f) * Range);
+        const LEMath::FloatVector3 extent(0.25f + InRandom() * 2.0f, 0.25f + InRandom() * 2.0f, 0.25f + InRandom() * 2.0f);
+        boxes.push_back(AABB(center - extent, center + extent));
+    }
+    return boxes;
+}
+
+static void moveBoxes(Random &InRandom, std::vector<AABB> &Boxes)
+{
+    for (AABB &box : Boxes) {
+        const LEMath::FloatVector3 offset((InRandom() * 2.0f - 1.0f) * MoveMeters, (InRandom() * 2.0f - 1.0f) * MoveMeters, (InRandom() * 2.0f - 1.0f) * MoveMeters);
+        box = AABB(box.minimum + offset, box.maximum + offset);
+    }
+}
+
+static void queryLinear(const Frustum &InFrustum, const std::vector<AABB> &Boxes, VectorArray<uint32> &OutItems)
+{
+    for (uint32 index = 0; index < Boxes.size(); index++) {
+        if (InFrustum.IsBoxVisible(Boxes[index]))
+            OutItems.Add(index);
+    }
+}
+
+// Boxes within rounding error of a plane may differ between paths (hierarchy skips planes its nodes are inside of)
+static bool isOnPlane(const Frustum &InFrustum, const AABB &Box)
+{
+    const double minimum[3] = { Box.minimum.X(), Box.minimum.Y(), Box.minimum.Z() };
+    const double maximum[3] = { Box.maximum.X(), Box.maximum.Y(), Box.maximum.Z() };
+    for (int planeIndex = 0; planeIndex < Frustum::PlaneCount; planeIndex++) {
+        const LEMath::FloatVector4 plane = InFrustum.GetPlane(static_cast<Frustum::Plane>(planeIndex));
+        const double normal[3] = { plane.X(), plane.Y(), plane.Z() };
+        double distance = plane.W(), radius = 0.0;
+        for (int axis = 0; axis < 3; axis++) {
+            distance += normal[axis] * (minimum[axis] + maximum[axis]) * 0.5;
+            radius += fabs(normal[axis]) * (maximum[axis] - minimum[axis]) * 0.5;
+        }
+        if (fabs(distance + radius) < 1e-4)
+            return true;
+    }
+    return false;
+}
+
+static void checkQuery(const BoundingVolumeHierarchy &InHierarchy, const Frustum &InFrustum, const std::vector<AABB> &Boxes, const char *When)
+{
+    VectorArray<uint32> hierarchyItems, linearItems;
+    InHierarchy.QueryFrustum(InFrustum, hierarchyItems);
+    queryLinear(InFrustum, Boxes, linearItems);
+    std::vector<uint32> found(hierarchyItems.GetData(), hierarchyItems.GetData() + hierarchyItems.count());
+    std::vector<uint32> expected(linearItems.GetData(), linearItems.GetData() + linearItems.count());
+    std::sort(found.begin(), found.end());
+    if (std::adjacent_find(found.begin(), found.end()) != found.end()) {
+        printf("Hierarchy returned an item twice %s\n", When);
+        exit(1);
+    }
+    std::vector<uint32> differences;
+    std::set_symmetric_difference(found.begin(), found.end(), expected.begin(), expected.end(), std::back_inserter(differences));
+    for (uint32 item : differences) {
+        if (isOnPlane(InFrustum, Boxes[item]) == false) {
+            const bool foundByHierarchy = std::binary_search(found.begin(), found.end(), item);
+            printf("Box %u is %s by hierarchy and %s by IsBoxVisible %s\n", item, foundByHierarchy ? "visible" : "culled", foundByHierarchy ? "culled" : "visible", When);
+            exit(1);
+        }
+    }
+}
+
+// Returns us per query. Item counts are summed so queries are not optimized away.
+template<typename F>
+static double measureQuery(F &&Query)
+{
+    VectorArray<uint32> items;
+    uint32 sum = 0u;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32 repeat = 0; repeat < RepeatCount; repeat++) {
+        items.Clear(false);
+        Query(items);
+        sum += items.count();
+    }
+    const double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (sum == 0xffffffffu)
+        printf("%u\n", sum);
+    return elapsed / RepeatCount;
+}
+
+static void runBenchmark(const Frustum &InFrustum, uint32 BoxCount, float Range)
+{
+    Random random;
+    std::vector<AABB> boxes = makeBoxes(random, BoxCount, Range);
+    BoundingVolumeHierarchy hierarchy;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32 repeat = 0; repeat < RepeatCount; repeat++)
+        hierarchy.Build(boxes.data(), BoxCount);
+    const double buildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / RepeatCount;
+    const float builtCost = hierarchy.GetCost();
+    checkQuery(hierarchy, InFrustum, boxes, "after build");
+
+    const double linearTime = measureQuery([&](VectorArray<uint32> &Items) { queryLinear(InFrustum, boxes, Items); });
+    const double builtQueryTime = measureQuery([&](VectorArray<uint32> &Items) { hierarchy.QueryFrustum(InFrustum, Items); });
+    VectorArray<uint32> visibleItems;
+    hierarchy.QueryFrustum(InFrustum, visibleItems);
+
+    // Every object moves every frame, tree is refitted without rebuild
+    double refitTime = 0.0;
+    for (uint32 frame = 0; frame < MoveFrameCount; frame++) {
+        moveBoxes(random, boxes);
+        start = std::chrono::steady_clock::now();
+        for (uint32 index = 0; index < BoxCount; index++) {
+            if (hierarchy.Update(index, boxes[index]) == false) {
+                printf("Update of box %u failed\n", index);
+                exit(1);
+            }
+        }
+        refitTime += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    refitTime /= static_cast<double>(MoveFrameCount) * BoxCount;
+    checkQuery(hierarchy, InFrustum, boxes, "after refits");
+    const double refittedQueryTime = measureQuery([&](VectorArray<uint32> &Items) { hierarchy.QueryFrustum(InFrustum, Items); });
+
+    printf("%6u   %8.2f   %8.1f   %7.1f%%   %11.1f   %8.1f   %9.2f   %10.1f   %11.2fx   %s\n",
+        BoxCount, buildTime, linearTime, visibleItems.count() * 100.0 / BoxCount, builtQueryTime, refittedQueryTime,
+        refitTime, builtCost, hierarchy.GetCost() / builtCost, hierarchy.NeedsRebuild() ? "yes" : "no");
+}
+
+int main()
+{
+    MemoryAllocator::Init();
+    MemoryAllocator::InitWithMemoryPool(256 << 20);
+
+    // Camera at origin looking +z (view is identity), boxes around it up to far clip
+    Frustum frustum;
+    frustum.SetAspectRatio(9.0f / 16.0f);
+    frustum.UpdatePlanes(frustum.GetProjectionMatrix());
+
+    printf("%u runs, build in ms, queries in us, refit in ns per moved box (%u frames of %.1f m moves)\n", RepeatCount, MoveFrameCount, MoveMeters);
+    printf(" boxes      build     linear    visible   BVH (built)   refitted   refit/box   built cost   refit cost   rebuild\n");
+    for (uint32 boxCount : { 10000u, 100000u })
+        runBenchmark(frustum, boxCount, frustum.GetFarMeters());
+
+    MemoryAllocator::Term();
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Frustum culling benchmark.
+// Culls 10k and 100k world space boxes scattered around the camera, 4 at a time by
+// Frustum::CullBoxes (SSE where available) and one at a time by Frustum::IsBoxVisible,
+// which is the reference of CullBoxes and is measured on the same boxes as baseline.
+// Visibility of both paths has to match before anything is timed.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <Core/MemoryAllocator.h>
+#include <Renderer/AABB.h>
+#include <Renderer/Frustum.h>
+
+using namespace LimitEngine;
+
+static const uint32 RepeatCount = 20u;
+
+static std::vector<AABB> makeBoxes(uint32 Count, float Range)
+{
+    std::vector<AABB> boxes;
+    boxes.reserve(Count);
+    uint64 state = 0x2545f4914f6cdd1dull;
+    auto random = [&state]() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<float>(state >> 40) / static_cast<float>(1u << 24);
+    };
+    for (uint32 index = 0; index < Count; index++) {
+        const LEMath::FloatVector3 center((random() * 2.0f - 1.0f) * Range, (random() * 2.0f - 1.0f) * Range, (random() * 2.0f - 1.0f) * Range);
+        const LEMath::FloatVector3 extent(0.25f + random() * 2.0f, 0.25f + random() * 2.0f, 0.25f + random() * 2.0f);
+        boxes.push_back(AABB(center - extent, center + extent));
+    }
+    return boxes;
+}
+
+static void packBoxes(const std::vector<AABB> &Boxes, std::vector<Frustum::BoxBatch> &OutBatches)
+{
+    OutBatches.resize((Boxes.size() + 3u) / 4u);
+    for (uint32 index = 0; index < Boxes.size(); index++)
+        OutBatches[index / 4u].Set(index % 4u, Boxes[index]);
+    for (uint32 index = static_cast<uint32>(Boxes.size()); index < OutBatches.size() * 4u; index++)
+        OutBatches[index / 4u].SetInfinite(index % 4u);
+}
+
+// Distance of box to nearest plane it crosses, boxes within rounding error of a plane may differ between paths
+static bool isOnPlane(const Frustum &InFrustum, const AABB &Box)
+{
+    Frustum::BoxBatch batch;
+    batch.Set(0, Box);
+    for (int planeIndex = 0; planeIndex < Frustum::PlaneCount; planeIndex++) {
+        const LEMath::FloatVector4 plane = InFrustum.GetPlane(static_cast<Frustum::Plane>(planeIndex));
+        const double distance = static_cast<double>(plane.X()) * batch.CenterX[0] + static_cast<double>(plane.Y()) * batch.CenterY[0] + static_cast<double>(plane.Z()) * batch.CenterZ[0] + plane.W();
+        const double radius = fabs(plane.X()) * batch.ExtentX[0] + fabs(plane.Y()) * batch.ExtentY[0] + fabs(plane.Z()) * batch.ExtentZ[0];
+        if (fabs(distance + radius) < 1e-4)
+            return true;
+    }
+    return false;
+}
+
+static void runBenchmark(Frustum &InFrustum, uint32 BoxCount, float Range)
+{
+    const std::vector<AABB> boxes = makeBoxes(BoxCount, Range);
+    std::vector<Frustum::BoxBatch> batches;
+    packBoxes(boxes, batches);
+    std::vector<uint8> masks(batches.size());
+    std::vector<uint8> visibles(BoxCount);
+
+    InFrustum.CullBoxes(batches.data(), static_cast<uint32>(batches.size()), masks.data());
+    uint32 visibleCount = 0u;
+    for (uint32 index = 0; index < BoxCount; index++) {
+        const bool simdVisible = (masks[index / 4u] & (1u << (index % 4u))) != 0u;
+        const bool scalarVisible = InFrustum.IsBoxVisible(boxes[index]);
+        if (simdVisible != scalarVisible && !isOnPlane(InFrustum, boxes[index])) {
+            printf("Box %u is %s by CullBoxes and %s by IsBoxVisible\n", index, simdVisible ? "visible" : "culled", scalarVisible ? "visible" : "culled");
+            exit(1);
+        }
+        visibleCount += scalarVisible ? 1u : 0u;
+    }
+
+    uint32 sum = 0u;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32 repeat = 0; repeat < RepeatCount; repeat++) {
+        for (uint32 index = 0; index < BoxCount; index++)
+            visibles[index] = InFrustum.IsBoxVisible(boxes[index]) ? 1u : 0u;
+        sum += visibles[repeat % BoxCount];
+    }
+    const double scalarTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (static_cast<double>(RepeatCount) * BoxCount);
+
+    start = std::chrono::steady_clock::now();
+    for (uint32 repeat = 0; repeat < RepeatCount; repeat++) {
+        InFrustum.CullBoxes(batches.data(), static_cast<uint32>(batches.size()), masks.data());
+        sum += masks[repeat % masks.size()];
+    }
+    const double cullTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (static_cast<double>(RepeatCount) * BoxCount);
+
+    // Boxes of moving objects have to be packed again every frame
+    start = std::chrono::steady_clock::now();
+    for (uint32 repeat = 0; repeat < RepeatCount; repeat++) {
+        packBoxes(boxes, batches);
+        InFrustum.CullBoxes(batches.data(), static_cast<uint32>(batches.size()), masks.data());
+        sum += masks[repeat % masks.size()];
+    }
+    const double packAndCullTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (static_cast<double>(RepeatCount) * BoxCount);
+    if (sum == 0xffffffffu)
+        printf("%u\n", sum);
+
+    printf("%6u   %7.1f%%   %13.2f   %14.2f   %19.2f\n", BoxCount, visibleCount * 100.0 / BoxCount, scalarTime, cullTime, packAndCullTime);
+}
+
+int main()
+{
+    MemoryAllocator::Init();
+    MemoryAllocator::InitWithMemoryPool(256 << 20);
+
+    // Camera at origin looking +z (view is identity), boxes around it up to far clip
+    Frustum frustum;
+    frustum.SetAspectRatio(9.0f / 16.0f);
+    frustum.UpdatePlanes(frustum.GetProjectionMatrix());
+
+    printf("%u runs, ns per box\n", RepeatCount);
+    printf(" boxes   visible   IsBoxVisible   CullBoxes (4x)   pack + CullBoxes\n");
+    for (uint32 boxCount : { 10000u, 100000u })
+        runBenchmark(frustum, boxCount, frustum.GetFarMeters());
+
+    MemoryAllocator::Term();
+    return 0;
+}
@@ -0,0 +1,162 @@
+// Hash throughput benchmark.
+// Times Hash::Generate on keys of 8 bytes to 64KB, runtime StringID of resource names and
+// PipelineStateDescriptor::ComputeHash (fields fed to HashBuilder).
+// Byte at a time FNV-1 is how Hash::GenerateHash used to hash everything, and the old ComputeHash
+// copied the descriptor into a temporary allocation first. Both are measured on the same data as baseline.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <Core/MemoryAllocator.h>
+#include <Core/StringID.h>
+#include <Renderer/PipelineStateDescriptor.h>
+
+using namespace LimitEngine;
+
+static uint64 fnv1Hash(const void *Data, size_t Size)
+{
+    static constexpr uint64 OffsetBasis = 14695981039346656037ull;
+    static constexpr uint64 Prime = 1099511628211ull;
+    uint64 output = OffsetBasis;
+    const uint8 *data8 = static_cast<const uint8*>(Data);
+    for (size_t index = 0; index < Size; index++)
+        output = (Prime * output) ^ data8[index];
+    return output;
+}
+
+// ComputeHash before HashBuilder : whole descriptor copied into a temporary buffer and hashed by FNV-1
+static uint64 copyAndHashDescriptor(const PipelineStateDescriptor &Desc)
+{
+    const size_t sizeAligned = GetSizeAlign<size_t>(sizeof(PipelineStateDescriptor), 16u);
+    uint8 *source = static_cast<uint8*>(MemoryAllocator::Alloc(sizeAligned));
+    uint8 *sourcePtr = source;
+    ::memset(source, 0, sizeAligned);
+    ::memcpy(sourcePtr, Desc.Shaders, sizeof(Desc.Shaders));
+    sourcePtr += sizeof(Desc.Shaders);
+    ::memcpy(sourcePtr, &Desc.BlendDescriptor, sizeof(Desc.BlendDescriptor));
+    sourcePtr += sizeof(Desc.BlendDescriptor);
+    ::memcpy(sourcePtr, &Desc.RasterizerDescriptor, sizeof(Desc.RasterizerDescriptor));
+    sourcePtr += sizeof(Desc.RasterizerDescriptor);
+    ::memcpy(sourcePtr, &Desc.DepthStencilDescriptor, sizeof(Desc.DepthStencilDescriptor));
+    sourcePtr += sizeof(Desc.DepthStencilDescriptor);
+    ::memcpy(sourcePtr, &Desc.Topology, sizeof(Desc.Topology));
+    sourcePtr += sizeof(Desc.Topology);
+    ::memcpy(sourcePtr, Desc.InputElementDescriptors, sizeof(Desc.InputElementDescriptors));
+    const uint64 output = fnv1Hash(source, sizeAligned);
+    MemoryAllocator::Free(source);
+    return output;
+}
+
+// Runs Function Count times and returns ns per call. Results are summed so the calls are not optimized away.
+template<typename F>
+static double measureNanosecondsPerCall(uint32 Count, F &&Function)
+{
+    uint64 sum = 0u;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32 index = 0; index < Count; index++)
+        sum += Function(index);
+    const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    if (sum == 0xffffffffffffffffull)
+        printf("%llu\n", static_cast<unsigned long long>(sum));
+    return elapsed / Count;
+}
+
+// HashBuilder fed in pieces has to match Hash::Generate of the same bytes, or the numbers below mean nothing
+static void checkHashBuilder(const std::vector<uint8> &Data)
+{
+    for (size_t size : { 0u, 1u, 7u, 16u, 47u, 48u, 49u, 96u, 97u, 1000u, 4096u }) {
+        for (size_t pieceSize : { 1u, 3u, 8u, 48u, 100u }) {
+            HashBuilder builder;
+            for (size_t offset = 0; offset < size; offset += pieceSize)
+                builder.Add(&Data[offset], MIN(pieceSize, size - offset));
+            if (builder.Finalize() != Hash::Generate(Data.data(), size)) {
+                printf("HashBuilder differs from Hash::Generate at %u bytes in pieces of %u\n", static_cast<uint32>(size), static_cast<uint32>(pieceSize));
+                exit(1);
+            }
+        }
+    }
+}
+
+static void runKeySizes(const std::vector<uint8> &Data, uint32 BytesPerSize)
+{
+    printf("key bytes   Generate ns/op    FNV-1 ns/op   Generate GB/s   FNV-1 GB/s\n");
+    for (uint32 size : { 8u, 16u, 32u, 64u, 256u, 4096u, 65536u }) {
+        const uint32 count = MAX(1000u, BytesPerSize / size);
+        // Offset of key moves so short keys are not always read from same cache line
+        const uint32 offsetRange = static_cast<uint32>(Data.size()) - size;
+        const double generateTime = measureNanosecondsPerCall(count, [&](uint32 Index) { return Hash::Generate(&Data[(Index * 64u) % offsetRange], size); });
+        const double fnvTime = measureNanosecondsPerCall(count, [&](uint32 Index) { return fnv1Hash(&Data[(Index * 64u) % offsetRange], size); });
+        printf("%9u   %14.1f   %12.1f   %13.2f   %10.2f\n", size, generateTime, fnvTime, size / generateTime, size / fnvTime);
+    }
+}
+
+static void runStringIDs(uint32 NameCount, uint32 Count)
+{
+    std::vector<String> names;
+    for (uint32 index = 0; index < NameCount; index++) {
+        char name[64];
+        snprintf(name, sizeof(name), "resources/textures/material%u_basecolor.texture.lea", index);
+        names.push_back(String(name));
+    }
+    const double stringIDTime = measureNanosecondsPerCall(Count, [&](uint32 Index) {
+        return StringID(StringID::DynamicName(names[Index % NameCount])).GetHash();
+    });
+    const double fnvTime = measureNanosecondsPerCall(Count, [&](uint32 Index) {
+        const String &name = names[Index % NameCount];
+        return fnv1Hash(name.GetCharPtr(), name.GetLength());
+    });
+    printf("%-25s   %9.1f   %11.1f\n", "StringID of resource name", stringIDTime, fnvTime);
+}
+
+static void runPipelineStateDescriptors(uint32 Count)
+{
+    PipelineStateDescriptor desc;
+    desc.SetDepthEnabled(true);
+    desc.SetDepthFunc(RendererFlag::TestFlags::LEqual);
+    desc.RenderTargetsNum = 1u;
+    desc.RenderTargetFormats[0] = RendererFlag::BufferFormat::R16G16B16A16_Float;
+    for (uint32 index = 0; index < 6u; index++) {
+        desc.InputElementDescriptors[index] = { "TEXCOORD", index, RendererFlag::BufferFormat::R32G32B32A32_Float, 0u, index * 16u, RendererFlag::InputClassification::PerVertexData, 0u };
+    }
+    desc.InputElementCount = 6u;
+    const double builderTime = measureNanosecondsPerCall(Count, [&](uint32 Index) {
+        desc.DepthStencilDescriptor.StencilReadMask = static_cast<uint8>(Index);
+        desc.ComputeHash();
+        return desc.Hash;
+    });
+    const double copyTime = measureNanosecondsPerCall(Count, [&](uint32 Index) {
+        desc.DepthStencilDescriptor.StencilReadMask = static_cast<uint8>(Index);
+        return copyAndHashDescriptor(desc);
+    });
+    printf("%-25s   %9.1f   %11.1f   (copy of %u bytes)\n", "PipelineStateDescriptor", builderTime, copyTime,
+        static_cast<uint32>(GetSizeAlign<size_t>(sizeof(PipelineStateDescriptor), 16u)));
+}
+
+int main(int argc, char **argv)
+{
+    const uint32 bytesPerSize = (argc > 1) ? static_cast<uint32>(atoi(argv[1])) : (256u << 20);
+    const uint32 callCount = (argc > 2) ? static_cast<uint32>(atoi(argv[2])) : 1000000u;
+
+    MemoryAllocator::Init();
+    MemoryAllocator::InitWithMemoryPool(256 << 20);
+
+    std::vector<uint8> data(1u << 20);
+    uint64 state = 0x9e3779b97f4a7c15ull;
+    for (uint8 &value : data) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        value = static_cast<uint8>(state >> 56);
+    }
+    checkHashBuilder(data);
+
+    printf("%u MB hashed per key size\n", bytesPerSize >> 20);
+    runKeySizes(data, bytesPerSize);
+    printf("\n%u calls\n", callCount);
+    printf("path                        new ns/op   FNV-1 ns/op\n");
+    runStringIDs(1000u, callCount);
+    runPipelineStateDescriptors(callCount);
+
+    StringID::TerminateTable();
+    MemoryAllocator::Term();
+    return 0;
+}
@@ -0,0 +1,107 @@
+// MapArray lookup benchmark.
+// Times Find on maps of 10, 1k and 100k entries with integer and String keys.
+// The linear scan over an array of pairs is how MapArray used to find keys and
+// is measured on the same keys as a baseline.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <Core/String.h>
+#include <Containers/MapArray.h>
+
+using namespace LimitEngine;
+
+template<typename KeyType>
+class LinearScanMap
+{
+public:
+    void Add(const KeyType &Key, uint32 Value) { mItems.push_back({ Key, Value }); }
+    uint32* Find(const KeyType &Key)
+    {
+        for (Item &item : mItems) {
+            if (item.Key == Key)
+                return &item.Value;
+        }
+        return nullptr;
+    }
+private:
+    struct Item
+    {
+        KeyType Key;
+        uint32 Value;
+    };
+    std::vector<Item> mItems;
+};
+
+static uint32 makeIntegerKey(uint32 Index) { return Index * 2654435761u; }
+static String makeStringKey(uint32 Index)
+{
+    char key[32];
+    snprintf(key, sizeof(key), "resources/texture%u", Index);
+    return String(key);
+}
+
+// Looks up every key in order, one in four is a key that is not in the map.
+template<typename MapType, typename KeyType>
+static double measureNanosecondsPerFind(MapType &Map, const std::vector<KeyType> &Keys, uint32 LookupCount)
+{
+    uint64 found = 0u;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32 lookup = 0; lookup < LookupCount; lookup++) {
+        if (uint32 *value = Map.Find(Keys[lookup % Keys.size()]))
+            found += *value;
+    }
+    const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    // Keep the result alive so the lookups are not optimized away.
+    if (found == 0xffffffffffffffffull)
+        printf("%llu\n", static_cast<unsigned long long>(found));
+    return elapsed / LookupCount;
+}
+
+template<typename KeyType>
+static void runBenchmark(const char *KeyName, KeyType (*MakeKey)(uint32), uint32 EntryCount, uint32 LookupCount)
+{
+    MapArray<KeyType, uint32> map;
+    LinearScanMap<KeyType> linearMap;
+    std::vector<KeyType> keys;
+    for (uint32 index = 0; index < EntryCount; index++) {
+        const KeyType key = MakeKey(index);
+        map.Add(key, index + 1u);
+        linearMap.Add(key, index + 1u);
+        keys.push_back(key);
+        if (index % 3 == 2)
+            keys.push_back(MakeKey(EntryCount + index));
+    }
+    for (uint32 index = 0; index < EntryCount; index++) {
+        const uint32 *value = map.Find(MakeKey(index));
+        if (value == nullptr || *value != index + 1u) {
+            printf("Lost key %u in %s map\n", index, KeyName);
+            exit(1);
+        }
+    }
+
+    // A linear scan of 100k entries is slow, so it gets fewer lookups for the same work.
+    const uint32 linearLookupCount = MAX(1000u, LookupCount / MAX(1u, EntryCount / 100u));
+    const double hashTime = measureNanosecondsPerFind(map, keys, LookupCount);
+    const double linearTime = measureNanosecondsPerFind(linearMap, keys, linearLookupCount);
+    printf("%-7s %7u   %13.1f   %14.1f\n", KeyName, EntryCount, hashTime, linearTime);
+}
+
+int main(int argc, char **argv)
+{
+    const uint32 lookupCount = (argc > 1) ? static_cast<uint32>(atoi(argv[1])) : 1000000u;
+
+    MemoryAllocator::Init();
+    MemoryAllocator::InitWithMemoryPool(256 << 20);
+
+    printf("%u lookups per map (25%% misses)\n", lookupCount);
+    printf("key     entries   hash ns/find   linear ns/find\n");
+    for (uint32 entryCount : { 10u, 1000u, 100000u }) {
+        runBenchmark<uint32>("uint32", makeIntegerKey, entryCount, lookupCount);
+        runBenchmark<String>("String", makeStringKey, entryCount, lookupCount);
+    }
+
+    MemoryAllocator::Term();
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Memory allocator thread scaling benchmark.
+// 1 to N threads run the same random mix of small (<= 256 bytes) and occasional
+// larger allocations against the shared pool. The pool lock statistics show how
+// much of the traffic the per-thread caches keep away from the lock.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <Core/MemoryAllocator.h>
+
+using namespace LimitEngine;
+
+struct LiveAllocation
+{
+    uint8 *Data;
+    size_t Size;
+};
+
+static void runAllocationMix(uint32 Seed, uint32 Iterations)
+{
+    std::mt19937 random(Seed);
+    std::vector<LiveAllocation> live;
+    live.reserve(2048);
+    for (uint32 iteration = 0; iteration < Iterations; iteration++) {
+        if (live.empty() || random() % 100 < 52) {
+            const size_t size = (random() % 16 == 0) ? random() % 8192 : random() % 256;
+            uint8 *data = static_cast<uint8*>(MemoryAllocator::Alloc(size));
+            if (data == nullptr)
+                continue;
+            memset(data, static_cast<int>(size & 0xff), size);
+            live.push_back({ data, size });
+        }
+        else {
+            const size_t index = random() % live.size();
+            const LiveAllocation allocation = live[index];
+            for (size_t offset = 0; offset < allocation.Size; offset++) {
+                if (allocation.Data[offset] != static_cast<uint8>(allocation.Size & 0xff)) {
+                    printf("Allocation overwritten : %p\n", allocation.Data);
+                    exit(1);
+                }
+            }
+            MemoryAllocator::Free(allocation.Data);
+            live[index] = live.back();
+            live.pop_back();
+        }
+        if (live.size() > 2000) {
+            for (const LiveAllocation &allocation : live)
+                MemoryAllocator::Free(allocation.Data);
+            live.clear();
+        }
+    }
+    for (const LiveAllocation &allocation : live)
+        MemoryAllocator::Free(allocation.Data);
+}
+
+int main(int argc, char **argv)
+{
+    const uint32 iterations = (argc > 1) ? static_cast<uint32>(atoi(argv[1])) : 1000000u;
+    const uint32 maxThreadCount = (argc > 2) ? static_cast<uint32>(atoi(argv[2])) : 8u;
+
+    MemoryAllocator::Init();
+    MemoryAllocator::InitWithMemoryPool(256 << 20);
+
+    printf("%u operations per thread\n", iterations);
+    printf("threads   time ms   Mops/s     locks   contended   cache hits   cache misses\n");
+    for (uint32 threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2) {
+        // Statistics are cumulative, so report the difference for this run.
+        const uint64 lockCount = MemoryAllocator::GetStatLockCount();
+        const uint64 contentionCount = MemoryAllocator::GetStatLockContentionCount();
+        const uint64 hitCount = MemoryAllocator::GetStatThreadCacheHitCount();
+        const uint64 missCount = MemoryAllocator::GetStatThreadCacheMissCount();
+
+        std::vector<std::thread> threads;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32 threadIndex = 0; threadIndex < threadCount; threadIndex++)
+            threads.emplace_back(runAllocationMix, threadIndex + 1, iterations);
+        for (std::thread &thread : threads)
+            thread.join();
+        const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        printf("%7u   %7.1f   %6.2f   %7llu   %9llu   %10llu   %12llu\n",
+            threadCount, elapsed, static_cast<double>(threadCount) * iterations / elapsed / 1000.0,
+            static_cast<unsigned long long>(MemoryAllocator::GetStatLockCount() - lockCount),
+            static_cast<unsigned long long>(MemoryAllocator::GetStatLockContentionCount() - contentionCount),
+            static_cast<unsigned long long>(MemoryAllocator::GetStatThreadCacheHitCount() - hitCount),
+            static_cast<unsigned long long>(MemoryAllocator::GetStatThreadCacheMissCount() - missCount));
+    }
+
+    MemoryAllocator::Term();
+    return 0;
+}
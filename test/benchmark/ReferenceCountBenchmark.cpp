@@ -0,0 +1,101 @@
+// Reference counter contention benchmark.
+// Every thread copies and drops ReferenceCountedPointers to one shared object,
+// which is what render and loader threads do with shared textures and shaders.
+// The mutex counter is the per-object lock the counter used before and is
+// measured on the same loop as a baseline.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Core/ReferenceCountedObject.h>
+#include <Core/ReferenceCountedPointer.h>
+
+using namespace LimitEngine;
+
+class SharedResource : public ReferenceCountedObject<LimitEngineMemoryCategory::Common>
+{
+};
+
+class MutexCountedResource : public IReferenceCountedObject
+{
+public:
+    MutexCountedResource() : mReferenceCounter(0u) {}
+    uint32 GetReferenceCounter() const override { std::lock_guard<std::mutex> lock(mMutex); return mReferenceCounter; }
+    uint32 AddReferenceCounter() override { std::lock_guard<std::mutex> lock(mMutex); return ++mReferenceCounter; }
+    uint32 SubReferenceCounter() override { std::lock_guard<std::mutex> lock(mMutex); return --mReferenceCounter; }
+private:
+    mutable std::mutex mMutex;
+    uint32 mReferenceCounter;
+};
+
+template<typename T>
+static double measureNanosecondsPerReference(T *Resource, uint32 ThreadCount, uint32 Iterations)
+{
+    // Keep one reference alive so no thread ever drops the counter to zero.
+    Resource->AddReferenceCounter();
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32 threadIndex = 0; threadIndex < ThreadCount; threadIndex++) {
+        threads.emplace_back([Resource, Iterations]() {
+            for (uint32 iteration = 0; iteration < Iterations; iteration++) {
+                Resource->AddReferenceCounter();
+                Resource->SubReferenceCounter();
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    if (Resource->GetReferenceCounter() != 1u) {
+        printf("Reference counter mismatch : %u\n", Resource->GetReferenceCounter());
+        exit(1);
+    }
+    Resource->SubReferenceCounter();
+    return elapsed / (static_cast<double>(ThreadCount) * Iterations);
+}
+
+// Pointer copies go through the same counter but also exercise ReferenceCountedPointer itself.
+static double measureNanosecondsPerPointerCopy(uint32 ThreadCount, uint32 Iterations)
+{
+    ReferenceCountedPointer<SharedResource> shared(new SharedResource());
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32 threadIndex = 0; threadIndex < ThreadCount; threadIndex++) {
+        threads.emplace_back([&shared, Iterations]() {
+            for (uint32 iteration = 0; iteration < Iterations; iteration++) {
+                ReferenceCountedPointer<SharedResource> copy(shared);
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return elapsed / (static_cast<double>(ThreadCount) * Iterations);
+}
+
+int main(int argc, char **argv)
+{
+    const uint32 iterations = (argc > 1) ? static_cast<uint32>(atoi(argv[1])) : 1000000u;
+    const uint32 maxThreadCount = (argc > 2) ? static_cast<uint32>(atoi(argv[2])) : 8u;
+
+    MemoryAllocator::Init();
+    MemoryAllocator::InitWithMemoryPool(16 << 20);
+
+    printf("%u add/sub pairs per thread\n", iterations);
+    printf("threads   atomic ns/op   mutex ns/op   pointer copy ns/op\n");
+    for (uint32 threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2) {
+        SharedResource *atomicResource = new SharedResource();
+        MutexCountedResource mutexResource;
+        const double atomicTime = measureNanosecondsPerReference(atomicResource, threadCount, iterations);
+        delete atomicResource;
+        const double mutexTime = measureNanosecondsPerReference(&mutexResource, threadCount, iterations);
+        const double copyTime = measureNanosecondsPerPointerCopy(threadCount, iterations);
+        printf("%7u   %12.1f   %11.1f   %18.1f\n", threadCount, atomicTime, mutexTime, copyTime);
+    }
+
+    MemoryAllocator::Term();
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Renderer task queue stress benchmark on the null backend.
+// Loader threads add renderer tasks while the game thread runs DrawManager.
+// Paced mode waits between adds like streaming loaders do and reports how long
+// each add took. Flood mode adds tasks back to back and reports throughput.
+// Build with NULL_RENDERER (always the case on Linux).
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <InitializeOptions.h>
+#include <Core/Timer.h>
+#include <Managers/DrawManager.h>
+#include <Managers/ShaderManager.h>
+
+using namespace LimitEngine;
+
+static std::atomic<uint64> sExecutedTaskCount(0u);
+
+static void spinMicroseconds(uint64 Microseconds)
+{
+    const uint64 start = Timer::GetTimeUSec();
+    while (Timer::GetTimeUSec() - start < Microseconds) {}
+}
+
+static DrawManager* createDrawManager()
+{
+    DrawManager *drawManager = new DrawManager();
+    InitializeOptions options(LEMath::IntSize(64, 64), InitializeOptions::ColorSpace::sRGB, InitializeOptions::ColorSpace::sRGB);
+    options.FramePacing = FramePacer::Mode::Uncapped;
+    drawManager->Init(nullptr, options);
+    return drawManager;
+}
+
+static void runUntilExecuted(DrawManager *InDrawManager, uint64 TaskCount)
+{
+    while (sExecutedTaskCount.load(std::memory_order_relaxed) < TaskCount)
+        InDrawManager->Run();
+}
+
+static void runPaced(uint32 ProducerCount, uint32 TasksPerProducer, uint32 TaskMicroseconds, uint32 IntervalMicroseconds)
+{
+    DrawManager *drawManager = createDrawManager();
+    sExecutedTaskCount = 0u;
+
+    std::vector<std::vector<uint32>> addTimes(ProducerCount);
+    std::vector<std::thread> producers;
+    for (uint32 producerIndex = 0; producerIndex < ProducerCount; producerIndex++) {
+        producers.emplace_back([&, producerIndex]() {
+            std::vector<uint32> &times = addTimes[producerIndex];
+            times.reserve(TasksPerProducer);
+            for (uint32 taskIndex = 0; taskIndex < TasksPerProducer; taskIndex++) {
+                const uint64 start = Timer::GetTimeUSec();
+                drawManager->AddRendererTaskLambda([TaskMicroseconds]() {
+                    spinMicroseconds(TaskMicroseconds);
+                    sExecutedTaskCount.fetch_add(1u, std::memory_order_relaxed);
+                });
+                times.push_back(static_cast<uint32>(Timer::GetTimeUSec() - start));
+                std::this_thread::sleep_for(std::chrono::microseconds(IntervalMicroseconds));
+            }
+        });
+    }
+    runUntilExecuted(drawManager, static_cast<uint64>(ProducerCount) * TasksPerProducer);
+    for (std::thread &producer : producers)
+        producer.join();
+
+    std::vector<uint32> allTimes;
+    for (const std::vector<uint32> &times : addTimes)
+        allTimes.insert(allTimes.end(), times.begin(), times.end());
+    std::sort(allTimes.begin(), allTimes.end());
+    uint64 blockedTime = 0u;
+    for (uint32 time : allTimes)
+        blockedTime += time;
+    printf("%9u   %6u   %6u   %8u   %6u   %10.1f\n", ProducerCount,
+        allTimes[allTimes.size() / 2], allTimes[allTimes.size() * 99 / 100], allTimes[allTimes.size() * 999 / 1000], allTimes.back(),
+        blockedTime / 1000.0);
+
+    delete drawManager;
+}
+
+static void runFlood(uint32 ProducerCount, uint32 TasksPerProducer)
+{
+    DrawManager *drawManager = createDrawManager();
+    sExecutedTaskCount = 0u;
+
+    std::vector<std::thread> producers;
+    const uint64 start = Timer::GetTimeUSec();
+    for (uint32 producerIndex = 0; producerIndex < ProducerCount; producerIndex++) {
+        producers.emplace_back([drawManager, TasksPerProducer]() {
+            for (uint32 taskIndex = 0; taskIndex < TasksPerProducer; taskIndex++)
+                drawManager->AddRendererTaskLambda([]() { sExecutedTaskCount.fetch_add(1u, std::memory_order_relaxed); });
+        });
+    }
+    const uint64 taskCount = static_cast<uint64>(ProducerCount) * TasksPerProducer;
+    runUntilExecuted(drawManager, taskCount);
+    for (std::thread &producer : producers)
+        producer.join();
+    const uint64 elapsed = Timer::GetTimeUSec() - start;
+    printf("%9u   %8.1f   %8.2f\n", ProducerCount, elapsed / 1000.0, static_cast<double>(taskCount) / elapsed);
+
+    delete drawManager;
+}
+
+int main(int argc, char **argv)
+{
+    const bool flood = argc > 1 && strcmp(argv[1], "flood") == 0;
+    const uint32 maxProducerCount = (argc > 2) ? static_cast<uint32>(atoi(argv[2])) : 64u;
+
+    MemoryAllocator::Init();
+    MemoryAllocator::InitWithMemoryPool(256 << 20);
+    // DrawManager::Init gets shaders of 2D drawing
+    ShaderManager *shaderManager = new ShaderManager();
+    shaderManager->Init();
+
+    if (flood) {
+        const uint32 tasksPerProducer = (argc > 3) ? static_cast<uint32>(atoi(argv[3])) : 100000u;
+        printf("%u tasks per producer, added back to back\n", tasksPerProducer);
+        printf("producers    time ms   M tasks/s\n");
+        for (uint32 producerCount = 1; producerCount <= maxProducerCount; producerCount *= 4)
+            runFlood(producerCount, tasksPerProducer);
+    }
+    else {
+        const uint32 tasksPerProducer = (argc > 3) ? static_cast<uint32>(atoi(argv[3])) : 1000u;
+        const uint32 taskMicroseconds = (argc > 4) ? static_cast<uint32>(atoi(argv[4])) : 5u;
+        const uint32 intervalMicroseconds = (argc > 5) ? static_cast<uint32>(atoi(argv[5])) : 200u;
+        printf("%u tasks per producer, %u us between adds, %u us per task\n", tasksPerProducer, intervalMicroseconds, taskMicroseconds);
+        printf("producers   p50 us   p99 us   p99.9 us   max us   blocked ms\n");
+        for (uint32 producerCount = 4; producerCount <= maxProducerCount; producerCount *= 4)
+            runPaced(producerCount, tasksPerProducer, taskMicroseconds, intervalMicroseconds);
+    }
+
+    delete shaderManager;
+    MemoryAllocator::Term();
+    return 0;
+}
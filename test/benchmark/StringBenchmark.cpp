@@ -0,0 +1,423 @@
+// String benchmark.
+// Times ResourceManager::GetConvertedPath on tagged resource paths and TextParser::Parse on
+// resources/models/sphere.model.text, the two workloads that build Strings a character or a token at a time.
+// OldString is a copy of String before short strings were stored inline : strlen for every length,
+// allocation of a new buffer for every append. GetConvertedPath and Parse written with it are measured on the
+// same input as baseline (current Parse also interns node names by StringID, baseline does not).
+// Results of both have to match before anything is timed.
+// Usage : StringBenchmark [model text (resources/models/sphere.model.text)] [parses (20)] [path conversions (200000)]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <Core/MemoryAllocator.h>
+#include <Core/String.h>
+#include <Core/TextParser.h>
+#include <Managers/ResourceManager.h>
+
+using namespace LimitEngine;
+
+class OldString : public Object<LimitEngineMemoryCategory::Common>
+{
+public:
+    OldString(const char *str = nullptr) : mBuffer(nullptr)
+    {
+        if (str) {
+            const size_t length = ::strlen(str);
+            mBuffer = static_cast<char*>(malloc(length + 1));
+            ::memcpy(mBuffer, str, length + 1);
+        }
+    }
+    OldString(const OldString &str) : mBuffer(nullptr)
+    {
+        const size_t length = str.GetLength();
+        if (length) {
+            mBuffer = static_cast<char*>(malloc(length + 1));
+            ::memcpy(mBuffer, str.mBuffer, length + 1);
+        }
+    }
+    ~OldString() { Release(); }
+
+    void operator = (const OldString &str)
+    {
+        if (this == &str)
+            return;
+        Release();
+        if (str.IsEmpty())
+            return;
+        const size_t length = str.GetLength();
+        mBuffer = static_cast<char*>(malloc(length + 1));
+        ::memcpy(mBuffer, str.mBuffer, length + 1);
+    }
+    void operator = (const char *str)
+    {
+        Release();
+        if (!str || !::strlen(str))
+            return;
+        const size_t length = ::strlen(str);
+        mBuffer = static_cast<char*>(malloc(length + 1));
+        ::memcpy(mBuffer, str, length + 1);
+    }
+    void operator += (const OldString &str) { *this += str.GetCharPtr() ? str.GetCharPtr() : ""; }
+    void operator += (const char *str)
+    {
+        const size_t thisLength = GetLength();
+        const size_t tarLength = ::strlen(str);
+        char *dstBuf = static_cast<char*>(malloc(thisLength + tarLength + 1));
+        ::memcpy(dstBuf, mBuffer, thisLength);
+        ::memcpy(&dstBuf[thisLength], str, tarLength + 1);
+        free(mBuffer);
+        mBuffer = dstBuf;
+    }
+    void operator += (char c)
+    {
+        const size_t thisLength = GetLength();
+        char *dstBuf = static_cast<char*>(malloc(thisLength + 2));
+        ::memset(dstBuf, 0, thisLength + 2);
+        ::memcpy(dstBuf, mBuffer, thisLength);
+        dstBuf[thisLength] = c;
+        free(mBuffer);
+        mBuffer = dstBuf;
+    }
+
+    bool        IsEmpty() const         { return (!mBuffer || ::strlen(mBuffer) == 0); }
+    size_t      GetLength() const       { return mBuffer ? ::strlen(mBuffer) : 0u; }
+    const char* GetCharPtr() const      { return mBuffer; }
+    char*       GetCopiedCharPtr() const
+    {
+        if (!GetLength()) return nullptr;
+        char *output = static_cast<char*>(malloc(GetLength() + 1));
+        ::memcpy(output, mBuffer, GetLength() + 1);
+        return output;
+    }
+    void        Release()               { if (mBuffer) free(mBuffer); mBuffer = nullptr; }
+
+private:
+    char *mBuffer;
+};
+
+// Path tags were looked up by linear scan (MapArray before hashing) with String keys
+struct OldPathTag
+{
+    OldString key;
+    OldString value;
+};
+
+static char* getConvertedPathOld(const OldString &RootPath, const std::vector<OldPathTag> &PathTable, const char *filename)
+{
+    OldString convertedPath = RootPath;
+    size_t length = ::strlen(filename);
+    OldString convertWord;
+    bool inTag = false;
+    if (!RootPath.IsEmpty()) convertedPath += "/";
+    for (size_t i = 0; i < length; i++) {
+        if (filename[i] == '<') {
+            inTag = true;
+            continue;
+        }
+        else if (filename[i] == '>') {
+            inTag = false;
+            for (const OldPathTag &tag : PathTable) {
+                if (convertWord.GetCharPtr() && ::strcmp(tag.key.GetCharPtr(), convertWord.GetCharPtr()) == 0) {
+                    convertedPath += tag.value;
+                    convertedPath += "/";
+                    break;
+                }
+            }
+            convertWord = "";
+            continue;
+        }
+        else if (inTag) {
+            convertWord += filename[i];
+        }
+        else {
+            convertedPath += filename[i];
+        }
+    }
+    return convertedPath.GetCopiedCharPtr();
+}
+
+// TextParser::Parse with NODE made of OldString
+class OldTextParser
+{
+public:
+    struct NODE
+    {
+        OldString                   name;
+        NODE                       *parent = nullptr;
+        SmallVectorArray<OldString, 4> values;
+        SmallVectorArray<NODE*, 4>  children;
+        ~NODE()
+        {
+            for (uint32 i = 0; i < children.count(); i++)
+                delete children[i];
+        }
+    };
+
+    ~OldTextParser()
+    {
+        for (uint32 i = 0; i < mNodes.count(); i++)
+            delete mNodes[i];
+    }
+
+    void Parse(const char *text)
+    {
+        char buf[256];
+        uint32 word_length = 0;
+        const char *ptr = text;
+        char currentWord = *(ptr++);
+        NODE *currentNode = nullptr;
+        NODE *parentNode = nullptr;
+        bool sequenceIn = false;
+        bool comment = false;
+        while (currentWord) {
+            if (currentWord < 0x21) {
+                if (!comment) {
+                    if (word_length) {
+                        buf[word_length] = 0;
+                        inputData(parentNode, &currentNode, buf, word_length, sequenceIn);
+                    }
+                    if (*ptr == '\r') ptr++;
+                    if (*ptr == '\n') ptr++;
+                }
+                else if (currentWord == '\r') {
+                    if (*ptr == '\n') ptr++;
+                    comment = false;
+                }
+                else if (currentWord == '\n') {
+                    comment = false;
+                }
+                word_length = 0;
+            }
+            else if (!comment) {
+                switch (currentWord) {
+                case '{':
+                    if (currentNode == nullptr)
+                        addNewNode(parentNode, nullptr, &currentNode);
+                    parentNode = currentNode;
+                    currentNode = nullptr;
+                    break;
+                case '}':
+                    parentNode = parentNode->parent;
+                    buf[word_length] = 0;
+                    inputData(parentNode, &currentNode, buf, word_length, sequenceIn);
+                    word_length = 0;
+                    break;
+                case '[':
+                    sequenceIn = true;
+                    buf[word_length] = 0;
+                    inputData(parentNode, &currentNode, buf, word_length, sequenceIn);
+                    word_length = 0;
+                    break;
+                case ']':
+                    if (word_length) {
+                        buf[word_length] = 0;
+                        inputData(parentNode, &currentNode, buf, word_length, sequenceIn);
+                        word_length = 0;
+                    }
+                    sequenceIn = false;
+                    currentNode = nullptr;
+                    break;
+                case '#':
+                    comment = true;
+                    break;
+                default:
+                    buf[word_length++] = currentWord;
+                    break;
+                }
+            }
+            currentWord = *(ptr++);
+        }
+    }
+
+    const VectorArray<NODE*>& GetNodes() const { return mNodes; }
+
+private:
+    void addNewNode(NODE *Parent, const char *NodeName, NODE **OutNode)
+    {
+        *OutNode = new NODE();
+        (*OutNode)->name = NodeName;
+        (*OutNode)->parent = Parent;
+        if (Parent) Parent->children.Add(*OutNode);
+        else mNodes.Add(*OutNode);
+    }
+    void inputData(NODE *parent, NODE **node, char *buf, uint32 length, bool sequenceIn)
+    {
+        if (length) {
+            if (*node) {
+                (*node)->values.Add(buf);
+                if (!sequenceIn) *node = nullptr;
+            }
+            else {
+                *node = new NODE();
+                (*node)->name = buf;
+                (*node)->parent = parent;
+                if (parent) parent->children.Add(*node);
+                else mNodes.Add(*node);
+            }
+        }
+    }
+
+    VectorArray<NODE*> mNodes;
+};
+
+static bool isSameText(const char *A, const char *B)
+{
+    return ::strcmp(A ? A : "", B ? B : "") == 0;
+}
+
+static bool isSameNode(const TextParser::NODE *Node, const OldTextParser::NODE *OldNode)
+{
+    if (!isSameText(Node->name.GetCharPtr(), OldNode->name.GetCharPtr()) || Node->values.count() != OldNode->values.count() || Node->children.count() != OldNode->children.count())
+        return false;
+    for (uint32 index = 0; index < Node->values.count(); index++) {
+        if (!isSameText(Node->values[index].GetCharPtr(), OldNode->values[index].GetCharPtr()))
+            return false;
+    }
+    for (uint32 index = 0; index < Node->children.count(); index++) {
+        if (!isSameNode(Node->children[index], OldNode->children[index]))
+            return false;
+    }
+    return true;
+}
+
+static std::vector<char> loadText(const char *FilePath)
+{
+    std::vector<char> text;
+    if (FILE *fp = fopen(FilePath, "rb")) {
+        fseek(fp, 0, SEEK_END);
+        text.resize(static_cast<size_t>(ftell(fp)) + 1u, 0);
+        fseek(fp, 0, SEEK_SET);
+        if (fread(text.data(), 1, text.size() - 1u, fp) != text.size() - 1u)
+            text.clear();
+        fclose(fp);
+    }
+    return text;
+}
+
+static void runPaths(uint32 Count)
+{
+    static const char* const Tags[][2] = {
+        { "models", "models" },
+        { "textures", "textures" },
+        { "shaders", "shaders/compiled" },
+    };
+    static const char* const Paths[] = {
+        "<models>sphere.model.lea",
+        "<textures>brick.texture.lea",
+        "<textures>environments/overcast_soil_puresky_4k.texture.lea",
+        "<shaders>Standard_BasePass_instanced_VS",
+        "<models>",
+        "resources.lea",
+    };
+    static const uint32 PathCount = sizeof(Paths) / sizeof(Paths[0]);
+    static const char RootPath[] = "resources";
+
+    ResourceManager::SetRootPath(RootPath);
+    std::vector<OldPathTag> oldPathTable;
+    for (const auto &tag : Tags) {
+        ResourceManager::SetPathTag(tag[0], tag[1]);
+        oldPathTable.push_back({ OldString(tag[0]), OldString(tag[1]) });
+    }
+    const OldString oldRootPath(RootPath);
+    for (const char *path : Paths) {
+        char *converted = ResourceManager::GetConvertedPath(path);
+        char *oldConverted = getConvertedPathOld(oldRootPath, oldPathTable, path);
+        if (!isSameText(converted, oldConverted)) {
+            printf("%s is converted to %s, was %s\n", path, converted, oldConverted);
+            exit(1);
+        }
+        MemoryAllocator::Free(converted);
+        MemoryAllocator::Free(oldConverted);
+    }
+
+    uint64 sum = 0u;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32 index = 0; index < Count; index++) {
+        char *converted = getConvertedPathOld(oldRootPath, oldPathTable, Paths[index % PathCount]);
+        sum += static_cast<uint8>(converted[index % 8u]);
+        MemoryAllocator::Free(converted);
+    }
+    const double oldTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / Count;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32 index = 0; index < Count; index++) {
+        char *converted = ResourceManager::GetConvertedPath(Paths[index % PathCount]);
+        sum += static_cast<uint8>(converted[index % 8u]);
+        MemoryAllocator::Free(converted);
+    }
+    const double newTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / Count;
+    if (sum == 0xffffffffffffffffull)
+        printf("%llu\n", static_cast<unsigned long long>(sum));
+
+    printf("%-16s   %10.1f ns   %10.1f ns\n", "GetConvertedPath", oldTime, newTime);
+}
+
+static void runParser(const char *Text, uint32 Count)
+{
+    {
+        TextParser parser(Text);
+        OldTextParser oldParser;
+        oldParser.Parse(Text);
+        const VectorArray<OldTextParser::NODE*> &oldNodes = oldParser.GetNodes();
+        for (uint32 nodeIndex = 0; nodeIndex < oldNodes.count(); nodeIndex++) {
+            const OldTextParser::NODE *oldNode = oldNodes[nodeIndex];
+            TextParser::NODE *node = parser.GetNode(StringID(oldNode->name.GetCharPtr() ? oldNode->name.GetCharPtr() : ""));
+            if (node == nullptr || !isSameNode(node, oldNode)) {
+                printf("Node %u (%s) differs from baseline parser\n", nodeIndex, oldNode->name.GetCharPtr());
+                exit(1);
+            }
+        }
+    }
+
+    // Parse and release, parsed nodes are released after each load too
+    uint64 sum = 0u;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32 index = 0; index < Count; index++) {
+        OldTextParser oldParser;
+        oldParser.Parse(Text);
+        sum += oldParser.GetNodes().count();
+    }
+    const double oldTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / Count;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32 index = 0; index < Count; index++) {
+        TextParser parser(Text);
+        sum += parser.GetNode(StringID("DATA")) ? 1u : 0u;
+    }
+    const double newTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / Count;
+    if (sum == 0xffffffffffffffffull)
+        printf("%llu\n", static_cast<unsigned long long>(sum));
+
+    printf("%-16s   %10.2f ms   %10.2f ms\n", "TextParser", oldTime, newTime);
+}
+
+int main(int argc, char **argv)
+{
+    const char *modelPath = (argc > 1) ? argv[1] : "resources/models/sphere.model.text";
+    const uint32 parseCount = (argc > 2) ? static_cast<uint32>(atoi(argv[2])) : 20u;
+    const uint32 pathCount = (argc > 3) ? static_cast<uint32>(atoi(argv[3])) : 200000u;
+
+    MemoryAllocator::Init();
+    MemoryAllocator::InitWithMemoryPool(256 << 20);
+
+    const std::vector<char> text = loadText(modelPath);
+    if (text.empty()) {
+        printf("Failed to load %s\n", modelPath);
+        exit(1);
+    }
+
+    printf("%u path conversions, %u parses of %s (%u bytes)\n", pathCount, parseCount, modelPath, static_cast<uint32>(text.size() - 1u));
+    // Root path and path tags are static and cleared with ResourceManager, before memory pool is gone
+    ResourceManager *resourceManager = new ResourceManager();
+    printf("path               old String   new String\n");
+    runPaths(pathCount);
+    runParser(text.data(), parseCount);
+    delete resourceManager;
+
+    StringID::TerminateTable();
+    MemoryAllocator::Term();
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Headless run of LimitEngine on the null renderer.
+// Loads a model from resources, places a grid of instances in front of a camera and lets
+// the engine tasks draw frames without window or GPU. Prints frame statistics and what
+// the null backend was asked to do. Fails when no frame was drawn or when the instances
+// were not batched into instanced draws.
+// Usage : LimitEngineHeadless [resource root (resources)] [frames (120)] [grid size (8)] [model (models/sphere.model.lea)]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include <LimitEngine.h>
+#include <Core/MemoryAllocator.h>
+#include <Factories/ArchiveFactory.h>
+#include <Factories/ModelFactory.h>
+#include <Managers/DrawManager.h>
+#include <Renderer/DrawList.h>
+#include <Renderer/CinemaCamera.h>
+#include <Renderer/Model.h>
+#include <Renderer/NullBackend.h>
+#include <Renderer/Transform.h>
+
+static constexpr size_t TotalMemory = 256 << 20; // 256 MiB
+static constexpr uint32 TimeoutSeconds = 30u;
+
+static void setupScene(LimitEngine::LimitEngine *Engine, LimitEngine::Model *InModel, uint32 GridSize)
+{
+    LimitEngine::CinemaCamera *camera = new LimitEngine::CinemaCamera();
+    camera->SetFocalLength(30.0f * 18.0f / 16.0f);
+    camera->SetPosition(LEMath::FloatVector3(0.0f, 0.0f, -2.85f));
+    camera->SetDirection(LEMath::FloatVector3(0.0f, 0.0f, 1.0f));
+    camera->SetShutterSpeed(1.0f / 8.0f);
+    camera->SetFStop(1.0f / 4.0f);
+    camera->SetExposureOffset(-7.0f);
+    Engine->SetMainCamera(camera);
+
+    const float spacing = 2.0f / GridSize;
+    for (uint32 y = 0; y < GridSize; y++) {
+        for (uint32 x = 0; x < GridSize; x++) {
+            const uint32 instanceID = Engine->AddModel(InModel);
+            Engine->UpdateModelTransform(
+                instanceID,
+                LimitEngine::Transform(
+                    LEMath::FloatVector4((x + 0.5f) * spacing - 1.0f, (y + 0.5f) * spacing - 1.0f, 0.0f, 0.0f),
+                    LEMath::FloatVector4::Zero,
+                    LEMath::FloatVector4(spacing * 0.4f, spacing * 0.4f, spacing * 0.4f, 0.0f)));
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *resourceRoot = (argc > 1) ? argv[1] : "resources";
+    const uint32 frameCount = (argc > 2) ? static_cast<uint32>(atoi(argv[2])) : 120u;
+    const uint32 gridSize = (argc > 3) ? static_cast<uint32>(atoi(argv[3])) : 8u;
+    const char *modelPath = (argc > 4) ? argv[4] : "models/sphere.model.lea";
+    // Archives (.lea) are loaded by ArchiveFactory, sources (.text, .xml) by ModelFactory
+    const size_t modelPathLength = strlen(modelPath);
+    const bool isArchive = modelPathLength > 4u && strcmp(modelPath + modelPathLength - 4u, ".lea") == 0;
+
+    LimitEngine::MemoryAllocator::Init();
+    LimitEngine::MemoryAllocator::InitWithMemoryPool(TotalMemory);
+
+    LimitEngine::LimitEngine *engine = new LimitEngine::LimitEngine();
+    engine->SetResourceRootPath(resourceRoot);
+
+    LimitEngine::InitializeOptions options(LEMath::IntSize(1280, 720), LimitEngine::InitializeOptions::ColorSpace::Linear, LimitEngine::InitializeOptions::ColorSpace::sRGB);
+    options.FramePacing = LimitEngine::FramePacer::Mode::Uncapped;
+    engine->Init(nullptr, options);
+
+    int result = EXIT_SUCCESS;
+    LimitEngine::ReferenceCountedPointer<LimitEngine::Model> model = engine->LoadModel(modelPath, isArchive ? LimitEngine::ArchiveFactory::ID : LimitEngine::ModelFactory::ID, false);
+    if (model.IsValid()) {
+        model->InitResource();
+        setupScene(engine, model.Get(), gridSize);
+
+        // Engine tasks draw frames on their own thread, game thread only waits here
+        LimitEngine::DrawManager &drawManager = LimitEngine::DrawManager::GetSingleton();
+        drawManager.ResetFrameStatistics();
+        LimitEngine::NullBackend::ResetStatistics();
+        const auto start = std::chrono::steady_clock::now();
+        const auto timeout = start + std::chrono::seconds(TimeoutSeconds);
+        while (drawManager.GetFrameStatistics().CompletedFrames < frameCount && std::chrono::steady_clock::now() < timeout)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        const LimitEngine::DrawManager::FrameStatistics frameStatistics = drawManager.GetFrameStatistics();
+        const LimitEngine::NullBackend::Statistics backendStatistics = LimitEngine::NullBackend::GetStatistics();
+        const uint64 frames = frameStatistics.CompletedFrames ? frameStatistics.CompletedFrames : 1u;
+        printf("Model           : %s\n", modelPath);
+        printf("Instances       : %u\n", gridSize * gridSize);
+        printf("Frames          : %llu (%.2f ms/frame)\n", static_cast<unsigned long long>(frameStatistics.CompletedFrames), elapsedMs / frames);
+        printf("Flush           : %.3f ms/frame\n", frameStatistics.TotalFlushUSec / 1000.0 / frames);
+        printf("Draw calls      : %llu/frame\n", static_cast<unsigned long long>(backendStatistics.DrawCalls / frames));
+        printf("Drawn instances : %llu/frame\n", static_cast<unsigned long long>(backendStatistics.DrawnInstances / frames));
+        printf("Commands        : %llu/frame\n", static_cast<unsigned long long>(backendStatistics.Commands / frames));
+        printf("State changes   : %llu/frame\n", static_cast<unsigned long long>(backendStatistics.StateChanges / frames));
+        printf("Uploaded        : %llu bytes/frame\n", static_cast<unsigned long long>(backendStatistics.UploadedBytes / frames));
+        printf("Presents        : %llu\n", static_cast<unsigned long long>(backendStatistics.Presents));
+
+        if (frameStatistics.CompletedFrames < frameCount) {
+            fprintf(stderr, "Only %llu of %u frames were drawn in %u seconds\n", static_cast<unsigned long long>(frameStatistics.CompletedFrames), frameCount, TimeoutSeconds);
+            result = EXIT_FAILURE;
+        }
+        else if (backendStatistics.DrawCalls == 0u || backendStatistics.Presents == 0u) {
+            fprintf(stderr, "Frames were drawn without draw calls or presents\n");
+            result = EXIT_FAILURE;
+        }
+        else if (gridSize * gridSize >= LimitEngine::DrawList::MinInstancesPerDraw && backendStatistics.DrawCalls / frames >= gridSize * gridSize) {
+            // Materials without instanced vertex shader fall back to one draw per instance
+            fprintf(stderr, "Instances of %s were not drawn by instanced draws\n", modelPath);
+            result = EXIT_FAILURE;
+        }
+    }
+    else {
+        fprintf(stderr, "Failed to load %s from %s\n", modelPath, resourceRoot);
+        result = EXIT_FAILURE;
+    }
+    model = nullptr;
+
+    engine->Term();
+    delete engine;
+
+    LimitEngine::MemoryAllocator::Term();
+    return result;
+}